@@ -0,0 +1,829 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <config.h>
+
+#include <string.h>
+
+#include <gami-channel-cache.h>
+#include <gami-event.h>
+
+/**
+ * SECTION: libgami-channel-cache
+ * @short_description: Local copy of the active channels
+ * @title: GamiChannelCache
+ * @stability: Unstable
+ *
+ * #GamiChannelCache is seeded once using the CoreShowChannels action and then
+ * kept current from Newchannel, Newstate, Rename, Hangup and Bridge events,
+ * so that applications do not need to poll
+ * gami_manager_core_show_channels().
+ *
+ * Channels are represented by a #GHashTable with the headers Channel,
+ * Uniqueid, ChannelState, ChannelStateDesc, CallerIDNum, CallerIDName,
+ * AccountCode, Context, Exten, BridgedChannel and BridgedUniqueid (as far as
+ * known), and can be looked up both by unique ID and channel name.
+ *
+ * The manager must be logged in with a mask which includes
+ * %GAMI_EVENT_MASK_CALL for the cache to receive updates.
+ */
+
+enum {
+    PROP_0,
+    PROP_MANAGER
+};
+
+enum {
+    CHANNEL_ADDED,
+    CHANNEL_CHANGED,
+    CHANNEL_REMOVED,
+    LAST_SIGNAL
+};
+
+/* state of channels which changed while a refresh was in progress */
+enum {
+    REFRESH_CREATED = 1,
+    REFRESH_HUNGUP
+};
+
+struct _GamiChannelCachePrivate {
+    GamiManager *ami;
+
+    GHashTable  *by_uniqueid;   /* Uniqueid -> channel */
+    GHashTable  *by_name;       /* Channel -> channel (not referenced) */
+
+    guint        refreshing;
+    GHashTable  *refresh_changes;
+
+    GSList      *handlers;
+};
+
+static guint signals [LAST_SIGNAL] = { 0 };
+
+/* map CoreShowChannel headers to the headers used in events */
+static const struct {
+    const gchar *list_header;
+    const gchar *header;
+} channel_headers [] = {
+    { "Channel",          "Channel" },
+    { "UniqueID",         "Uniqueid" },
+    { "Context",          "Context" },
+    { "Extension",        "Exten" },
+    { "Priority",         "Priority" },
+    { "ChannelState",     "ChannelState" },
+    { "ChannelStateDesc", "ChannelStateDesc" },
+    { "Application",      "Application" },
+    { "ApplicationData",  "ApplicationData" },
+    { "CallerIDnum",      "CallerIDNum" },
+    { "CallerIDname",     "CallerIDName" },
+    { "AccountCode",      "AccountCode" },
+    { "BridgedChannel",   "BridgedChannel" },
+    { "BridgedUniqueID",  "BridgedUniqueid" },
+    { NULL, NULL }
+};
+
+#define GAMI_CHANNEL_CACHE_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), \
+                                           GAMI_TYPE_CHANNEL_CACHE, \
+                                           GamiChannelCachePrivate))
+
+G_DEFINE_TYPE (GamiChannelCache, gami_channel_cache, G_TYPE_OBJECT);
+
+static void
+set_header (GHashTable *channel, const gchar *header, const gchar *value)
+{
+    if (value)
+        g_hash_table_insert (channel, g_strdup (header), g_strdup (value));
+    else
+        g_hash_table_remove (channel, header);
+}
+
+static GHashTable *
+add_channel (GamiChannelCache *cache,
+             const gchar *uniqueid,
+             const gchar *name)
+{
+    GHashTable *channel;
+
+    channel = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    set_header (channel, "Uniqueid", uniqueid);
+    set_header (channel, "Channel", name);
+
+    g_hash_table_insert (cache->priv->by_uniqueid, g_strdup (uniqueid),
+                         channel);
+    if (name)
+        g_hash_table_insert (cache->priv->by_name, g_strdup (name), channel);
+
+    return channel;
+}
+
+static void
+remove_channel (GamiChannelCache *cache, const gchar *uniqueid)
+{
+    GHashTable  *channel;
+    const gchar *name;
+
+    channel = g_hash_table_lookup (cache->priv->by_uniqueid, uniqueid);
+    if (! channel)
+        return;
+
+    g_hash_table_ref (channel);
+
+    name = g_hash_table_lookup (channel, "Channel");
+    if (name && g_hash_table_lookup (cache->priv->by_name, name) == channel)
+        g_hash_table_remove (cache->priv->by_name, name);
+    g_hash_table_remove (cache->priv->by_uniqueid, uniqueid);
+
+    g_signal_emit (cache, signals [CHANNEL_REMOVED], 0, channel);
+    g_hash_table_unref (channel);
+}
+
+static void
+remember_refresh_change (GamiChannelCache *cache,
+                         const gchar *uniqueid,
+                         gint change)
+{
+    if (! cache->priv->refreshing)
+        return;
+
+    g_hash_table_insert (cache->priv->refresh_changes,
+                         g_strdup (uniqueid),
+                         GINT_TO_POINTER (change));
+}
+
+static void
+on_newchannel (GamiManager *ami, GamiEvent *event, GamiChannelCache *cache)
+{
+    GamiNewchannelEvent *ev = GAMI_NEWCHANNEL_EVENT (event);
+    GHashTable          *channel;
+
+    if (! ev->uniqueid)
+        return;
+
+    remember_refresh_change (cache, ev->uniqueid, REFRESH_CREATED);
+
+    /* a previous channel with the same ID is stale */
+    remove_channel (cache, ev->uniqueid);
+
+    channel = add_channel (cache, ev->uniqueid, ev->channel);
+    set_header (channel, "ChannelState",
+                g_hash_table_lookup (event->headers, "ChannelState"));
+    set_header (channel, "ChannelStateDesc", ev->channel_state_desc);
+    set_header (channel, "CallerIDNum", ev->caller_id_num);
+    set_header (channel, "CallerIDName", ev->caller_id_name);
+    set_header (channel, "AccountCode", ev->account_code);
+    set_header (channel, "Context", ev->context);
+    set_header (channel, "Exten", ev->exten);
+
+    g_signal_emit (cache, signals [CHANNEL_ADDED], 0, channel);
+}
+
+static void
+on_newstate (GamiManager *ami, GamiEvent *event, GamiChannelCache *cache)
+{
+    GamiNewstateEvent *ev = GAMI_NEWSTATE_EVENT (event);
+    GHashTable        *channel;
+    gboolean           added = FALSE;
+
+    if (! ev->uniqueid)
+        return;
+
+    channel = g_hash_table_lookup (cache->priv->by_uniqueid, ev->uniqueid);
+    if (! channel) {
+        /* we missed the Newchannel event */
+        remember_refresh_change (cache, ev->uniqueid, REFRESH_CREATED);
+        channel = add_channel (cache, ev->uniqueid, ev->channel);
+        added = TRUE;
+    }
+
+    set_header (channel, "ChannelState",
+                g_hash_table_lookup (event->headers, "ChannelState"));
+    set_header (channel, "ChannelStateDesc", ev->channel_state_desc);
+    if (ev->caller_id_num)
+        set_header (channel, "CallerIDNum", ev->caller_id_num);
+    if (ev->caller_id_name)
+        set_header (channel, "CallerIDName", ev->caller_id_name);
+
+    g_signal_emit (cache, signals [added ? CHANNEL_ADDED : CHANNEL_CHANGED], 0,
+                   channel);
+}
+
+static void
+on_rename (GamiManager *ami, GamiEvent *event, GamiChannelCache *cache)
+{
+    GamiRenameEvent *ev = GAMI_RENAME_EVENT (event);
+    GHashTable      *channel;
+    const gchar     *old_name;
+
+    if (! ev->uniqueid || ! ev->new_name)
+        return;
+
+    channel = g_hash_table_lookup (cache->priv->by_uniqueid, ev->uniqueid);
+    if (! channel)
+        return;
+
+    old_name = g_hash_table_lookup (channel, "Channel");
+    if (old_name
+        && g_hash_table_lookup (cache->priv->by_name, old_name) == channel)
+        g_hash_table_remove (cache->priv->by_name, old_name);
+
+    set_header (channel, "Channel", ev->new_name);
+    g_hash_table_insert (cache->priv->by_name, g_strdup (ev->new_name),
+                         channel);
+
+    g_signal_emit (cache, signals [CHANNEL_CHANGED], 0, channel);
+}
+
+static void
+on_hangup (GamiManager *ami, GamiEvent *event, GamiChannelCache *cache)
+{
+    GamiHangupEvent *ev = GAMI_HANGUP_EVENT (event);
+
+    if (! ev->uniqueid)
+        return;
+
+    remember_refresh_change (cache, ev->uniqueid, REFRESH_HUNGUP);
+    remove_channel (cache, ev->uniqueid);
+}
+
+static void
+set_bridge (GamiChannelCache *cache,
+            const gchar *uniqueid,
+            const gchar *peer_name,
+            const gchar *peer_uniqueid)
+{
+    GHashTable *channel;
+
+    if (! uniqueid)
+        return;
+
+    channel = g_hash_table_lookup (cache->priv->by_uniqueid, uniqueid);
+    if (! channel)
+        return;
+
+    set_header (channel, "BridgedChannel", peer_name);
+    set_header (channel, "BridgedUniqueid", peer_uniqueid);
+
+    g_signal_emit (cache, signals [CHANNEL_CHANGED], 0, channel);
+}
+
+static void
+on_bridge (GamiManager *ami, GamiEvent *event, GamiChannelCache *cache)
+{
+    GamiBridgeEvent *ev = GAMI_BRIDGE_EVENT (event);
+    gboolean         link;
+
+    link = ev->bridge_state && ! strcmp (ev->bridge_state, "Link");
+
+    set_bridge (cache, ev->uniqueid1,
+                link ? ev->channel2 : NULL, link ? ev->uniqueid2 : NULL);
+    set_bridge (cache, ev->uniqueid2,
+                link ? ev->channel1 : NULL, link ? ev->uniqueid1 : NULL);
+}
+
+static void
+on_disconnected (GamiManager *ami, GamiChannelCache *cache)
+{
+    GList *uniqueids, *l;
+
+    uniqueids = g_hash_table_get_keys (cache->priv->by_uniqueid);
+    for (l = uniqueids; l; l = l->next) {
+        gchar *uniqueid = g_strdup (l->data);
+
+        remove_channel (cache, uniqueid);
+        g_free (uniqueid);
+    }
+    g_list_free (uniqueids);
+}
+
+/* correct the fields of a cached channel from its CoreShowChannel entry;
+ * returns whether anything changed */
+static gboolean
+update_channel (GamiChannelCache *cache, GHashTable *channel, GHashTable *entry)
+{
+    gboolean changed = FALSE;
+    gint     i;
+
+    for (i = 0; channel_headers [i].list_header; i++) {
+        const gchar *header = channel_headers [i].header;
+        const gchar *value, *old;
+
+        /* headers which are not listed are left alone, empty ones clear
+         * the field (like BridgedChannel of a channel no longer bridged) */
+        if (! g_hash_table_lookup_extended (entry,
+                                            channel_headers [i].list_header,
+                                            NULL,
+                                            (gpointer *) &value))
+            continue;
+        if (value && ! *value)
+            value = NULL;
+
+        old = g_hash_table_lookup (channel, header);
+        if (! g_strcmp0 (old, value))
+            continue;
+
+        if (! strcmp (header, "Channel")) {
+            if (! value)
+                continue;
+
+            if (old
+                && g_hash_table_lookup (cache->priv->by_name, old) == channel)
+                g_hash_table_remove (cache->priv->by_name, old);
+            g_hash_table_insert (cache->priv->by_name, g_strdup (value),
+                                 channel);
+        }
+
+        set_header (channel, header, value);
+        changed = TRUE;
+    }
+
+    return changed;
+}
+
+/* merge the result of CoreShowChannels into the cache */
+static void
+merge_channels (GamiChannelCache *cache, GSList *list)
+{
+    GHashTable *listed;
+    GList      *uniqueids, *l;
+    GSList     *entry;
+
+    listed = g_hash_table_new (g_str_hash, g_str_equal);
+
+    for (entry = list; entry; entry = entry->next) {
+        GHashTable  *channel;
+        const gchar *uniqueid;
+        gint         i;
+
+        uniqueid = g_hash_table_lookup (entry->data, "UniqueID");
+        if (! uniqueid)
+            continue;
+
+        g_hash_table_insert (listed, (gpointer) uniqueid, entry->data);
+
+        /* events received during the refresh are more recent */
+        if (g_hash_table_lookup (cache->priv->refresh_changes, uniqueid))
+            continue;
+
+        channel = g_hash_table_lookup (cache->priv->by_uniqueid, uniqueid);
+        if (channel) {
+            if (update_channel (cache, channel, entry->data))
+                g_signal_emit (cache, signals [CHANNEL_CHANGED], 0, channel);
+            continue;
+        }
+
+        channel = add_channel (cache,
+                               uniqueid,
+                               g_hash_table_lookup (entry->data, "Channel"));
+        for (i = 0; channel_headers [i].list_header; i++) {
+            const gchar *value;
+
+            value = g_hash_table_lookup (entry->data,
+                                         channel_headers [i].list_header);
+            if (value && *value)
+                set_header (channel, channel_headers [i].header, value);
+        }
+
+        g_signal_emit (cache, signals [CHANNEL_ADDED], 0, channel);
+    }
+
+    /* drop channels whose hangup we missed */
+    uniqueids = g_hash_table_get_keys (cache->priv->by_uniqueid);
+    for (l = uniqueids; l; l = l->next) {
+        gchar *uniqueid = l->data;
+
+        if (g_hash_table_lookup (listed, uniqueid)
+            || g_hash_table_lookup (cache->priv->refresh_changes, uniqueid))
+            continue;
+
+        uniqueid = g_strdup (uniqueid);
+        remove_channel (cache, uniqueid);
+        g_free (uniqueid);
+    }
+    g_list_free (uniqueids);
+
+    g_hash_table_unref (listed);
+}
+
+static void
+refresh_cb (GamiManager *ami, GAsyncResult *result, gpointer user_data)
+{
+    GSimpleAsyncResult *simple = user_data;
+    GamiChannelCache   *cache;
+    GSList             *list;
+    GError             *error = NULL;
+
+    cache = GAMI_CHANNEL_CACHE (g_async_result_get_source_object
+                                (G_ASYNC_RESULT (simple)));
+
+    list = gami_manager_core_show_channels_finish (ami, result, &error);
+    if (error) {
+        g_simple_async_result_set_from_error (simple, error);
+        g_error_free (error);
+    } else
+        merge_channels (cache, list);
+
+    if (--cache->priv->refreshing == 0)
+        g_hash_table_remove_all (cache->priv->refresh_changes);
+
+    g_simple_async_result_set_op_res_gboolean (simple, error == NULL);
+    g_simple_async_result_complete (simple);
+
+    g_object_unref (simple);
+    g_object_unref (cache);
+}
+
+static void
+store_result (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    *(GAsyncResult **) user_data = g_object_ref (result);
+}
+
+static void
+connect_event (GamiChannelCache *cache, const gchar *signal, GCallback func)
+{
+    gulong id;
+
+    id = g_signal_connect (cache->priv->ami, signal, func, cache);
+    cache->priv->handlers = g_slist_prepend (cache->priv->handlers,
+                                             GSIZE_TO_POINTER (id));
+}
+
+/**
+ * gami_channel_cache_new:
+ * @ami: a #GamiManager
+ *
+ * Create a new channel cache for the server @ami is connected to. The cache
+ * is updated from events immediately, but will only include channels created
+ * before its creation after gami_channel_cache_refresh() has been called.
+ *
+ * Returns: a new #GamiChannelCache
+ */
+GamiChannelCache *
+gami_channel_cache_new (GamiManager *ami)
+{
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), NULL);
+
+    return g_object_new (GAMI_TYPE_CHANNEL_CACHE, "manager", ami, NULL);
+}
+
+/**
+ * gami_channel_cache_refresh:
+ * @cache: #GamiChannelCache
+ * @error: a #GError, or %NULL
+ *
+ * Seed @cache with the channels currently active on the server, and remove
+ * channels which are no longer active.
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_channel_cache_refresh (GamiChannelCache *cache, GError **error)
+{
+    GAsyncResult *result = NULL;
+    gboolean      success;
+
+    gami_channel_cache_refresh_async (cache, store_result, &result);
+
+    while (! result)
+        g_main_context_iteration (NULL, TRUE);
+
+    success = gami_channel_cache_refresh_finish (cache, result, error);
+    g_object_unref (result);
+
+    return success;
+}
+
+/**
+ * gami_channel_cache_refresh_async:
+ * @cache: #GamiChannelCache
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Asynchronously seed @cache with the channels currently active on the
+ * server, see gami_channel_cache_refresh().
+ */
+void
+gami_channel_cache_refresh_async (GamiChannelCache *cache,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_if_fail (GAMI_IS_CHANNEL_CACHE (cache));
+
+    simple = g_simple_async_result_new (G_OBJECT (cache),
+                                        callback,
+                                        user_data,
+                                        gami_channel_cache_refresh_async);
+
+    cache->priv->refreshing++;
+    gami_manager_core_show_channels_async (cache->priv->ami,
+                                           NULL,
+                                           (GAsyncReadyCallback) refresh_cb,
+                                           simple);
+}
+
+/**
+ * gami_channel_cache_refresh_finish:
+ * @cache: #GamiChannelCache
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous operation started with
+ * gami_channel_cache_refresh_async()
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_channel_cache_refresh_finish (GamiChannelCache *cache,
+                                   GAsyncResult *result,
+                                   GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_CHANNEL_CACHE (cache), FALSE);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+
+    g_warn_if_fail (g_simple_async_result_get_source_tag (simple)
+                    == gami_channel_cache_refresh_async);
+
+    if (g_simple_async_result_propagate_error (simple, error))
+        return FALSE;
+
+    return g_simple_async_result_get_op_res_gboolean (simple);
+}
+
+/**
+ * gami_channel_cache_lookup:
+ * @cache: #GamiChannelCache
+ * @uniqueid: the unique ID of a channel
+ *
+ * Look up a channel by its unique ID. The returned table is owned by @cache
+ * and must not be modified; use g_hash_table_ref() to keep it after the
+ * channel has been removed.
+ *
+ * Returns: the channel (stored as #GHashTable), or %NULL
+ */
+GHashTable *
+gami_channel_cache_lookup (GamiChannelCache *cache, const gchar *uniqueid)
+{
+    g_return_val_if_fail (GAMI_IS_CHANNEL_CACHE (cache), NULL);
+    g_return_val_if_fail (uniqueid != NULL, NULL);
+
+    return g_hash_table_lookup (cache->priv->by_uniqueid, uniqueid);
+}
+
+/**
+ * gami_channel_cache_lookup_by_name:
+ * @cache: #GamiChannelCache
+ * @channel: the name of a channel
+ *
+ * Look up a channel by its name, see gami_channel_cache_lookup().
+ *
+ * Returns: the channel (stored as #GHashTable), or %NULL
+ */
+GHashTable *
+gami_channel_cache_lookup_by_name (GamiChannelCache *cache,
+                                   const gchar *channel)
+{
+    g_return_val_if_fail (GAMI_IS_CHANNEL_CACHE (cache), NULL);
+    g_return_val_if_fail (channel != NULL, NULL);
+
+    return g_hash_table_lookup (cache->priv->by_name, channel);
+}
+
+/**
+ * gami_channel_cache_get_channels:
+ * @cache: #GamiChannelCache
+ *
+ * Get all channels in @cache. The list must be freed with g_list_free(), the
+ * channels are owned by @cache.
+ *
+ * Returns: #GList of active channels (stored as #GHashTable)
+ */
+GList *
+gami_channel_cache_get_channels (GamiChannelCache *cache)
+{
+    g_return_val_if_fail (GAMI_IS_CHANNEL_CACHE (cache), NULL);
+
+    return g_hash_table_get_values (cache->priv->by_uniqueid);
+}
+
+/**
+ * gami_channel_cache_get_size:
+ * @cache: #GamiChannelCache
+ *
+ * Get the number of channels in @cache.
+ *
+ * Returns: the number of active channels
+ */
+guint
+gami_channel_cache_get_size (GamiChannelCache *cache)
+{
+    g_return_val_if_fail (GAMI_IS_CHANNEL_CACHE (cache), 0);
+
+    return g_hash_table_size (cache->priv->by_uniqueid);
+}
+
+static void
+gami_channel_cache_init (GamiChannelCache *cache)
+{
+    cache->priv = GAMI_CHANNEL_CACHE_GET_PRIVATE (cache);
+
+    cache->priv->by_uniqueid =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free, (GDestroyNotify) g_hash_table_unref);
+    cache->priv->by_name = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                  g_free, NULL);
+    cache->priv->refresh_changes = g_hash_table_new_full (g_str_hash,
+                                                          g_str_equal,
+                                                          g_free, NULL);
+}
+
+static void
+gami_channel_cache_constructed (GObject *object)
+{
+    GamiChannelCache *cache = GAMI_CHANNEL_CACHE (object);
+
+    connect_event (cache, "typed-event::Newchannel",
+                   G_CALLBACK (on_newchannel));
+    connect_event (cache, "typed-event::Newstate", G_CALLBACK (on_newstate));
+    connect_event (cache, "typed-event::Rename", G_CALLBACK (on_rename));
+    connect_event (cache, "typed-event::Hangup", G_CALLBACK (on_hangup));
+    connect_event (cache, "typed-event::Bridge", G_CALLBACK (on_bridge));
+    connect_event (cache, "disconnected", G_CALLBACK (on_disconnected));
+
+    if (G_OBJECT_CLASS (gami_channel_cache_parent_class)->constructed)
+        G_OBJECT_CLASS (gami_channel_cache_parent_class)->constructed (object);
+}
+
+static void
+gami_channel_cache_dispose (GObject *object)
+{
+    GamiChannelCache *cache = GAMI_CHANNEL_CACHE (object);
+    GSList           *handler;
+
+    if (cache->priv->ami) {
+        for (handler = cache->priv->handlers; handler; handler = handler->next)
+            g_signal_handler_disconnect (cache->priv->ami,
+                                         GPOINTER_TO_SIZE (handler->data));
+        g_slist_free (cache->priv->handlers);
+        cache->priv->handlers = NULL;
+
+        g_object_unref (cache->priv->ami);
+        cache->priv->ami = NULL;
+    }
+
+    G_OBJECT_CLASS (gami_channel_cache_parent_class)->dispose (object);
+}
+
+static void
+gami_channel_cache_finalize (GObject *object)
+{
+    GamiChannelCache *cache = GAMI_CHANNEL_CACHE (object);
+
+    g_hash_table_unref (cache->priv->by_name);
+    g_hash_table_unref (cache->priv->by_uniqueid);
+    g_hash_table_unref (cache->priv->refresh_changes);
+
+    G_OBJECT_CLASS (gami_channel_cache_parent_class)->finalize (object);
+}
+
+static void
+gami_channel_cache_set_property (GObject *object,
+                                 guint prop_id,
+                                 const GValue *value,
+                                 GParamSpec *pspec)
+{
+    GamiChannelCache *cache = GAMI_CHANNEL_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            cache->priv->ami = g_value_dup_object (value);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_channel_cache_get_property (GObject *object,
+                                 guint prop_id,
+                                 GValue *value,
+                                 GParamSpec *pspec)
+{
+    GamiChannelCache *cache = GAMI_CHANNEL_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            g_value_set_object (value, cache->priv->ami);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_channel_cache_class_init (GamiChannelCacheClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (klass, sizeof (GamiChannelCachePrivate));
+
+    object_class->set_property = gami_channel_cache_set_property;
+    object_class->get_property = gami_channel_cache_get_property;
+    object_class->constructed  = gami_channel_cache_constructed;
+    object_class->dispose      = gami_channel_cache_dispose;
+    object_class->finalize     = gami_channel_cache_finalize;
+
+    /**
+     * GamiChannelCache:manager:
+     *
+     * The #GamiManager the cache receives events from
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_MANAGER,
+                                     g_param_spec_object ("manager",
+                                                          "Manager",
+                                                          "The manager the "
+                                                          "cache is attached "
+                                                          "to",
+                                                          GAMI_TYPE_MANAGER,
+                                                          G_PARAM_CONSTRUCT_ONLY
+                                                          | G_PARAM_READWRITE));
+
+    /**
+     * GamiChannelCache::channel-added:
+     * @cache: The #GamiChannelCache that received the signal
+     * @channel: The channel (stored as #GHashTable)
+     *
+     * The ::channel-added signal is emitted when a channel is added to the
+     * cache
+     */
+    signals [CHANNEL_ADDED] = g_signal_new ("channel-added",
+                                            G_TYPE_FROM_CLASS (object_class),
+                                            G_SIGNAL_RUN_LAST,
+                                            0,
+                                            NULL,
+                                            NULL,
+                                            g_cclosure_marshal_VOID__BOXED,
+                                            G_TYPE_NONE,
+                                            1, G_TYPE_HASH_TABLE);
+
+    /**
+     * GamiChannelCache::channel-changed:
+     * @cache: The #GamiChannelCache that received the signal
+     * @channel: The channel (stored as #GHashTable)
+     *
+     * The ::channel-changed signal is emitted when the state, name or bridge
+     * of a channel in the cache changed
+     */
+    signals [CHANNEL_CHANGED] = g_signal_new ("channel-changed",
+                                              G_TYPE_FROM_CLASS (object_class),
+                                              G_SIGNAL_RUN_LAST,
+                                              0,
+                                              NULL,
+                                              NULL,
+                                              g_cclosure_marshal_VOID__BOXED,
+                                              G_TYPE_NONE,
+                                              1, G_TYPE_HASH_TABLE);
+
+    /**
+     * GamiChannelCache::channel-removed:
+     * @cache: The #GamiChannelCache that received the signal
+     * @channel: The channel (stored as #GHashTable)
+     *
+     * The ::channel-removed signal is emitted when a channel has been hung
+     * up and is removed from the cache
+     */
+    signals [CHANNEL_REMOVED] = g_signal_new ("channel-removed",
+                                              G_TYPE_FROM_CLASS (object_class),
+                                              G_SIGNAL_RUN_LAST,
+                                              0,
+                                              NULL,
+                                              NULL,
+                                              g_cclosure_marshal_VOID__BOXED,
+                                              G_TYPE_NONE,
+                                              1, G_TYPE_HASH_TABLE);
+}
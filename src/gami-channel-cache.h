@@ -0,0 +1,154 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)
+#  error "Only <gami.h> can be included directly."
+#endif
+
+#ifndef __GAMI_CHANNEL_CACHE_H__
+#define __GAMI_CHANNEL_CACHE_H__
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#ifdef GAMI_COMPILATION
+#  include <gami-manager.h>
+#else
+#  include <gami/gami-manager.h>
+#endif
+
+G_BEGIN_DECLS
+
+/**
+ * GAMI_TYPE_CHANNEL_CACHE:
+ *
+ * Get the #GType of #GamiChannelCache
+ *
+ * Returns: The #GType of #GamiChannelCache
+ */
+#define GAMI_TYPE_CHANNEL_CACHE  (gami_channel_cache_get_type ())
+/**
+ * GAMI_CHANNEL_CACHE:
+ * @object: Object which is subject to casting
+ *
+ * Cast a #GamiChannelCache derived pointer into a (GamiChannelCache *) pointer
+ */
+#define GAMI_CHANNEL_CACHE(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), \
+									GAMI_TYPE_CHANNEL_CACHE, \
+									GamiChannelCache))
+/**
+ * GAMI_CHANNEL_CACHE_CLASS:
+ * @klass: a valid #GamiChannelCacheClass
+ *
+ * Cast a derived #GamiChannelCacheClass structure into a
+ * #GamiChannelCacheClass structure
+ */
+#define GAMI_CHANNEL_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), \
+									GAMI_TYPE_CHANNEL_CACHE, \
+									GamiChannelCacheClass))
+/**
+ * GAMI_IS_CHANNEL_CACHE:
+ * @object: Instance to check for being a %GAMI_TYPE_CHANNEL_CACHE
+ *
+ * Check whether a valid #GTypeInstance pointer is of type
+ * %GAMI_TYPE_CHANNEL_CACHE
+ *
+ * Returns: %FALSE or %TRUE, indicating whether @object is a
+ *          %GAMI_TYPE_CHANNEL_CACHE
+ */
+#define GAMI_IS_CHANNEL_CACHE(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), \
+									GAMI_TYPE_CHANNEL_CACHE))
+/**
+ * GAMI_IS_CHANNEL_CACHE_CLASS:
+ * @klass: a #GamiChannelCacheClass
+ *
+ * Check whether @klass is a #GamiChannelCacheClass
+ *
+ * Returns: %FALSE or %TRUE
+ */
+#define GAMI_IS_CHANNEL_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), \
+									GAMI_TYPE_CHANNEL_CACHE))
+/**
+ * GAMI_CHANNEL_CACHE_GET_CLASS:
+ * @object: a #GamiChannelCache instance
+ *
+ * Get the class structure associated to a #GamiChannelCache instance.
+ *
+ * Returns: pointer to object class structure
+ */
+#define GAMI_CHANNEL_CACHE_GET_CLASS(object) (G_TYPE_INSTANCE_GET_CLASS ((object), \
+									GAMI_TYPE_CHANNEL_CACHE, \
+									GamiChannelCacheClass))
+
+/**
+ * GamiChannelCache:
+ * @parent_instance: #GObject parent instance
+ *
+ * #GamiChannelCache keeps a local copy of the channels active on the server
+ * of a #GamiManager.
+ */
+typedef struct _GamiChannelCache GamiChannelCache;
+
+typedef struct _GamiChannelCachePrivate GamiChannelCachePrivate;
+
+/**
+ * GamiChannelCacheClass:
+ * @parent_class: #GamiChannelCache's parent class (of type #GObjectClass)
+ *
+ * The class structure for the #GamiChannelCache type
+ */
+typedef struct _GamiChannelCacheClass GamiChannelCacheClass;
+
+struct _GamiChannelCache
+{
+	GObject parent_instance;
+	GamiChannelCachePrivate *priv;
+};
+
+struct _GamiChannelCacheClass
+{
+	GObjectClass parent_class;
+};
+
+GType gami_channel_cache_get_type (void) G_GNUC_CONST;
+
+GamiChannelCache *gami_channel_cache_new (GamiManager *ami);
+
+gboolean gami_channel_cache_refresh (GamiChannelCache *cache,
+									 GError **error);
+void gami_channel_cache_refresh_async (GamiChannelCache *cache,
+									   GAsyncReadyCallback callback,
+									   gpointer user_data);
+gboolean gami_channel_cache_refresh_finish (GamiChannelCache *cache,
+											GAsyncResult *result,
+											GError **error);
+
+GHashTable *gami_channel_cache_lookup (GamiChannelCache *cache,
+									   const gchar *uniqueid);
+GHashTable *gami_channel_cache_lookup_by_name (GamiChannelCache *cache,
+											   const gchar *channel);
+GList *gami_channel_cache_get_channels (GamiChannelCache *cache);
+guint gami_channel_cache_get_size (GamiChannelCache *cache);
+
+G_END_DECLS
+
+#endif /* __GAMI_CHANNEL_CACHE_H__ */
@@ -0,0 +1,13 @@
+#ifndef __GAMI_CONFIG_PRIVATE_H__
+#define __GAMI_CONFIG_PRIVATE_H__
+
+#include <glib.h>
+#include <gami-config.h>
+
+G_BEGIN_DECLS
+
+GamiConfig *gami_config_new_from_packet (const gchar *raw);
+
+G_END_DECLS
+
+#endif /* __GAMI_CONFIG_PRIVATE_H__ */
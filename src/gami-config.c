@@ -0,0 +1,1072 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gami-config.h>
+#include <gami-config-private.h>
+
+/**
+ * SECTION: libgami-config
+ * @short_description: Parsed configuration files
+ * @title: GamiConfig
+ * @stability: Unstable
+ *
+ * #GamiConfig represents a configuration file as retrieved with
+ * gami_manager_get_config_tree() or gami_manager_get_config_json_tree(): an
+ * ordered list of categories, each holding its key/value lines in file
+ * order. Categories are indexed by name and lines by key, so that values can
+ * be looked up without walking the file.
+ *
+ * A category name or a key may appear more than once in a file (e.g. "allow"
+ * in sip.conf); lookups return the first occurrence.
+ *
+ * gami_config_diff() compares two configurations and returns the
+ * #GamiConfigChange<!-- -->s turning one into the other, so that a desired
+ * state can be applied with gami_manager_update_config() without rewriting
+ * the whole file.
+ */
+
+struct _GamiConfig {
+    GPtrArray     *categories;
+    GHashTable    *index;
+    GStringChunk  *strings;
+    volatile gint  ref_count;
+};
+
+struct _GamiConfigCategory {
+    GamiConfig  *config;
+    const gchar *name;
+    GArray      *lines;
+    GHashTable  *index;
+};
+
+static void
+category_free (GamiConfigCategory *category)
+{
+    g_array_free (category->lines, TRUE);
+    g_hash_table_destroy (category->index);
+    g_slice_free (GamiConfigCategory, category);
+}
+
+/* append a category, name being owned by the string chunk of config */
+static GamiConfigCategory *
+append_category (GamiConfig *config, const gchar *name)
+{
+    GamiConfigCategory *category;
+
+    category = g_slice_new (GamiConfigCategory);
+    category->config = config;
+    category->name = name;
+    category->lines = g_array_new (FALSE, FALSE, sizeof (GamiConfigLine));
+    category->index = g_hash_table_new (g_str_hash, g_str_equal);
+
+    g_ptr_array_add (config->categories, category);
+    if (! g_hash_table_lookup (config->index, name))
+        g_hash_table_insert (config->index, (gpointer) name, category);
+
+    return category;
+}
+
+/* append a line, key and value being owned by the string chunk of the
+ * config; the index stores positions + 1, so that a failed lookup reads as
+ * unset */
+static void
+append_line (GamiConfigCategory *category,
+             const gchar *key,
+             const gchar *value)
+{
+    GamiConfigLine line;
+
+    line.key = key;
+    line.value = value;
+    g_array_append_val (category->lines, line);
+
+    if (! g_hash_table_lookup (category->index, key))
+        g_hash_table_insert (category->index, (gpointer) key,
+                             GUINT_TO_POINTER (category->lines->len));
+}
+
+static gpointer
+config_copy (gpointer boxed)
+{
+    return gami_config_ref (boxed);
+}
+
+static void
+config_free (gpointer boxed)
+{
+    gami_config_unref (boxed);
+}
+
+GType
+gami_config_get_type (void)
+{
+    static GType type_id = 0;
+    if (! type_id)
+        type_id = g_boxed_type_register_static (g_intern_static_string
+                                                ("GamiConfig"),
+                                                config_copy,
+                                                config_free);
+    return type_id;
+}
+
+/**
+ * gami_config_new:
+ *
+ * Create an empty configuration, e.g. to describe the desired state of a
+ * configuration file.
+ *
+ * Returns: a new #GamiConfig
+ */
+GamiConfig *
+gami_config_new (void)
+{
+    GamiConfig *config;
+
+    config = g_new (GamiConfig, 1);
+    config->categories = g_ptr_array_new ();
+    config->index = g_hash_table_new (g_str_hash, g_str_equal);
+    config->strings = g_string_chunk_new (4096);
+    config->ref_count = 1;
+
+    return config;
+}
+
+/* parse the unsigned number at *p, moving *p behind it */
+static gboolean
+parse_index (const gchar **p, guint *index)
+{
+    gchar *end;
+
+    *index = (guint) strtoul (*p, &end, 10);
+    if (end == *p)
+        return FALSE;
+
+    *p = end;
+    return TRUE;
+}
+
+/*
+ * Build a configuration from the raw text of a GetConfig response, in a
+ * single pass over its lines:
+ *
+ *   Category-000000: general
+ *   Line-000000-000000: context=default
+ */
+GamiConfig *
+gami_config_new_from_packet (const gchar *raw)
+{
+    GamiConfig  *config;
+    GPtrArray   *by_number;
+    const gchar *line, *end;
+
+    g_return_val_if_fail (raw != NULL, NULL);
+
+    config = gami_config_new ();
+    by_number = g_ptr_array_new ();
+
+    for (line = raw; *line; line = *end ? end + 1 : end) {
+        const gchar *p, *value;
+        guint        n_category, n_line;
+        gsize        len;
+
+        end = strchr (line, '\n');
+        if (! end)
+            end = line + strlen (line);
+        len = end - line;
+        if (len && line [len - 1] == '\r')
+            len--;
+
+        if (! strncmp (line, "Category-", 9)) {
+            p = line + 9;
+            if (! parse_index (&p, &n_category) || strncmp (p, ": ", 2))
+                continue;
+
+            if (n_category >= by_number->len)
+                g_ptr_array_set_size (by_number, n_category + 1);
+
+            value = g_string_chunk_insert_len (config->strings,
+                                               p + 2,
+                                               len - (p + 2 - line));
+            g_ptr_array_index (by_number, n_category) =
+                append_category (config, value);
+        } else if (! strncmp (line, "Line-", 5)) {
+            GamiConfigCategory *category;
+            const gchar        *equal;
+            gchar              *text;
+
+            p = line + 5;
+            if (! parse_index (&p, &n_category) || *p++ != '-'
+                || ! parse_index (&p, &n_line) || strncmp (p, ": ", 2))
+                continue;
+
+            if (n_category >= by_number->len
+                || ! (category = g_ptr_array_index (by_number, n_category)))
+                continue;
+
+            p += 2;
+            equal = memchr (p, '=', line + len - p);
+            if (! equal)
+                continue;
+
+            text = g_string_chunk_insert_len (config->strings,
+                                              p,
+                                              line + len - p);
+            text [equal - p] = '\0';
+            append_line (category, text, text + (equal - p) + 1);
+        }
+    }
+
+    g_ptr_array_free (by_number, TRUE);
+
+    return config;
+}
+
+static void
+skip_space (const gchar **p)
+{
+    while (g_ascii_isspace (**p))
+        (*p)++;
+}
+
+/* parse a JSON string at *p into out, moving *p behind it */
+static gboolean
+parse_json_string (const gchar **p, GString *out)
+{
+    const gchar *s = *p;
+
+    if (*s++ != '"')
+        return FALSE;
+
+    g_string_truncate (out, 0);
+
+    while (*s != '"') {
+        if (! *s)
+            return FALSE;
+
+        if (*s != '\\') {
+            g_string_append_c (out, *s++);
+            continue;
+        }
+
+        switch (*++s) {
+            case 'b':
+                g_string_append_c (out, '\b');
+                break;
+            case 'f':
+                g_string_append_c (out, '\f');
+                break;
+            case 'n':
+                g_string_append_c (out, '\n');
+                break;
+            case 'r':
+                g_string_append_c (out, '\r');
+                break;
+            case 't':
+                g_string_append_c (out, '\t');
+                break;
+            case 'u': {
+                gchar    digits [5];
+                gunichar c;
+
+                if (strlen (s + 1) < 4)
+                    return FALSE;
+                memcpy (digits, s + 1, 4);
+                digits [4] = '\0';
+                c = (gunichar) strtoul (digits, NULL, 16);
+                g_string_append_unichar (out, c);
+                s += 4;
+                break;
+            }
+            case '\0':
+                return FALSE;
+            default:
+                g_string_append_c (out, *s);
+                break;
+        }
+        s++;
+    }
+
+    *p = s + 1;
+    return TRUE;
+}
+
+/* skip a value which does not contribute to the configuration */
+static gboolean
+skip_json_value (const gchar **p)
+{
+    GString *scratch;
+    gint     depth = 0;
+
+    if (**p == '"') {
+        gboolean ok;
+
+        scratch = g_string_new (NULL);
+        ok = parse_json_string (p, scratch);
+        g_string_free (scratch, TRUE);
+        return ok;
+    }
+
+    for (; **p; (*p)++) {
+        switch (**p) {
+            case '[':
+            case '{':
+                depth++;
+                break;
+            case ']':
+            case '}':
+                if (! depth)
+                    return TRUE;
+                if (! --depth) {
+                    (*p)++;
+                    return TRUE;
+                }
+                break;
+            case ',':
+                if (! depth)
+                    return TRUE;
+                break;
+        }
+    }
+
+    return FALSE;
+}
+
+/*
+ * Parse the members of a category, which are "key":"value" pairs enclosed in
+ * brackets (asterisk 1.6) or braces. Newer servers nest the lines in a
+ * "data" member next to some attributes of the category; only the lines are
+ * kept in that case.
+ */
+static gboolean
+parse_json_category (const gchar **p,
+                     GamiConfigCategory *category,
+                     GString *key,
+                     GString *value)
+{
+    GPtrArray *attributes;
+    gboolean   has_data = FALSE;
+    gchar      close;
+    guint      i;
+
+    if (**p != '[' && **p != '{')
+        return FALSE;
+    close = **p == '[' ? ']' : '}';
+    (*p)++;
+
+    attributes = g_ptr_array_new ();
+
+    for (;;) {
+        skip_space (p);
+        if (**p == close)
+            break;
+
+        if (! parse_json_string (p, key))
+            goto error;
+        skip_space (p);
+        if (*(*p)++ != ':')
+            goto error;
+        skip_space (p);
+
+        if (**p == '"') {
+            if (! parse_json_string (p, value))
+                goto error;
+            g_ptr_array_add (attributes, g_strdup (key->str));
+            g_ptr_array_add (attributes, g_strdup (value->str));
+        } else if ((**p == '[' || **p == '{') && ! strcmp (key->str, "data")) {
+            if (! parse_json_category (p, category, key, value))
+                goto error;
+            has_data = TRUE;
+        } else if (! skip_json_value (p))
+            goto error;
+
+        skip_space (p);
+        if (**p == ',')
+            (*p)++;
+        else if (**p != close)
+            goto error;
+    }
+    (*p)++;
+
+    for (i = 0; ! has_data && i < attributes->len; i += 2)
+        gami_config_category_add_line (category,
+                                       g_ptr_array_index (attributes, i),
+                                       g_ptr_array_index (attributes, i + 1));
+
+    g_ptr_array_foreach (attributes, (GFunc) g_free, NULL);
+    g_ptr_array_free (attributes, TRUE);
+    return TRUE;
+
+error:
+    g_ptr_array_foreach (attributes, (GFunc) g_free, NULL);
+    g_ptr_array_free (attributes, TRUE);
+    return FALSE;
+}
+
+/**
+ * gami_config_new_from_json:
+ * @json: the JSON header of a GetConfigJSON response
+ *
+ * Build a configuration from the object returned by the GetConfigJSON action,
+ * which maps category names to their lines.
+ *
+ * Returns: a new #GamiConfig, or %NULL if @json could not be parsed
+ */
+GamiConfig *
+gami_config_new_from_json (const gchar *json)
+{
+    GamiConfig  *config;
+    GString     *key, *value;
+    const gchar *p = json;
+
+    g_return_val_if_fail (json != NULL, NULL);
+
+    config = gami_config_new ();
+    key = g_string_new (NULL);
+    value = g_string_new (NULL);
+
+    skip_space (&p);
+    if (*p++ != '{')
+        goto error;
+
+    for (;;) {
+        GamiConfigCategory *category;
+
+        skip_space (&p);
+        if (*p == '}')
+            break;
+
+        if (! parse_json_string (&p, key))
+            goto error;
+        skip_space (&p);
+        if (*p++ != ':')
+            goto error;
+        skip_space (&p);
+
+        category = gami_config_add_category (config, key->str);
+        if (! parse_json_category (&p, category, key, value))
+            goto error;
+
+        skip_space (&p);
+        if (*p == ',')
+            p++;
+        else if (*p != '}')
+            goto error;
+    }
+
+    g_string_free (key, TRUE);
+    g_string_free (value, TRUE);
+    return config;
+
+error:
+    g_string_free (key, TRUE);
+    g_string_free (value, TRUE);
+    gami_config_unref (config);
+    return NULL;
+}
+
+/**
+ * gami_config_ref:
+ * @config: a #GamiConfig
+ *
+ * Increase the reference count of @config.
+ *
+ * Returns: a reference to @config
+ */
+GamiConfig *
+gami_config_ref (GamiConfig *config)
+{
+    g_return_val_if_fail (config != NULL, NULL);
+    g_return_val_if_fail (config->ref_count > 0, config);
+
+    g_atomic_int_add (&config->ref_count, 1);
+    return config;
+}
+
+/**
+ * gami_config_unref:
+ * @config: a #GamiConfig
+ *
+ * Decrease the reference count of @config. If the reference count drops to 0,
+ * all memory allocated for @config is freed
+ */
+void
+gami_config_unref (GamiConfig *config)
+{
+    g_return_if_fail (config != NULL);
+    g_return_if_fail (config->ref_count > 0);
+
+    if (g_atomic_int_exchange_and_add (&config->ref_count, -1) - 1 == 0) {
+        g_ptr_array_foreach (config->categories, (GFunc) category_free, NULL);
+        g_ptr_array_free (config->categories, TRUE);
+        g_hash_table_destroy (config->index);
+        g_string_chunk_free (config->strings);
+        g_free (config);
+    }
+}
+
+/**
+ * gami_config_add_category:
+ * @config: a #GamiConfig
+ * @name: the name of the category
+ *
+ * Append a new, empty category to @config.
+ *
+ * Returns: the new #GamiConfigCategory, owned by @config
+ */
+GamiConfigCategory *
+gami_config_add_category (GamiConfig *config, const gchar *name)
+{
+    g_return_val_if_fail (config != NULL, NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    return append_category (config,
+                            g_string_chunk_insert_const (config->strings,
+                                                         name));
+}
+
+/**
+ * gami_config_get_n_categories:
+ * @config: a #GamiConfig
+ *
+ * Get the number of categories in @config.
+ *
+ * Returns: the number of categories
+ */
+guint
+gami_config_get_n_categories (GamiConfig *config)
+{
+    g_return_val_if_fail (config != NULL, 0);
+
+    return config->categories->len;
+}
+
+/**
+ * gami_config_get_category:
+ * @config: a #GamiConfig
+ * @index: the position of the category
+ *
+ * Get the category at @index in file order.
+ *
+ * Returns: the #GamiConfigCategory, or %NULL if @index is out of range
+ */
+GamiConfigCategory *
+gami_config_get_category (GamiConfig *config, guint index)
+{
+    g_return_val_if_fail (config != NULL, NULL);
+
+    if (index >= config->categories->len)
+        return NULL;
+
+    return g_ptr_array_index (config->categories, index);
+}
+
+/**
+ * gami_config_lookup_category:
+ * @config: a #GamiConfig
+ * @name: the name of the category
+ *
+ * Find the first category named @name.
+ *
+ * Returns: the #GamiConfigCategory, or %NULL
+ */
+GamiConfigCategory *
+gami_config_lookup_category (GamiConfig *config, const gchar *name)
+{
+    g_return_val_if_fail (config != NULL, NULL);
+    g_return_val_if_fail (name != NULL, NULL);
+
+    return g_hash_table_lookup (config->index, name);
+}
+
+/**
+ * gami_config_get_value:
+ * @config: a #GamiConfig
+ * @category: the name of the category
+ * @key: the name of the variable
+ *
+ * Look up the first value of @key in the first category named @category.
+ *
+ * Returns: the value, or %NULL
+ */
+const gchar *
+gami_config_get_value (GamiConfig *config,
+                       const gchar *category,
+                       const gchar *key)
+{
+    GamiConfigCategory *cat;
+
+    g_return_val_if_fail (config != NULL, NULL);
+    g_return_val_if_fail (category != NULL, NULL);
+    g_return_val_if_fail (key != NULL, NULL);
+
+    cat = g_hash_table_lookup (config->index, category);
+
+    return cat ? gami_config_category_lookup (cat, key) : NULL;
+}
+
+/**
+ * gami_config_category_get_name:
+ * @category: a #GamiConfigCategory
+ *
+ * Get the name of @category.
+ *
+ * Returns: the name of @category
+ */
+const gchar *
+gami_config_category_get_name (GamiConfigCategory *category)
+{
+    g_return_val_if_fail (category != NULL, NULL);
+
+    return category->name;
+}
+
+/**
+ * gami_config_category_add_line:
+ * @category: a #GamiConfigCategory
+ * @key: the name of the variable
+ * @value: the value of the variable
+ *
+ * Append a line to @category.
+ */
+void
+gami_config_category_add_line (GamiConfigCategory *category,
+                               const gchar *key,
+                               const gchar *value)
+{
+    GStringChunk *strings;
+
+    g_return_if_fail (category != NULL);
+    g_return_if_fail (key != NULL);
+
+    strings = category->config->strings;
+    append_line (category,
+                 g_string_chunk_insert_const (strings, key),
+                 g_string_chunk_insert_const (strings, value ? value : ""));
+}
+
+/**
+ * gami_config_category_get_n_lines:
+ * @category: a #GamiConfigCategory
+ *
+ * Get the number of lines in @category.
+ *
+ * Returns: the number of lines
+ */
+guint
+gami_config_category_get_n_lines (GamiConfigCategory *category)
+{
+    g_return_val_if_fail (category != NULL, 0);
+
+    return category->lines->len;
+}
+
+/**
+ * gami_config_category_get_line:
+ * @category: a #GamiConfigCategory
+ * @index: the position of the line
+ *
+ * Get the line at @index in file order. The result remains valid until a
+ * line is added to @category.
+ *
+ * Returns: the #GamiConfigLine, or %NULL if @index is out of range
+ */
+const GamiConfigLine *
+gami_config_category_get_line (GamiConfigCategory *category, guint index)
+{
+    g_return_val_if_fail (category != NULL, NULL);
+
+    if (index >= category->lines->len)
+        return NULL;
+
+    return &g_array_index (category->lines, GamiConfigLine, index);
+}
+
+/**
+ * gami_config_category_lookup:
+ * @category: a #GamiConfigCategory
+ * @key: the name of the variable
+ *
+ * Look up the first value of @key in @category.
+ *
+ * Returns: the value, or %NULL
+ */
+const gchar *
+gami_config_category_lookup (GamiConfigCategory *category, const gchar *key)
+{
+    guint index;
+
+    g_return_val_if_fail (category != NULL, NULL);
+    g_return_val_if_fail (key != NULL, NULL);
+
+    index = GPOINTER_TO_UINT (g_hash_table_lookup (category->index, key));
+    if (! index)
+        return NULL;
+
+    return g_array_index (category->lines, GamiConfigLine, index - 1).value;
+}
+
+/**
+ * gami_config_category_get_values:
+ * @category: a #GamiConfigCategory
+ * @key: the name of the variable
+ *
+ * Get all values of @key in @category, in file order. The values are owned
+ * by the #GamiConfig, the list should be freed with g_slist_free().
+ *
+ * Returns: a #GSList of values
+ */
+GSList *
+gami_config_category_get_values (GamiConfigCategory *category,
+                                 const gchar *key)
+{
+    GSList *values = NULL;
+    guint   i;
+
+    g_return_val_if_fail (category != NULL, NULL);
+    g_return_val_if_fail (key != NULL, NULL);
+
+    for (i = category->lines->len; i > 0; i--) {
+        GamiConfigLine *line;
+
+        line = &g_array_index (category->lines, GamiConfigLine, i - 1);
+        if (! strcmp (line->key, key))
+            values = g_slist_prepend (values, (gpointer) line->value);
+    }
+
+    return values;
+}
+
+static gpointer
+config_change_copy (gpointer boxed)
+{
+    return gami_config_change_copy (boxed);
+}
+
+static void
+config_change_free (gpointer boxed)
+{
+    gami_config_change_free (boxed);
+}
+
+GType
+gami_config_change_get_type (void)
+{
+    static GType type_id = 0;
+    if (! type_id)
+        type_id = g_boxed_type_register_static (g_intern_static_string
+                                                ("GamiConfigChange"),
+                                                config_change_copy,
+                                                config_change_free);
+    return type_id;
+}
+
+/**
+ * gami_config_change_new:
+ * @action: the operation to perform
+ * @category: the name of the category to operate on
+ * @variable: the name of the variable, or %NULL for category operations
+ * @value: the value of the variable, or %NULL
+ * @match: only operate on a variable with this value, or %NULL
+ *
+ * Create a modification of a configuration file, see #GamiConfigChange.
+ *
+ * Returns: a new #GamiConfigChange, free with gami_config_change_free()
+ */
+GamiConfigChange *
+gami_config_change_new (GamiConfigAction action,
+                        const gchar *category,
+                        const gchar *variable,
+                        const gchar *value,
+                        const gchar *match)
+{
+    GamiConfigChange *change;
+
+    g_return_val_if_fail (category != NULL, NULL);
+
+    change = g_slice_new (GamiConfigChange);
+    change->action = action;
+    change->category = g_strdup (category);
+    change->variable = g_strdup (variable);
+    change->value = g_strdup (value);
+    change->match = g_strdup (match);
+
+    return change;
+}
+
+/**
+ * gami_config_change_copy:
+ * @change: a #GamiConfigChange
+ *
+ * Copy @change.
+ *
+ * Returns: a new #GamiConfigChange, free with gami_config_change_free()
+ */
+GamiConfigChange *
+gami_config_change_copy (const GamiConfigChange *change)
+{
+    g_return_val_if_fail (change != NULL, NULL);
+
+    return gami_config_change_new (change->action,
+                                   change->category,
+                                   change->variable,
+                                   change->value,
+                                   change->match);
+}
+
+/**
+ * gami_config_change_free:
+ * @change: a #GamiConfigChange
+ *
+ * Free all memory allocated for @change.
+ */
+void
+gami_config_change_free (GamiConfigChange *change)
+{
+    g_return_if_fail (change != NULL);
+
+    g_free (change->category);
+    g_free (change->variable);
+    g_free (change->value);
+    g_free (change->match);
+    g_slice_free (GamiConfigChange, change);
+}
+
+/* collect the values of category by key; keys are added to order in the
+ * order of their first occurrence */
+static GHashTable *
+group_values (GamiConfigCategory *category, GPtrArray *order)
+{
+    GHashTable *groups;
+    guint       i;
+
+    groups = g_hash_table_new_full (g_str_hash, g_str_equal, NULL,
+                                    (GDestroyNotify) g_ptr_array_unref);
+
+    for (i = 0; i < category->lines->len; i++) {
+        GamiConfigLine *line;
+        GPtrArray      *values;
+
+        line = &g_array_index (category->lines, GamiConfigLine, i);
+        values = g_hash_table_lookup (groups, line->key);
+        if (! values) {
+            values = g_ptr_array_new ();
+            g_hash_table_insert (groups, (gpointer) line->key, values);
+            g_ptr_array_add (order, (gpointer) line->key);
+        }
+        g_ptr_array_add (values, (gpointer) line->value);
+    }
+
+    return groups;
+}
+
+static GSList *
+prepend_change (GSList *changes,
+                GamiConfigAction action,
+                const gchar *category,
+                const gchar *variable,
+                const gchar *value,
+                const gchar *match)
+{
+    return g_slist_prepend (changes,
+                            gami_config_change_new (action, category,
+                                                    variable, value, match));
+}
+
+/*
+ * Prepend the changes turning the values of variable in category from
+ * current into desired (either may be NULL). A single value is updated in
+ * place; otherwise values are deleted by match and appended, which keeps
+ * the order of the values of a variable but not their position relative to
+ * other variables.
+ */
+static GSList *
+diff_values (GSList *changes,
+             const gchar *category,
+             const gchar *variable,
+             GPtrArray *current,
+             GPtrArray *desired)
+{
+    GPtrArray *kept;
+    gboolean  *used;
+    guint      i, j;
+
+    if (current && desired && current->len == 1 && desired->len == 1) {
+        if (strcmp (g_ptr_array_index (current, 0),
+                    g_ptr_array_index (desired, 0)))
+            changes = prepend_change (changes, GAMI_CONFIG_UPDATE,
+                                      category, variable,
+                                      g_ptr_array_index (desired, 0), NULL);
+        return changes;
+    }
+
+    kept = g_ptr_array_new ();
+    used = g_new0 (gboolean, desired ? desired->len : 0);
+
+    /* delete values which are no longer wanted */
+    for (i = 0; current && i < current->len; i++) {
+        const gchar *value = g_ptr_array_index (current, i);
+
+        for (j = 0; desired && j < desired->len; j++)
+            if (! used [j] && ! strcmp (value, g_ptr_array_index (desired, j)))
+                break;
+
+        if (desired && j < desired->len) {
+            used [j] = TRUE;
+            g_ptr_array_add (kept, (gpointer) value);
+        } else
+            changes = prepend_change (changes, GAMI_CONFIG_DELETE,
+                                      category, variable, NULL, value);
+    }
+
+    /* new values can only be appended, so the kept ones must lead */
+    for (i = 0; i < kept->len; i++)
+        if (strcmp (g_ptr_array_index (kept, i),
+                    g_ptr_array_index (desired, i)))
+            break;
+
+    if (i < kept->len) {
+        for (i = 0; i < kept->len; i++)
+            changes = prepend_change (changes, GAMI_CONFIG_DELETE,
+                                      category, variable, NULL,
+                                      g_ptr_array_index (kept, i));
+        i = 0;
+    }
+
+    for (; desired && i < desired->len; i++)
+        changes = prepend_change (changes, GAMI_CONFIG_APPEND,
+                                  category, variable,
+                                  g_ptr_array_index (desired, i), NULL);
+
+    g_free (used);
+    g_ptr_array_free (kept, TRUE);
+
+    return changes;
+}
+
+static GSList *
+diff_category (GSList *changes,
+               GamiConfigCategory *current,
+               GamiConfigCategory *desired)
+{
+    GHashTable *current_values, *desired_values;
+    GPtrArray  *current_keys, *desired_keys;
+    guint       i;
+
+    current_keys = g_ptr_array_new ();
+    desired_keys = g_ptr_array_new ();
+    current_values = group_values (current, current_keys);
+    desired_values = group_values (desired, desired_keys);
+
+    for (i = 0; i < current_keys->len; i++) {
+        const gchar *key = g_ptr_array_index (current_keys, i);
+
+        if (! g_hash_table_lookup (desired_values, key))
+            changes = diff_values (changes, desired->name, key,
+                                   g_hash_table_lookup (current_values, key),
+                                   NULL);
+    }
+
+    for (i = 0; i < desired_keys->len; i++) {
+        const gchar *key = g_ptr_array_index (desired_keys, i);
+
+        changes = diff_values (changes, desired->name, key,
+                               g_hash_table_lookup (current_values, key),
+                               g_hash_table_lookup (desired_values, key));
+    }
+
+    g_hash_table_destroy (current_values);
+    g_hash_table_destroy (desired_values);
+    g_ptr_array_free (current_keys, TRUE);
+    g_ptr_array_free (desired_keys, TRUE);
+
+    return changes;
+}
+
+/**
+ * gami_config_diff:
+ * @current: the configuration as found on the server
+ * @desired: the configuration to turn @current into
+ *
+ * Compute the changes which turn @current into @desired, for use with
+ * gami_manager_update_config(). Only categories and variables that differ
+ * are touched: categories are created and deleted as a whole, a variable
+ * with a single value is updated in place and variables with several values
+ * (e.g. "allow") are changed value by value.
+ *
+ * As the server addresses categories by name, only the first category of a
+ * name is compared; categories repeating a name are ignored.
+ *
+ * Returns: a #GSList of #GamiConfigChange<!-- -->s in the order they have to
+ * be applied, which is empty if the configurations match. Free with
+ * gami_config_change_free() and g_slist_free().
+ */
+GSList *
+gami_config_diff (GamiConfig *current, GamiConfig *desired)
+{
+    GSList *changes = NULL;
+    guint   i;
+
+    g_return_val_if_fail (current != NULL, NULL);
+    g_return_val_if_fail (desired != NULL, NULL);
+
+    for (i = 0; i < current->categories->len; i++) {
+        GamiConfigCategory *category;
+
+        category = g_ptr_array_index (current->categories, i);
+        if (g_hash_table_lookup (current->index, category->name) != category)
+            continue;
+
+        if (! g_hash_table_lookup (desired->index, category->name))
+            changes = prepend_change (changes, GAMI_CONFIG_DELETE_CATEGORY,
+                                      category->name, NULL, NULL, NULL);
+    }
+
+    for (i = 0; i < desired->categories->len; i++) {
+        GamiConfigCategory *category, *old;
+        guint               j;
+
+        category = g_ptr_array_index (desired->categories, i);
+        if (g_hash_table_lookup (desired->index, category->name) != category)
+            continue;
+
+        old = g_hash_table_lookup (current->index, category->name);
+        if (old) {
+            changes = diff_category (changes, old, category);
+            continue;
+        }
+
+        changes = prepend_change (changes, GAMI_CONFIG_NEW_CATEGORY,
+                                  category->name, NULL, NULL, NULL);
+        for (j = 0; j < category->lines->len; j++) {
+            GamiConfigLine *line;
+
+            line = &g_array_index (category->lines, GamiConfigLine, j);
+            changes = prepend_change (changes, GAMI_CONFIG_APPEND,
+                                      category->name, line->key,
+                                      line->value, NULL);
+        }
+    }
+
+    return g_slist_reverse (changes);
+}
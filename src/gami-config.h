@@ -0,0 +1,168 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)
+#  error "Only <gami.h> can be included directly."
+#endif
+
+#ifndef __GAMI_CONFIG_H__
+#define __GAMI_CONFIG_H__
+
+#include <glib.h>
+#include <glib-object.h>
+
+#include <gami-enums.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GamiConfig:
+ *
+ * #GamiConfig is an opaque, ref-counted representation of a configuration
+ * file, as a list of categories.
+ */
+typedef struct _GamiConfig GamiConfig;
+
+/**
+ * GamiConfigCategory:
+ *
+ * #GamiConfigCategory is an opaque structure representing a category of a
+ * #GamiConfig, with its lines in file order. It is owned by the
+ * #GamiConfig it belongs to.
+ */
+typedef struct _GamiConfigCategory GamiConfigCategory;
+
+/**
+ * GamiConfigLine:
+ * @key: the name of the variable
+ * @value: the value of the variable
+ *
+ * A single line of a #GamiConfigCategory. Strings are owned by the
+ * #GamiConfig and remain valid as long as it is alive.
+ */
+typedef struct _GamiConfigLine GamiConfigLine;
+
+struct _GamiConfigLine {
+	const gchar *key;
+	const gchar *value;
+};
+
+/**
+ * GamiConfigChange:
+ * @action: the operation to perform
+ * @category: the name of the category to operate on
+ * @variable: the name of the variable, for variable operations
+ * @value: the new value of the variable, or the new name of the category
+ *         for %GAMI_CONFIG_RENAME_CATEGORY
+ * @match: only operate on a variable with this value, or %NULL
+ *
+ * A single modification of a configuration file, as sent with
+ * gami_manager_update_config() and returned by gami_config_diff().
+ */
+typedef struct _GamiConfigChange GamiConfigChange;
+
+struct _GamiConfigChange {
+	GamiConfigAction action;
+	gchar *category;
+	gchar *variable;
+	gchar *value;
+	gchar *match;
+};
+
+/**
+ * GAMI_TYPE_CONFIG:
+ *
+ * Get the #GType of #GamiConfig
+ *
+ * Returns: The #GType of #GamiConfig
+ */
+#define GAMI_TYPE_CONFIG (gami_config_get_type ())
+
+/**
+ * gami_config_get_type:
+ *
+ * Get the #GType of #GamiConfig
+ *
+ * Returns: The #GType of #GamiConfig
+ */
+GType gami_config_get_type (void) G_GNUC_CONST;
+
+/**
+ * GAMI_TYPE_CONFIG_CHANGE:
+ *
+ * Get the #GType of #GamiConfigChange
+ *
+ * Returns: The #GType of #GamiConfigChange
+ */
+#define GAMI_TYPE_CONFIG_CHANGE (gami_config_change_get_type ())
+
+/**
+ * gami_config_change_get_type:
+ *
+ * Get the #GType of #GamiConfigChange
+ *
+ * Returns: The #GType of #GamiConfigChange
+ */
+GType gami_config_change_get_type (void) G_GNUC_CONST;
+
+GamiConfig *gami_config_new (void);
+GamiConfig *gami_config_new_from_json (const gchar *json);
+
+GamiConfig *gami_config_ref (GamiConfig *config);
+void gami_config_unref (GamiConfig *config);
+
+GamiConfigCategory *gami_config_add_category (GamiConfig *config,
+                                              const gchar *name);
+guint gami_config_get_n_categories (GamiConfig *config);
+GamiConfigCategory *gami_config_get_category (GamiConfig *config,
+                                              guint index);
+GamiConfigCategory *gami_config_lookup_category (GamiConfig *config,
+                                                 const gchar *name);
+const gchar *gami_config_get_value (GamiConfig *config,
+                                    const gchar *category,
+                                    const gchar *key);
+
+const gchar *gami_config_category_get_name (GamiConfigCategory *category);
+void gami_config_category_add_line (GamiConfigCategory *category,
+                                    const gchar *key,
+                                    const gchar *value);
+guint gami_config_category_get_n_lines (GamiConfigCategory *category);
+const GamiConfigLine *gami_config_category_get_line
+                                            (GamiConfigCategory *category,
+                                             guint index);
+const gchar *gami_config_category_lookup (GamiConfigCategory *category,
+                                          const gchar *key);
+GSList *gami_config_category_get_values (GamiConfigCategory *category,
+                                         const gchar *key);
+
+GamiConfigChange *gami_config_change_new (GamiConfigAction action,
+                                          const gchar *category,
+                                          const gchar *variable,
+                                          const gchar *value,
+                                          const gchar *match);
+GamiConfigChange *gami_config_change_copy (const GamiConfigChange *change);
+void gami_config_change_free (GamiConfigChange *change);
+
+GSList *gami_config_diff (GamiConfig *current, GamiConfig *desired);
+
+G_END_DECLS
+
+#endif /* __GAMI_CONFIG_H__ */
@@ -0,0 +1,771 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gami-dialplan.h>
+
+/**
+ * SECTION: libgami-dialplan
+ * @short_description: Indexed snapshot of the dialplan
+ * @title: GamiDialplan
+ * @stability: Unstable
+ *
+ * #GamiDialplan holds the dialplan retrieved with ShowDialPlan, indexed by
+ * context, extension and priority. Extensions are matched the way Asterisk
+ * does, including extension patterns and included contexts, so that e.g.
+ * the target of an Originate action can be validated locally instead of
+ * waiting for the action to fail.
+ *
+ * Strings are stored once in a #GStringChunk, as application names and
+ * arguments are highly repetitive in large dialplans.
+ */
+
+struct _GamiDialplan {
+    GHashTable    *contexts;
+    GStringChunk  *strings;
+    volatile gint  ref_count;
+};
+
+typedef struct {
+    GHashTable *extensions;
+    GPtrArray  *patterns;
+    gboolean    sorted;
+    GPtrArray  *includes;
+} DialplanContext;
+
+typedef struct {
+    const gchar *name;
+    GArray      *priorities;
+} DialplanExtension;
+
+typedef struct {
+    GSimpleAsyncResult *simple;
+    GamiDialplan       *dialplan;
+} LoadData;
+
+static void
+extension_free (DialplanExtension *extension)
+{
+    g_array_free (extension->priorities, TRUE);
+    g_slice_free (DialplanExtension, extension);
+}
+
+static void
+context_free (DialplanContext *context)
+{
+    g_hash_table_destroy (context->extensions);
+    g_ptr_array_free (context->patterns, TRUE);
+    g_ptr_array_free (context->includes, TRUE);
+    g_slice_free (DialplanContext, context);
+}
+
+static const gchar *
+intern (GamiDialplan *dialplan, const gchar *string)
+{
+    if (! string || ! *string)
+        return NULL;
+    return g_string_chunk_insert_const (dialplan->strings, string);
+}
+
+static DialplanContext *
+get_context (GamiDialplan *dialplan, const gchar *name)
+{
+    DialplanContext *context;
+
+    context = g_hash_table_lookup (dialplan->contexts, name);
+    if (! context) {
+        context = g_slice_new (DialplanContext);
+        context->extensions = g_hash_table_new_full (g_str_hash,
+                                                     g_str_equal,
+                                                     NULL,
+                                                     (GDestroyNotify)
+                                                     extension_free);
+        context->patterns = g_ptr_array_new ();
+        context->sorted = TRUE;
+        context->includes = g_ptr_array_new ();
+
+        g_hash_table_insert (dialplan->contexts,
+                             (gpointer) intern (dialplan, name),
+                             context);
+    }
+
+    return context;
+}
+
+static DialplanExtension *
+get_extension (GamiDialplan *dialplan,
+               DialplanContext *context,
+               const gchar *name)
+{
+    DialplanExtension *extension;
+
+    extension = g_hash_table_lookup (context->extensions, name);
+    if (! extension) {
+        extension = g_slice_new (DialplanExtension);
+        extension->name = intern (dialplan, name);
+        extension->priorities = g_array_new (FALSE,
+                                             FALSE,
+                                             sizeof (GamiDialplanPriority));
+
+        g_hash_table_insert (context->extensions,
+                             (gpointer) extension->name,
+                             extension);
+
+        if (name[0] == '_') {
+            g_ptr_array_add (context->patterns, extension);
+            context->sorted = FALSE;
+        }
+    }
+
+    return extension;
+}
+
+/* index of priority in the (sorted) priorities of extension, or of the
+ * position where it would have to be inserted */
+static guint
+find_priority (DialplanExtension *extension, gint priority)
+{
+    guint lo = 0, hi = extension->priorities->len;
+
+    while (lo < hi) {
+        guint mid = (lo + hi) / 2;
+
+        if (g_array_index (extension->priorities,
+                           GamiDialplanPriority, mid).priority < priority)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* parse a character class of a pattern, p pointing behind the opening
+ * bracket; returns the position of the closing bracket */
+static const gchar *
+parse_class (const gchar *p, gchar c, gboolean *matched, guint *size)
+{
+    *matched = FALSE;
+    *size = 0;
+
+    for (; *p && *p != ']'; p++) {
+        gchar lo = *p, hi = *p;
+
+        if (p[1] == '-' && p[2] && p[2] != ']') {
+            hi = p[2];
+            p += 2;
+        }
+        if (hi < lo)
+            continue;
+
+        *size += hi - lo + 1;
+        if (c >= lo && c <= hi)
+            *matched = TRUE;
+    }
+
+    return p;
+}
+
+/* the number of characters matched by the pattern element at *p, moving
+ * *p to the next element; returns 0 at the end of the pattern */
+static guint
+element_weight (const gchar **p)
+{
+    gboolean matched;
+    guint    size;
+
+    while (**p == '-')
+        (*p)++;
+
+    switch (**p) {
+        case '\0':
+            return 0;
+        case 'X':
+        case 'x':
+            size = 10;
+            break;
+        case 'Z':
+        case 'z':
+            size = 9;
+            break;
+        case 'N':
+        case 'n':
+            size = 8;
+            break;
+        case '.':
+            size = G_MAXUINT - 1;
+            break;
+        case '!':
+            size = G_MAXUINT;
+            break;
+        case '[':
+            *p = parse_class (*p + 1, '\0', &matched, &size);
+            if (! **p)
+                return size ? size : 1;
+            break;
+        default:
+            size = 1;
+            break;
+    }
+
+    (*p)++;
+    return size ? size : 1;
+}
+
+/* order patterns from the most to the least specific one, like Asterisk
+ * does when searching a context */
+static gint
+pattern_compare (gconstpointer a, gconstpointer b)
+{
+    const gchar *pa = (*(DialplanExtension **) a)->name + 1;
+    const gchar *pb = (*(DialplanExtension **) b)->name + 1;
+    const gchar *na = pa, *nb = pb;
+
+    for (;;) {
+        guint wa = element_weight (&pa);
+        guint wb = element_weight (&pb);
+
+        if (wa != wb)
+            return wa < wb ? -1 : 1;
+        if (! wa)
+            break;
+    }
+
+    return strcmp (na, nb);
+}
+
+static gboolean
+pattern_match (const gchar *pattern, const gchar *exten)
+{
+    const gchar *p;
+    const gchar *e = exten;
+
+    for (p = pattern; *p; p++) {
+        gboolean matched;
+        guint    size;
+
+        switch (*p) {
+            case '-':
+                continue;
+            case '.':
+                return *e != '\0';
+            case '!':
+                return TRUE;
+        }
+
+        if (! *e)
+            return FALSE;
+
+        switch (*p) {
+            case 'X':
+            case 'x':
+                matched = *e >= '0' && *e <= '9';
+                break;
+            case 'Z':
+            case 'z':
+                matched = *e >= '1' && *e <= '9';
+                break;
+            case 'N':
+            case 'n':
+                matched = *e >= '2' && *e <= '9';
+                break;
+            case '[':
+                p = parse_class (p + 1, *e, &matched, &size);
+                if (! *p)
+                    return FALSE;
+                break;
+            default:
+                matched = *p == *e;
+                break;
+        }
+
+        if (! matched)
+            return FALSE;
+        e++;
+    }
+
+    return *e == '\0';
+}
+
+static DialplanExtension *
+match_in_context (GamiDialplan *dialplan,
+                  const gchar *name,
+                  const gchar *exten,
+                  GHashTable *visited)
+{
+    DialplanContext   *context;
+    DialplanExtension *extension;
+    guint              i;
+
+    if (g_hash_table_lookup (visited, name))
+        return NULL;
+    g_hash_table_insert (visited, (gpointer) name, GINT_TO_POINTER (TRUE));
+
+    context = g_hash_table_lookup (dialplan->contexts, name);
+    if (! context)
+        return NULL;
+
+    extension = g_hash_table_lookup (context->extensions, exten);
+    if (extension)
+        return extension;
+
+    if (! context->sorted) {
+        g_ptr_array_sort (context->patterns, pattern_compare);
+        context->sorted = TRUE;
+    }
+
+    for (i = 0; i < context->patterns->len; i++) {
+        extension = g_ptr_array_index (context->patterns, i);
+        if (pattern_match (extension->name + 1, exten))
+            return extension;
+    }
+
+    for (i = 0; i < context->includes->len; i++) {
+        extension = match_in_context (dialplan,
+                                      g_ptr_array_index (context->includes, i),
+                                      exten,
+                                      visited);
+        if (extension)
+            return extension;
+    }
+
+    return NULL;
+}
+
+static DialplanExtension *
+match_extension (GamiDialplan *dialplan,
+                 const gchar *context,
+                 const gchar *exten)
+{
+    DialplanExtension *extension;
+    GHashTable        *visited;
+
+    visited = g_hash_table_new (g_str_hash, g_str_equal);
+    extension = match_in_context (dialplan, context, exten, visited);
+    g_hash_table_destroy (visited);
+
+    return extension;
+}
+
+static gpointer
+dialplan_copy (gpointer boxed)
+{
+    return gami_dialplan_ref (boxed);
+}
+
+static void
+dialplan_free (gpointer boxed)
+{
+    gami_dialplan_unref (boxed);
+}
+
+GType
+gami_dialplan_get_type (void)
+{
+    static GType type_id = 0;
+    if (! type_id)
+        type_id = g_boxed_type_register_static (g_intern_static_string
+                                                ("GamiDialplan"),
+                                                dialplan_copy,
+                                                dialplan_free);
+    return type_id;
+}
+
+/**
+ * gami_dialplan_new:
+ *
+ * Create an empty dialplan, to be filled using gami_dialplan_add_entry().
+ * Use gami_dialplan_load() to retrieve the dialplan of a server.
+ *
+ * Returns: a new #GamiDialplan
+ */
+GamiDialplan *
+gami_dialplan_new (void)
+{
+    GamiDialplan *dialplan;
+
+    dialplan = g_new (GamiDialplan, 1);
+    dialplan->contexts = g_hash_table_new_full (g_str_hash,
+                                                g_str_equal,
+                                                NULL,
+                                                (GDestroyNotify) context_free);
+    dialplan->strings = g_string_chunk_new (4096);
+    dialplan->ref_count = 1;
+
+    return dialplan;
+}
+
+/**
+ * gami_dialplan_ref:
+ * @dialplan: a #GamiDialplan
+ *
+ * Increase the reference count of @dialplan.
+ *
+ * Returns: a reference to @dialplan
+ */
+GamiDialplan *
+gami_dialplan_ref (GamiDialplan *dialplan)
+{
+    g_return_val_if_fail (dialplan != NULL, NULL);
+    g_return_val_if_fail (dialplan->ref_count > 0, dialplan);
+
+    g_atomic_int_add (&dialplan->ref_count, 1);
+    return dialplan;
+}
+
+/**
+ * gami_dialplan_unref:
+ * @dialplan: a #GamiDialplan
+ *
+ * Decrease the reference count of @dialplan. If the reference count drops
+ * to 0, all memory allocated for @dialplan is freed
+ */
+void
+gami_dialplan_unref (GamiDialplan *dialplan)
+{
+    g_return_if_fail (dialplan != NULL);
+    g_return_if_fail (dialplan->ref_count > 0);
+
+    if (g_atomic_int_exchange_and_add (&dialplan->ref_count, -1) - 1 == 0) {
+        g_hash_table_destroy (dialplan->contexts);
+        g_string_chunk_free (dialplan->strings);
+        g_free (dialplan);
+    }
+}
+
+/**
+ * gami_dialplan_add_entry:
+ * @dialplan: a #GamiDialplan
+ * @entry: the headers of a ListDialplan event
+ *
+ * Add a priority or an included context to @dialplan. An existing priority
+ * of the same extension is replaced.
+ */
+void
+gami_dialplan_add_entry (GamiDialplan *dialplan, GHashTable *entry)
+{
+    DialplanContext      *context;
+    DialplanExtension    *extension;
+    GamiDialplanPriority  step;
+    const gchar          *name, *include, *exten, *priority;
+    guint                 index;
+
+    g_return_if_fail (dialplan != NULL);
+    g_return_if_fail (entry != NULL);
+
+    name = g_hash_table_lookup (entry, "Context");
+    if (! name || ! *name)
+        return;
+    context = get_context (dialplan, name);
+
+    include = g_hash_table_lookup (entry, "IncludeContext");
+    if (include && *include) {
+        guint i;
+
+        include = intern (dialplan, include);
+        for (i = 0; i < context->includes->len; i++)
+            if (g_ptr_array_index (context->includes, i) == include)
+                return;
+        g_ptr_array_add (context->includes, (gpointer) include);
+        return;
+    }
+
+    exten = g_hash_table_lookup (entry, "Extension");
+    priority = g_hash_table_lookup (entry, "Priority");
+    if (! exten || ! *exten || ! priority)
+        return;
+
+    if (! g_ascii_strcasecmp (priority, "hint"))
+        step.priority = GAMI_DIALPLAN_PRIORITY_HINT;
+    else if ((step.priority = (gint) strtol (priority, NULL, 10)) <= 0)
+        return;
+
+    step.label = intern (dialplan, g_hash_table_lookup (entry,
+                                                        "ExtensionLabel"));
+    step.application = intern (dialplan, g_hash_table_lookup (entry,
+                                                              "Application"));
+    step.app_data = intern (dialplan, g_hash_table_lookup (entry, "AppData"));
+
+    extension = get_extension (dialplan, context, exten);
+    index = find_priority (extension, step.priority);
+
+    if (index < extension->priorities->len
+        && g_array_index (extension->priorities,
+                          GamiDialplanPriority, index).priority == step.priority)
+        g_array_index (extension->priorities,
+                       GamiDialplanPriority, index) = step;
+    else
+        g_array_insert_val (extension->priorities, index, step);
+}
+
+static void
+store_result (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    *(GAsyncResult **) user_data = g_object_ref (result);
+}
+
+/**
+ * gami_dialplan_load:
+ * @ami: #GamiManager
+ * @context: Only retrieve this context, or %NULL for the whole dialplan
+ * @error: A location to return an error of type #GIOErrorEnum
+ *
+ * Retrieve the dialplan of the server connected to @ami. Note that only the
+ * entries of @context are retrieved if given, so that extensions reached
+ * through included contexts are not found.
+ *
+ * Returns: a new #GamiDialplan, or %NULL on error
+ */
+GamiDialplan *
+gami_dialplan_load (GamiManager *ami, const gchar *context, GError **error)
+{
+    GAsyncResult *result = NULL;
+    GamiDialplan *dialplan;
+
+    gami_dialplan_load_async (ami, context, store_result, &result);
+
+    while (! result)
+        g_main_context_iteration (NULL, TRUE);
+
+    dialplan = gami_dialplan_load_finish (ami, result, error);
+    g_object_unref (result);
+
+    return dialplan;
+}
+
+static gboolean
+load_item (GamiManager *ami, GHashTable *item, gpointer user_data)
+{
+    gami_dialplan_add_entry (user_data, item);
+    return TRUE;
+}
+
+static void
+load_cb (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    LoadData *data = user_data;
+    GError   *error = NULL;
+
+    if (gami_manager_list_stream_finish (GAMI_MANAGER (source),
+                                         result,
+                                         &error) < 0) {
+        g_simple_async_result_set_from_error (data->simple, error);
+        g_error_free (error);
+    } else
+        g_simple_async_result_set_op_res_gpointer (data->simple,
+                                                   gami_dialplan_ref
+                                                   (data->dialplan),
+                                                   dialplan_free);
+
+    g_simple_async_result_complete (data->simple);
+
+    g_object_unref (data->simple);
+    gami_dialplan_unref (data->dialplan);
+    g_slice_free (LoadData, data);
+}
+
+/**
+ * gami_dialplan_load_async:
+ * @ami: #GamiManager
+ * @context: Only retrieve this context, or %NULL for the whole dialplan
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Asynchronously retrieve the dialplan of the server connected to @ami. The
+ * entries are indexed as they arrive, without keeping the ListDialplan events
+ * in memory. See gami_dialplan_load() for the synchronous version.
+ */
+void
+gami_dialplan_load_async (GamiManager *ami,
+                          const gchar *context,
+                          GAsyncReadyCallback callback,
+                          gpointer user_data)
+{
+    LoadData *data;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+
+    data = g_slice_new (LoadData);
+    data->simple = g_simple_async_result_new (G_OBJECT (ami),
+                                              callback,
+                                              user_data,
+                                              gami_dialplan_load_async);
+    data->dialplan = gami_dialplan_new ();
+
+    gami_manager_show_dialplan_stream_async (ami,
+                                             NULL,
+                                             context,
+                                             load_item,
+                                             data->dialplan,
+                                             NULL,
+                                             load_cb,
+                                             data);
+}
+
+/**
+ * gami_dialplan_load_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: A location to return an error of type #GIOErrorEnum
+ *
+ * Finishes an asynchronous load of the dialplan started with
+ * gami_dialplan_load_async().
+ *
+ * Returns: a new #GamiDialplan, or %NULL on error
+ */
+GamiDialplan *
+gami_dialplan_load_finish (GamiManager *ami,
+                           GAsyncResult *result,
+                           GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), NULL);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), NULL);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+
+    g_warn_if_fail (g_simple_async_result_get_source_tag (simple)
+                    == gami_dialplan_load_async);
+
+    if (g_simple_async_result_propagate_error (simple, error))
+        return NULL;
+
+    return gami_dialplan_ref (g_simple_async_result_get_op_res_gpointer
+                              (simple));
+}
+
+/**
+ * gami_dialplan_get_contexts:
+ * @dialplan: a #GamiDialplan
+ *
+ * Get the names of all contexts in @dialplan. The names are owned by
+ * @dialplan, the list should be freed with g_slist_free().
+ *
+ * Returns: a #GSList of context names
+ */
+GSList *
+gami_dialplan_get_contexts (GamiDialplan *dialplan)
+{
+    GHashTableIter  iter;
+    gpointer        name;
+    GSList         *contexts = NULL;
+
+    g_return_val_if_fail (dialplan != NULL, NULL);
+
+    g_hash_table_iter_init (&iter, dialplan->contexts);
+    while (g_hash_table_iter_next (&iter, &name, NULL))
+        contexts = g_slist_prepend (contexts, name);
+
+    return contexts;
+}
+
+/**
+ * gami_dialplan_match_extension:
+ * @dialplan: a #GamiDialplan
+ * @context: the context to search
+ * @extension: the dialed extension
+ *
+ * Find the extension of @dialplan that @extension would be routed to in
+ * @context. An extension of the same name takes precedence over patterns,
+ * which are tried from the most to the least specific one; included
+ * contexts are searched afterwards, in the order they were included.
+ *
+ * Returns: the name of the matching extension (e.g. "_NXX"), or %NULL
+ */
+const gchar *
+gami_dialplan_match_extension (GamiDialplan *dialplan,
+                               const gchar *context,
+                               const gchar *extension)
+{
+    DialplanExtension *match;
+
+    g_return_val_if_fail (dialplan != NULL, NULL);
+    g_return_val_if_fail (context != NULL, NULL);
+    g_return_val_if_fail (extension != NULL, NULL);
+
+    match = match_extension (dialplan, context, extension);
+
+    return match ? match->name : NULL;
+}
+
+/**
+ * gami_dialplan_lookup:
+ * @dialplan: a #GamiDialplan
+ * @context: the context to search
+ * @extension: the dialed extension
+ * @priority: the priority, or %GAMI_DIALPLAN_PRIORITY_HINT
+ *
+ * Look up the step executed at @priority when @extension is dialed in
+ * @context, see gami_dialplan_match_extension(). The result remains valid
+ * until an entry is added to @dialplan.
+ *
+ * Returns: the matching #GamiDialplanPriority, or %NULL
+ */
+const GamiDialplanPriority *
+gami_dialplan_lookup (GamiDialplan *dialplan,
+                      const gchar *context,
+                      const gchar *extension,
+                      gint priority)
+{
+    DialplanExtension *match;
+    guint              index;
+
+    g_return_val_if_fail (dialplan != NULL, NULL);
+    g_return_val_if_fail (context != NULL, NULL);
+    g_return_val_if_fail (extension != NULL, NULL);
+
+    match = match_extension (dialplan, context, extension);
+    if (! match)
+        return NULL;
+
+    index = find_priority (match, priority);
+    if (index >= match->priorities->len
+        || g_array_index (match->priorities,
+                          GamiDialplanPriority, index).priority != priority)
+        return NULL;
+
+    return &g_array_index (match->priorities, GamiDialplanPriority, index);
+}
+
+/**
+ * gami_dialplan_exists:
+ * @dialplan: a #GamiDialplan
+ * @context: the context to search
+ * @extension: the dialed extension
+ * @priority: the priority, or %GAMI_DIALPLAN_PRIORITY_HINT
+ *
+ * Check whether dialing @extension in @context at @priority would succeed,
+ * e.g. to validate the target of gami_manager_originate() locally.
+ *
+ * Returns: %TRUE if @dialplan has a matching priority
+ */
+gboolean
+gami_dialplan_exists (GamiDialplan *dialplan,
+                      const gchar *context,
+                      const gchar *extension,
+                      gint priority)
+{
+    return gami_dialplan_lookup (dialplan, context, extension, priority)
+           != NULL;
+}
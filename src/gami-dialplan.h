@@ -0,0 +1,127 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)
+#  error "Only <gami.h> can be included directly."
+#endif
+
+#ifndef __GAMI_DIALPLAN_H__
+#define __GAMI_DIALPLAN_H__
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#ifdef GAMI_COMPILATION
+#  include <gami-manager.h>
+#else
+#  include <gami/gami-manager.h>
+#endif
+
+G_BEGIN_DECLS
+
+/**
+ * GAMI_DIALPLAN_PRIORITY_HINT:
+ *
+ * Priority used for the hint of an extension
+ */
+#define GAMI_DIALPLAN_PRIORITY_HINT -1
+
+/**
+ * GamiDialplan:
+ *
+ * #GamiDialplan is an opaque, ref-counted snapshot of the dialplan, indexed
+ * by context, extension and priority.
+ */
+typedef struct _GamiDialplan GamiDialplan;
+
+/**
+ * GamiDialplanPriority:
+ * @priority: the priority, or %GAMI_DIALPLAN_PRIORITY_HINT
+ * @label: the label of the priority, or %NULL
+ * @application: the application executed at the priority
+ * @app_data: the arguments of @application, or %NULL
+ *
+ * A single step of a dialplan extension. Strings are owned by the
+ * #GamiDialplan and remain valid as long as it is alive.
+ */
+typedef struct _GamiDialplanPriority GamiDialplanPriority;
+
+struct _GamiDialplanPriority {
+	gint         priority;
+	const gchar *label;
+	const gchar *application;
+	const gchar *app_data;
+};
+
+/**
+ * GAMI_TYPE_DIALPLAN:
+ *
+ * Get the #GType of #GamiDialplan
+ *
+ * Returns: The #GType of #GamiDialplan
+ */
+#define GAMI_TYPE_DIALPLAN (gami_dialplan_get_type ())
+
+/**
+ * gami_dialplan_get_type:
+ *
+ * Get the #GType of #GamiDialplan
+ *
+ * Returns: The #GType of #GamiDialplan
+ */
+GType gami_dialplan_get_type (void) G_GNUC_CONST;
+
+GamiDialplan *gami_dialplan_new (void);
+
+GamiDialplan *gami_dialplan_ref (GamiDialplan *dialplan);
+void gami_dialplan_unref (GamiDialplan *dialplan);
+
+void gami_dialplan_add_entry (GamiDialplan *dialplan, GHashTable *entry);
+
+GamiDialplan *gami_dialplan_load (GamiManager *ami,
+                                  const gchar *context,
+                                  GError **error);
+void gami_dialplan_load_async (GamiManager *ami,
+                               const gchar *context,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data);
+GamiDialplan *gami_dialplan_load_finish (GamiManager *ami,
+                                         GAsyncResult *result,
+                                         GError **error);
+
+GSList *gami_dialplan_get_contexts (GamiDialplan *dialplan);
+
+const gchar *gami_dialplan_match_extension (GamiDialplan *dialplan,
+                                            const gchar *context,
+                                            const gchar *extension);
+const GamiDialplanPriority *gami_dialplan_lookup (GamiDialplan *dialplan,
+                                                  const gchar *context,
+                                                  const gchar *extension,
+                                                  gint priority);
+gboolean gami_dialplan_exists (GamiDialplan *dialplan,
+                               const gchar *context,
+                               const gchar *extension,
+                               gint priority);
+
+G_END_DECLS
+
+#endif /* __GAMI_DIALPLAN_H__ */
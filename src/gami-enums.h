@@ -71,6 +71,24 @@ typedef enum {
 	GAMI_MODULE_UNLOAD
 } GamiModuleLoadType;
 
+/**
+ * GamiEventPriority:
+ * @GAMI_EVENT_PRIORITY_LOW: events delivered after all other packets
+ * @GAMI_EVENT_PRIORITY_NORMAL: default priority of events
+ * @GAMI_EVENT_PRIORITY_HIGH: events delivered before other events
+ * @GAMI_EVENT_PRIORITY_RESPONSE: priority of action responses, which are
+ *                                always delivered first
+ *
+ * Priorities of the lanes used to deliver buffered packets, as set with
+ * gami_manager_set_event_priority().
+ */
+typedef enum {
+	GAMI_EVENT_PRIORITY_LOW,
+	GAMI_EVENT_PRIORITY_NORMAL,
+	GAMI_EVENT_PRIORITY_HIGH,
+	GAMI_EVENT_PRIORITY_RESPONSE
+} GamiEventPriority;
+
 /**
  * GamiLogLevelFlags:
  * @GAMI_LOG_LEVEL_NET_RX: log level for received network traffic
@@ -83,6 +101,29 @@ typedef enum {
 	GAMI_LOG_LEVEL_NET_TX = 1 << (G_LOG_LEVEL_USER_SHIFT + 1)
 } GamiLogLevelFlags;
 
+/**
+ * GamiConfigAction:
+ * @GAMI_CONFIG_NEW_CATEGORY: create a category
+ * @GAMI_CONFIG_RENAME_CATEGORY: rename a category to the value of the change
+ * @GAMI_CONFIG_DELETE_CATEGORY: delete a category
+ * @GAMI_CONFIG_EMPTY_CATEGORY: delete all lines of a category
+ * @GAMI_CONFIG_UPDATE: set the value of a variable
+ * @GAMI_CONFIG_DELETE: delete a variable
+ * @GAMI_CONFIG_APPEND: append a variable to a category
+ *
+ * The operations of a #GamiConfigChange, as performed by
+ * gami_manager_update_config()
+ */
+typedef enum {
+	GAMI_CONFIG_NEW_CATEGORY,
+	GAMI_CONFIG_RENAME_CATEGORY,
+	GAMI_CONFIG_DELETE_CATEGORY,
+	GAMI_CONFIG_EMPTY_CATEGORY,
+	GAMI_CONFIG_UPDATE,
+	GAMI_CONFIG_DELETE,
+	GAMI_CONFIG_APPEND
+} GamiConfigAction;
+
 /**
  * gami_module_load_type_get_type:
  *
@@ -0,0 +1,37 @@
+#ifndef __GAMI_EVENT_PRIVATE_H__
+#define __GAMI_EVENT_PRIVATE_H__
+
+#include <glib.h>
+#include <gami-event.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+    GAMI_EVENT_FIELD_STRING,
+    GAMI_EVENT_FIELD_INT,
+    GAMI_EVENT_FIELD_UINT,
+    GAMI_EVENT_FIELD_DOUBLE,
+    GAMI_EVENT_FIELD_BOOLEAN,
+    GAMI_EVENT_FIELD_DATETIME
+} GamiEventFieldType;
+
+/* a header decoded into a member of a typed event */
+typedef struct {
+    const gchar        *header;
+    GamiEventFieldType  type;
+    glong               offset;
+} GamiEventField;
+
+typedef struct {
+    GamiEventType         type;
+    const gchar          *name;
+    gsize                 size;
+    const GamiEventField *fields;
+} GamiEventInfo;
+
+/* generated from gami-events.schema, terminated by GAMI_EVENT_TYPE_UNKNOWN */
+extern const GamiEventInfo gami_event_info [];
+
+G_END_DECLS
+
+#endif /* __GAMI_EVENT_PRIVATE_H__ */
@@ -0,0 +1,211 @@
+# Generate the typed event structures from gami-events.schema
+#
+# Usage: awk -v mode=<mode> -f gami-event-types.awk gami-events.schema
+#
+# mode is one of
+#   enum     - GamiEventType enumeration (gami-event-types.h)
+#   structs  - typed event structures (gami-event-structs.h)
+#   source   - field tables used for decoding (gami-event-types.c)
+
+function camel_to_upper (name,    result, i, c, prev)
+{
+    result = ""
+    prev = ""
+    for (i = 1; i <= length (name); i++) {
+        c = substr (name, i, 1)
+        if (c ~ /[A-Z]/ && prev ~ /[a-z]/)
+            result = result "_"
+        result = result toupper (c)
+        prev = c
+    }
+    return result
+}
+
+function rest_of_line (first,    i, result)
+{
+    result = ""
+    for (i = first; i <= NF; i++)
+        result = result (i > first ? " " : "") $i
+    return result
+}
+
+function ctype (type)
+{
+    if (type == "string")   return "const gchar  *"
+    if (type == "int")      return "gint          "
+    if (type == "uint")     return "guint         "
+    if (type == "double")   return "gdouble       "
+    if (type == "boolean")  return "gboolean      "
+    if (type == "datetime") return "gint64        "
+    printf ("%s:%d: unknown field type '%s'\n", FILENAME, FNR, type) > "/dev/stderr"
+    failed = 1
+    exit 1
+}
+
+BEGIN {
+    n_events = 0
+}
+
+/^[ \t]*(#|$)/ {
+    next
+}
+
+$1 == "event" {
+    n_events++
+    event_name [n_events] = $2
+    event_desc [n_events] = rest_of_line(3)
+    n_fields [n_events] = 0
+    next
+}
+
+{
+    if (! n_events) {
+        printf ("%s:%d: field outside of event\n", FILENAME, FNR) > "/dev/stderr"
+        failed = 1
+        exit 1
+    }
+    ctype($1)
+    i = ++n_fields [n_events]
+    field_type [n_events, i] = $1
+    field_name [n_events, i] = $2
+    field_header [n_events, i] = $3
+    field_desc [n_events, i] = rest_of_line(4)
+}
+
+function emit_preamble ()
+{
+    print "/* Generated by gami-event-types.awk from gami-events.schema."
+    print " * Do not edit, changes will be lost. */"
+    print ""
+}
+
+function emit_enum (    e)
+{
+    emit_preamble()
+    print "#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)"
+    print "#  error \"Only <gami.h> can be included directly.\""
+    print "#endif"
+    print ""
+    print "#ifndef __GAMI_EVENT_TYPES_H__"
+    print "#define __GAMI_EVENT_TYPES_H__"
+    print ""
+    print "#include <glib.h>"
+    print ""
+    print "G_BEGIN_DECLS"
+    print ""
+    print "/**"
+    print " * GamiEventType:"
+    print " * @GAMI_EVENT_TYPE_UNKNOWN: an event without typed representation"
+    for (e = 1; e <= n_events; e++)
+        printf (" * @GAMI_EVENT_TYPE_%s: %s, see #Gami%sEvent\n",
+                camel_to_upper(event_name [e]), event_desc [e],
+                event_name [e])
+    print " *"
+    print " * Types of events which are decoded into typed structures."
+    print " */"
+    print "typedef enum"
+    print "{"
+    print "\tGAMI_EVENT_TYPE_UNKNOWN,"
+    for (e = 1; e <= n_events; e++)
+        printf ("\tGAMI_EVENT_TYPE_%s%s\n", camel_to_upper(event_name [e]),
+                e < n_events ? "," : "")
+    print "} GamiEventType;"
+    print ""
+    print "G_END_DECLS"
+    print ""
+    print "#endif /* __GAMI_EVENT_TYPES_H__ */"
+}
+
+function emit_structs (    e, f)
+{
+    emit_preamble()
+    print "#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)"
+    print "#  error \"Only <gami.h> can be included directly.\""
+    print "#endif"
+    print ""
+    print "#ifndef __GAMI_EVENT_STRUCTS_H__"
+    print "#define __GAMI_EVENT_STRUCTS_H__"
+    print ""
+    print "G_BEGIN_DECLS"
+    for (e = 1; e <= n_events; e++) {
+        print ""
+        print "/**"
+        printf (" * Gami%sEvent:\n", event_name [e])
+        print " * @parent: the generic #GamiEvent"
+        for (f = 1; f <= n_fields [e]; f++)
+            printf (" * @%s: %s (%s header)\n", field_name [e, f],
+                    field_desc [e, f], field_header [e, f])
+        print " *"
+        printf (" * Typed representation of the %s event. %s.\n",
+                event_name [e], event_desc [e])
+        print " */"
+        printf ("typedef struct _Gami%sEvent Gami%sEvent;\n",
+                event_name [e], event_name [e])
+        print ""
+        printf ("struct _Gami%sEvent {\n", event_name [e])
+        print "\tGamiEvent      parent;"
+        print ""
+        for (f = 1; f <= n_fields [e]; f++)
+            printf ("\t%s%s;\n", ctype(field_type [e, f]), field_name [e, f])
+        print "};"
+        print ""
+        print "/**"
+        printf (" * GAMI_%s_EVENT:\n", camel_to_upper(event_name [e]))
+        print " * @event: a #GamiEvent"
+        print " *"
+        printf (" * Cast @event to #Gami%sEvent. @event must be of type\n",
+                event_name [e])
+        printf (" * %%GAMI_EVENT_TYPE_%s.\n", camel_to_upper(event_name [e]))
+        print " */"
+        printf ("#define GAMI_%s_EVENT(event) ((Gami%sEvent *) (event))\n",
+                camel_to_upper(event_name [e]), event_name [e])
+    }
+    print ""
+    print "G_END_DECLS"
+    print ""
+    print "#endif /* __GAMI_EVENT_STRUCTS_H__ */"
+}
+
+function emit_source (    e, f, prefix)
+{
+    emit_preamble()
+    print "#include <gami-event.h>"
+    print "#include <gami-event-private.h>"
+    for (e = 1; e <= n_events; e++) {
+        prefix = tolower(camel_to_upper(event_name [e]))
+        print ""
+        printf ("static const GamiEventField %s_fields [] = {\n", prefix)
+        for (f = 1; f <= n_fields [e]; f++)
+            printf ("    { \"%s\", GAMI_EVENT_FIELD_%s,\n      G_STRUCT_OFFSET (Gami%sEvent, %s) },\n",
+                    field_header [e, f], toupper(field_type [e, f]),
+                    event_name [e], field_name [e, f])
+        print "    { NULL, 0, 0 }"
+        print "};"
+    }
+    print ""
+    print "const GamiEventInfo gami_event_info [] = {"
+    for (e = 1; e <= n_events; e++) {
+        prefix = tolower(camel_to_upper(event_name [e]))
+        printf ("    { GAMI_EVENT_TYPE_%s, \"%s\",\n      sizeof (Gami%sEvent), %s_fields },\n",
+                camel_to_upper(event_name [e]), event_name [e],
+                event_name [e], prefix)
+    }
+    print "    { GAMI_EVENT_TYPE_UNKNOWN, NULL, sizeof (GamiEvent), NULL }"
+    print "};"
+}
+
+END {
+    if (failed)
+        exit 1
+
+    if (mode == "enum")
+        emit_enum()
+    else if (mode == "structs")
+        emit_structs()
+    else if (mode == "source")
+        emit_source()
+    else {
+        print "gami-event-types.awk: unknown mode '" mode "'" > "/dev/stderr"
+        exit 1
+    }
+}
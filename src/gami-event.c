@@ -0,0 +1,309 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <gami-event.h>
+#include <gami-event-private.h>
+
+/**
+ * SECTION: libgami-event
+ * @short_description: Typed representation of events
+ * @title: GamiEvent
+ * @stability: Unstable
+ *
+ * Events of high volume are decoded once into typed structures with
+ * pre-parsed numeric fields, which are passed to the
+ * #GamiManager::typed-event signal. The set of typed events is generated
+ * from the gami-events.schema file at build time; all other events are
+ * represented by a generic #GamiEvent.
+ */
+
+static const GamiEventInfo *
+lookup_event_info (const gchar *name)
+{
+    static GHashTable *infos = NULL;
+    const GamiEventInfo *info;
+
+    if (g_once_init_enter ((gsize *) &infos)) {
+        GHashTable *table;
+
+        table = g_hash_table_new (g_str_hash, g_str_equal);
+        for (info = gami_event_info; info->name; info++)
+            g_hash_table_insert (table, (gpointer) info->name, (gpointer) info);
+
+        g_once_init_leave ((gsize *) &infos, (gsize) table);
+    }
+
+    if (name && (info = g_hash_table_lookup (infos, name)))
+        return info;
+
+    /* the terminating entry describes the generic event */
+    for (info = gami_event_info; info->name; info++);
+    return info;
+}
+
+static gboolean
+parse_boolean (const gchar *value)
+{
+    return ! g_ascii_strcasecmp (value, "yes")
+           || ! g_ascii_strcasecmp (value, "true")
+           || ! g_ascii_strcasecmp (value, "on")
+           || ! strcmp (value, "1");
+}
+
+/* parse "YYYY-MM-DD HH:MM:SS" in local time as used by Asterisk for CDRs */
+static gint64
+parse_datetime (const gchar *value)
+{
+    struct tm tm;
+
+    memset (&tm, 0, sizeof (tm));
+    if (sscanf (value, "%d-%d-%d %d:%d:%d",
+                &tm.tm_year, &tm.tm_mon, &tm.tm_mday,
+                &tm.tm_hour, &tm.tm_min, &tm.tm_sec) != 6)
+        return 0;
+
+    tm.tm_year -= 1900;
+    tm.tm_mon  -= 1;
+    tm.tm_isdst = -1;
+
+    return (gint64) mktime (&tm);
+}
+
+static void
+decode_field (GamiEvent *event, const GamiEventField *field)
+{
+    const gchar *value;
+    gpointer     member;
+
+    value = g_hash_table_lookup (event->headers, field->header);
+    if (! value)
+        return;
+
+    member = G_STRUCT_MEMBER_P (event, field->offset);
+
+    switch (field->type) {
+        case GAMI_EVENT_FIELD_STRING:
+            *(const gchar **) member = value;
+            break;
+        case GAMI_EVENT_FIELD_INT:
+            *(gint *) member = (gint) strtol (value, NULL, 10);
+            break;
+        case GAMI_EVENT_FIELD_UINT:
+            *(guint *) member = (guint) strtoul (value, NULL, 10);
+            break;
+        case GAMI_EVENT_FIELD_DOUBLE:
+            *(gdouble *) member = g_ascii_strtod (value, NULL);
+            break;
+        case GAMI_EVENT_FIELD_BOOLEAN:
+            *(gboolean *) member = parse_boolean (value);
+            break;
+        case GAMI_EVENT_FIELD_DATETIME:
+            *(gint64 *) member = parse_datetime (value);
+            break;
+    }
+}
+
+static gpointer
+event_copy (gpointer boxed)
+{
+    return gami_event_ref (boxed);
+}
+
+static void
+event_free (gpointer boxed)
+{
+    gami_event_unref (boxed);
+}
+
+GType
+gami_event_get_type (void)
+{
+    static GType type_id = 0;
+    if (! type_id)
+        type_id = g_boxed_type_register_static (g_intern_static_string
+                                                ("GamiEvent"),
+                                                event_copy,
+                                                event_free);
+    return type_id;
+}
+
+/**
+ * gami_event_new:
+ * @headers: a #GHashTable holding the headers of an event
+ *
+ * Decode the event represented by @headers. If the event is of a known
+ * #GamiEventType, the typed structure is allocated and its members are
+ * filled from @headers.
+ *
+ * Returns: a new #GamiEvent
+ */
+GamiEvent *
+gami_event_new (GHashTable *headers)
+{
+    const GamiEventInfo  *info;
+    const GamiEventField *field;
+    GamiEvent            *event;
+    const gchar          *timestamp;
+
+    g_return_val_if_fail (headers != NULL, NULL);
+
+    info = lookup_event_info (g_hash_table_lookup (headers, "Event"));
+
+    event = g_malloc0 (info->size);
+    event->type      = info->type;
+    event->headers   = g_hash_table_ref (headers);
+    event->ref_count = 1;
+
+    timestamp = g_hash_table_lookup (headers, "Timestamp");
+    if (timestamp)
+        event->timestamp = g_ascii_strtod (timestamp, NULL);
+
+    for (field = info->fields; field && field->header; field++)
+        decode_field (event, field);
+
+    return event;
+}
+
+/**
+ * gami_event_ref:
+ * @event: a #GamiEvent
+ *
+ * Increase the reference count of @event.
+ *
+ * Returns: a reference to @event
+ */
+GamiEvent *
+gami_event_ref (GamiEvent *event)
+{
+    g_return_val_if_fail (event != NULL, NULL);
+    g_return_val_if_fail (event->ref_count > 0, event);
+
+    g_atomic_int_add (&event->ref_count, 1);
+    return event;
+}
+
+/**
+ * gami_event_unref:
+ * @event: a #GamiEvent
+ *
+ * Decrease the reference count of @event. If the reference count drops to 0,
+ * all memory allocated for @event is freed
+ */
+void
+gami_event_unref (GamiEvent *event)
+{
+    g_return_if_fail (event != NULL);
+    g_return_if_fail (event->ref_count > 0);
+
+    if (g_atomic_int_exchange_and_add (&event->ref_count, -1) - 1 == 0) {
+        g_hash_table_unref (event->headers);
+        g_free (event);
+    }
+}
+
+/**
+ * gami_event_get_event_type:
+ * @event: a #GamiEvent
+ *
+ * Get the type of @event.
+ *
+ * Returns: the #GamiEventType of @event
+ */
+GamiEventType
+gami_event_get_event_type (GamiEvent *event)
+{
+    g_return_val_if_fail (event != NULL, GAMI_EVENT_TYPE_UNKNOWN);
+
+    return event->type;
+}
+
+/**
+ * gami_event_get_name:
+ * @event: a #GamiEvent
+ *
+ * Get the name of @event as sent by the server.
+ *
+ * Returns: the value of the Event header of @event
+ */
+const gchar *
+gami_event_get_name (GamiEvent *event)
+{
+    g_return_val_if_fail (event != NULL, NULL);
+
+    return g_hash_table_lookup (event->headers, "Event");
+}
+
+/**
+ * gami_event_get_header:
+ * @event: a #GamiEvent
+ * @header: the name of a header
+ *
+ * Look up the value of @header in @event. The returned string is owned by
+ * @event and must not be freed.
+ *
+ * Returns: the value of @header, or %NULL if @event has no such header
+ */
+const gchar *
+gami_event_get_header (GamiEvent *event, const gchar *header)
+{
+    g_return_val_if_fail (event != NULL, NULL);
+    g_return_val_if_fail (header != NULL, NULL);
+
+    return g_hash_table_lookup (event->headers, header);
+}
+
+/**
+ * gami_event_get_headers:
+ * @event: a #GamiEvent
+ *
+ * Get the generic header view of @event. The returned table is owned by
+ * @event and must not be modified.
+ *
+ * Returns: a #GHashTable mapping header names to values
+ */
+GHashTable *
+gami_event_get_headers (GamiEvent *event)
+{
+    g_return_val_if_fail (event != NULL, NULL);
+
+    return event->headers;
+}
+
+/**
+ * gami_event_type_from_name:
+ * @name: the name of an event
+ *
+ * Get the #GamiEventType of events named @name.
+ *
+ * Returns: the #GamiEventType for @name, or %GAMI_EVENT_TYPE_UNKNOWN
+ */
+GamiEventType
+gami_event_type_from_name (const gchar *name)
+{
+    g_return_val_if_fail (name != NULL, GAMI_EVENT_TYPE_UNKNOWN);
+
+    return lookup_event_info (name)->type;
+}
@@ -0,0 +1,95 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)
+#  error "Only <gami.h> can be included directly."
+#endif
+
+#ifndef __GAMI_EVENT_H__
+#define __GAMI_EVENT_H__
+
+#include <glib-object.h>
+#include <gami-event-types.h>
+
+G_BEGIN_DECLS
+
+/**
+ * GamiEvent:
+ * @type: the #GamiEventType of the event
+ * @headers: all headers of the event
+ * @timestamp: value of the Timestamp header, or 0 if the server does not
+ *             send timestamps
+ *
+ * #GamiEvent is a ref-counted, decoded representation of an event. Events
+ * of a known #GamiEventType are allocated as the corresponding typed
+ * structure (e.g. #GamiHangupEvent), which has the #GamiEvent as first
+ * member, so that it can be cast using e.g. GAMI_HANGUP_EVENT(). Other events
+ * only provide the generic header view.
+ *
+ * String members of typed events point into @headers and remain valid as
+ * long as the event is alive.
+ */
+typedef struct _GamiEvent GamiEvent;
+
+struct _GamiEvent {
+	GamiEventType  type;
+	GHashTable    *headers;
+	gdouble        timestamp;
+
+	/*< private >*/
+	volatile gint  ref_count;
+};
+
+/**
+ * GAMI_TYPE_EVENT:
+ *
+ * Get the #GType of #GamiEvent
+ *
+ * Returns: The #GType of #GamiEvent
+ */
+#define GAMI_TYPE_EVENT (gami_event_get_type ())
+
+/**
+ * gami_event_get_type:
+ *
+ * Get the #GType of #GamiEvent
+ *
+ * Returns: The #GType of #GamiEvent
+ */
+GType gami_event_get_type (void) G_GNUC_CONST;
+
+GamiEvent *gami_event_new (GHashTable *headers);
+
+GamiEvent *gami_event_ref (GamiEvent *event);
+void gami_event_unref (GamiEvent *event);
+
+GamiEventType gami_event_get_event_type (GamiEvent *event);
+const gchar *gami_event_get_name (GamiEvent *event);
+const gchar *gami_event_get_header (GamiEvent *event, const gchar *header);
+GHashTable *gami_event_get_headers (GamiEvent *event);
+
+GamiEventType gami_event_type_from_name (const gchar *name);
+
+G_END_DECLS
+
+#include <gami-event-structs.h>
+
+#endif /* __GAMI_EVENT_H__ */
@@ -0,0 +1,900 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gami-extension-cache.h>
+#include <gami-event.h>
+
+/**
+ * SECTION: libgami-extension-cache
+ * @short_description: Local copy of extension states
+ * @title: GamiExtensionCache
+ * @stability: Unstable
+ *
+ * #GamiExtensionCache keeps the state of a set of watched extensions, as used
+ * for busy lamp fields. The initial state of watched extensions is queried
+ * using pipelined ExtensionState actions, with at most
+ * #GamiExtensionCache:max-in-flight queries outstanding at a time; afterwards
+ * the state is updated from ExtensionStatus events.
+ *
+ * Extensions are represented by a #GHashTable with the headers Exten,
+ * Context, Hint and Status as in the ExtensionStatus event. Clients may
+ * subscribe to changes of individual extensions with
+ * gami_extension_cache_subscribe(), or to all extensions whose hint matches
+ * a pattern with gami_extension_cache_subscribe_hint().
+ *
+ * The manager must be logged in with a mask which includes
+ * %GAMI_EVENT_MASK_CALL for the cache to receive updates.
+ */
+
+enum {
+    PROP_0,
+    PROP_MANAGER,
+    PROP_MAX_IN_FLIGHT
+};
+
+enum {
+    EXTENSION_CHANGED,
+    LAST_SIGNAL
+};
+
+typedef struct {
+    guint                   id;
+    gchar                  *key;        /* exten@context, or NULL */
+    GPatternSpec           *pattern;    /* hint pattern, or NULL */
+    GamiExtensionStateFunc  func;
+    gpointer                user_data;
+    GDestroyNotify          notify;
+} Subscription;
+
+struct _GamiExtensionCachePrivate {
+    GamiManager *ami;
+
+    GHashTable  *extensions;        /* exten@context -> extension */
+
+    GQueue      *pending;           /* keys waiting to be queried */
+    GHashTable  *queued;            /* keys in pending or in flight */
+    GHashTable  *updated;           /* keys updated by events in flight */
+    guint        in_flight;
+    guint        max_in_flight;
+    guint        serial;
+    GSList      *waiters;           /* refresh operations */
+
+    GHashTable  *subscriptions;     /* exten@context -> GSList of subs */
+    GSList      *hint_subscriptions;
+    guint        last_subscription;
+
+    GSList      *handlers;
+};
+
+typedef struct {
+    GamiExtensionCache *cache;
+    gchar              *key;
+} Query;
+
+static guint signals [LAST_SIGNAL] = { 0 };
+
+#define GAMI_EXTENSION_CACHE_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), \
+                                             GAMI_TYPE_EXTENSION_CACHE, \
+                                             GamiExtensionCachePrivate))
+
+G_DEFINE_TYPE (GamiExtensionCache, gami_extension_cache, G_TYPE_OBJECT);
+
+static void query_pending (GamiExtensionCache *cache);
+
+static gchar *
+extension_key (const gchar *exten, const gchar *context)
+{
+    return g_strdup_printf ("%s@%s", exten, context);
+}
+
+static void
+set_header (GHashTable *extension, const gchar *header, const gchar *value)
+{
+    if (value)
+        g_hash_table_insert (extension, g_strdup (header), g_strdup (value));
+}
+
+static void
+subscription_free (Subscription *sub)
+{
+    if (sub->notify)
+        sub->notify (sub->user_data);
+    if (sub->pattern)
+        g_pattern_spec_free (sub->pattern);
+    g_free (sub->key);
+    g_free (sub);
+}
+
+static void
+notify_subscribers (GamiExtensionCache *cache,
+                    const gchar *key,
+                    GHashTable *extension)
+{
+    GSList      *sub;
+    const gchar *hint;
+
+    for (sub = g_hash_table_lookup (cache->priv->subscriptions, key);
+         sub; sub = sub->next) {
+        Subscription *s = sub->data;
+        s->func (cache, extension, s->user_data);
+    }
+
+    hint = g_hash_table_lookup (extension, "Hint");
+    if (! hint)
+        return;
+
+    for (sub = cache->priv->hint_subscriptions; sub; sub = sub->next) {
+        Subscription *s = sub->data;
+
+        if (g_pattern_match_string (s->pattern, hint))
+            s->func (cache, extension, s->user_data);
+    }
+}
+
+/* update a watched extension and notify about changes of its state */
+static void
+update_extension (GamiExtensionCache *cache,
+                  const gchar *key,
+                  GHashTable *headers)
+{
+    GHashTable  *extension;
+    const gchar *old_status, *old_hint, *status, *hint;
+
+    extension = g_hash_table_lookup (cache->priv->extensions, key);
+    if (! extension)
+        return;
+
+    old_status = g_hash_table_lookup (extension, "Status");
+    old_hint   = g_hash_table_lookup (extension, "Hint");
+    status     = g_hash_table_lookup (headers, "Status");
+    hint       = g_hash_table_lookup (headers, "Hint");
+
+    if (! g_strcmp0 (old_status, status)
+        && (! hint || ! g_strcmp0 (old_hint, hint)))
+        return;
+
+    set_header (extension, "Status", status);
+    set_header (extension, "Hint", hint);
+
+    g_signal_emit (cache, signals [EXTENSION_CHANGED],
+                   g_quark_from_string (key), extension);
+    notify_subscribers (cache, key, extension);
+}
+
+static void
+on_extension_status (GamiManager *ami,
+                     GamiEvent *event,
+                     GamiExtensionCache *cache)
+{
+    const gchar *exten, *context;
+    gchar       *key;
+
+    exten   = gami_event_get_header (event, "Exten");
+    context = gami_event_get_header (event, "Context");
+    if (! exten || ! context)
+        return;
+
+    key = extension_key (exten, context);
+
+    /* the response of a query in flight is older than this event */
+    if (g_hash_table_lookup (cache->priv->queued, key))
+        g_hash_table_replace (cache->priv->updated, g_strdup (key),
+                              GINT_TO_POINTER (TRUE));
+
+    update_extension (cache, key, event->headers);
+    g_free (key);
+}
+
+static void
+complete_waiters (GamiExtensionCache *cache)
+{
+    GSList *waiters, *waiter;
+
+    if (cache->priv->in_flight || cache->priv->pending->length)
+        return;
+
+    waiters = cache->priv->waiters;
+    cache->priv->waiters = NULL;
+
+    for (waiter = waiters; waiter; waiter = waiter->next) {
+        GSimpleAsyncResult *simple = waiter->data;
+
+        g_simple_async_result_set_op_res_gboolean (simple, TRUE);
+        g_simple_async_result_complete_in_idle (simple);
+        g_object_unref (simple);
+    }
+    g_slist_free (waiters);
+}
+
+static void
+query_cb (GamiManager *ami, GAsyncResult *result, Query *query)
+{
+    GamiExtensionCache *cache = query->cache;
+    GHashTable         *response;
+    GError             *error = NULL;
+
+    response = gami_manager_extension_state_finish (ami, result, &error);
+
+    if (error) {
+        g_warning ("Failed to query state of extension %s: %s",
+                   query->key, error->message);
+        g_error_free (error);
+    } else if (! g_hash_table_lookup (cache->priv->updated, query->key))
+        update_extension (cache, query->key, response);
+
+    g_hash_table_remove (cache->priv->updated, query->key);
+    g_hash_table_remove (cache->priv->queued, query->key);
+
+    cache->priv->in_flight--;
+    query_pending (cache);
+    complete_waiters (cache);
+
+    g_free (query->key);
+    g_object_unref (query->cache);
+    g_free (query);
+}
+
+/* keep up to max_in_flight ExtensionState queries outstanding */
+static void
+query_pending (GamiExtensionCache *cache)
+{
+    GamiExtensionCachePrivate *priv = cache->priv;
+
+    while (priv->in_flight < MAX (priv->max_in_flight, 1)
+           && priv->pending->length) {
+        GHashTable *extension;
+        Query      *query;
+        gchar      *key, *action_id;
+
+        key = g_queue_pop_head (priv->pending);
+
+        /* unwatched while waiting */
+        extension = g_hash_table_lookup (priv->extensions, key);
+        if (! extension) {
+            g_hash_table_remove (priv->queued, key);
+            g_free (key);
+            continue;
+        }
+
+        action_id = g_strdup_printf ("GamiExtensionCache-%p-%u",
+                                     cache, ++priv->serial);
+
+        query = g_new (Query, 1);
+        query->cache = g_object_ref (cache);
+        query->key   = key;
+
+        priv->in_flight++;
+        gami_manager_extension_state_async (priv->ami,
+                                            g_hash_table_lookup (extension,
+                                                                 "Exten"),
+                                            g_hash_table_lookup (extension,
+                                                                 "Context"),
+                                            action_id,
+                                            (GAsyncReadyCallback) query_cb,
+                                            query);
+        g_free (action_id);
+    }
+}
+
+static void
+queue_query (GamiExtensionCache *cache, const gchar *key)
+{
+    if (g_hash_table_lookup (cache->priv->queued, key))
+        return;
+
+    g_hash_table_insert (cache->priv->queued, g_strdup (key),
+                         GINT_TO_POINTER (TRUE));
+    g_queue_push_tail (cache->priv->pending, g_strdup (key));
+}
+
+static void
+store_result (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    *(GAsyncResult **) user_data = g_object_ref (result);
+}
+
+static void
+connect_event (GamiExtensionCache *cache,
+               const gchar *signal,
+               GCallback func)
+{
+    gulong id;
+
+    id = g_signal_connect (cache->priv->ami, signal, func, cache);
+    cache->priv->handlers = g_slist_prepend (cache->priv->handlers,
+                                             GSIZE_TO_POINTER (id));
+}
+
+/**
+ * gami_extension_cache_new:
+ * @ami: a #GamiManager
+ *
+ * Create a new extension state cache for the server @ami is connected to.
+ *
+ * Returns: a new #GamiExtensionCache
+ */
+GamiExtensionCache *
+gami_extension_cache_new (GamiManager *ami)
+{
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), NULL);
+
+    return g_object_new (GAMI_TYPE_EXTENSION_CACHE, "manager", ami, NULL);
+}
+
+/**
+ * gami_extension_cache_watch:
+ * @cache: #GamiExtensionCache
+ * @exten: extension to watch
+ * @context: context of @exten
+ *
+ * Add @exten in @context to the extensions held by @cache. Its state is
+ * queried in the background; use gami_extension_cache_refresh() to wait for
+ * all outstanding queries.
+ */
+void
+gami_extension_cache_watch (GamiExtensionCache *cache,
+                            const gchar *exten,
+                            const gchar *context)
+{
+    GHashTable *extension;
+    gchar      *key;
+
+    g_return_if_fail (GAMI_IS_EXTENSION_CACHE (cache));
+    g_return_if_fail (exten != NULL && context != NULL);
+
+    key = extension_key (exten, context);
+
+    if (! g_hash_table_lookup (cache->priv->extensions, key)) {
+        extension = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                           g_free, g_free);
+        set_header (extension, "Exten", exten);
+        set_header (extension, "Context", context);
+        g_hash_table_insert (cache->priv->extensions, g_strdup (key),
+                             extension);
+
+        queue_query (cache, key);
+        query_pending (cache);
+    }
+
+    g_free (key);
+}
+
+/**
+ * gami_extension_cache_unwatch:
+ * @cache: #GamiExtensionCache
+ * @exten: a watched extension
+ * @context: context of @exten
+ *
+ * Remove @exten in @context from the extensions held by @cache.
+ */
+void
+gami_extension_cache_unwatch (GamiExtensionCache *cache,
+                              const gchar *exten,
+                              const gchar *context)
+{
+    gchar *key;
+
+    g_return_if_fail (GAMI_IS_EXTENSION_CACHE (cache));
+    g_return_if_fail (exten != NULL && context != NULL);
+
+    key = extension_key (exten, context);
+    g_hash_table_remove (cache->priv->extensions, key);
+    g_free (key);
+}
+
+/**
+ * gami_extension_cache_refresh:
+ * @cache: #GamiExtensionCache
+ * @error: a #GError, or %NULL
+ *
+ * Query the state of all watched extensions again, and wait until all
+ * queries have been answered.
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_extension_cache_refresh (GamiExtensionCache *cache, GError **error)
+{
+    GAsyncResult *result = NULL;
+    gboolean      success;
+
+    gami_extension_cache_refresh_async (cache, store_result, &result);
+
+    while (! result)
+        g_main_context_iteration (NULL, TRUE);
+
+    success = gami_extension_cache_refresh_finish (cache, result, error);
+    g_object_unref (result);
+
+    return success;
+}
+
+/**
+ * gami_extension_cache_refresh_async:
+ * @cache: #GamiExtensionCache
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Asynchronously query the state of all watched extensions again, see
+ * gami_extension_cache_refresh().
+ */
+void
+gami_extension_cache_refresh_async (GamiExtensionCache *cache,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data)
+{
+    GSimpleAsyncResult *simple;
+    GHashTableIter      iter;
+    gchar              *key;
+
+    g_return_if_fail (GAMI_IS_EXTENSION_CACHE (cache));
+
+    simple = g_simple_async_result_new (G_OBJECT (cache),
+                                        callback,
+                                        user_data,
+                                        gami_extension_cache_refresh_async);
+    cache->priv->waiters = g_slist_prepend (cache->priv->waiters, simple);
+
+    g_hash_table_iter_init (&iter, cache->priv->extensions);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &key, NULL))
+        queue_query (cache, key);
+
+    query_pending (cache);
+    complete_waiters (cache);
+}
+
+/**
+ * gami_extension_cache_refresh_finish:
+ * @cache: #GamiExtensionCache
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous operation started with
+ * gami_extension_cache_refresh_async()
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_extension_cache_refresh_finish (GamiExtensionCache *cache,
+                                     GAsyncResult *result,
+                                     GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_EXTENSION_CACHE (cache), FALSE);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+
+    g_warn_if_fail (g_simple_async_result_get_source_tag (simple)
+                    == gami_extension_cache_refresh_async);
+
+    if (g_simple_async_result_propagate_error (simple, error))
+        return FALSE;
+
+    return g_simple_async_result_get_op_res_gboolean (simple);
+}
+
+/**
+ * gami_extension_cache_lookup:
+ * @cache: #GamiExtensionCache
+ * @exten: a watched extension
+ * @context: context of @exten
+ *
+ * Look up the state of @exten in @context. The returned table is owned by
+ * @cache and must not be modified.
+ *
+ * Returns: the extension (stored as #GHashTable), or %NULL if it is not
+ *          watched
+ */
+GHashTable *
+gami_extension_cache_lookup (GamiExtensionCache *cache,
+                             const gchar *exten,
+                             const gchar *context)
+{
+    GHashTable *extension;
+    gchar      *key;
+
+    g_return_val_if_fail (GAMI_IS_EXTENSION_CACHE (cache), NULL);
+    g_return_val_if_fail (exten != NULL && context != NULL, NULL);
+
+    key = extension_key (exten, context);
+    extension = g_hash_table_lookup (cache->priv->extensions, key);
+    g_free (key);
+
+    return extension;
+}
+
+/**
+ * gami_extension_cache_get_state:
+ * @cache: #GamiExtensionCache
+ * @exten: a watched extension
+ * @context: context of @exten
+ *
+ * Get the numeric state of @exten in @context, as in the Status header of
+ * ExtensionStatus events.
+ *
+ * Returns: the state of @exten, or -1 if it is unknown
+ */
+gint
+gami_extension_cache_get_state (GamiExtensionCache *cache,
+                                const gchar *exten,
+                                const gchar *context)
+{
+    GHashTable  *extension;
+    const gchar *status;
+
+    extension = gami_extension_cache_lookup (cache, exten, context);
+    if (! extension)
+        return -1;
+
+    status = g_hash_table_lookup (extension, "Status");
+    return status ? atoi (status) : -1;
+}
+
+/**
+ * gami_extension_cache_get_extensions:
+ * @cache: #GamiExtensionCache
+ *
+ * Get all watched extensions. The list must be freed with g_list_free(), the
+ * extensions are owned by @cache.
+ *
+ * Returns: #GList of extensions (stored as #GHashTable)
+ */
+GList *
+gami_extension_cache_get_extensions (GamiExtensionCache *cache)
+{
+    g_return_val_if_fail (GAMI_IS_EXTENSION_CACHE (cache), NULL);
+
+    return g_hash_table_get_values (cache->priv->extensions);
+}
+
+/**
+ * gami_extension_cache_subscribe:
+ * @cache: #GamiExtensionCache
+ * @exten: an extension
+ * @context: context of @exten
+ * @func: function to call when the state of @exten changed
+ * @user_data: user data to pass to @func
+ * @notify: function to free @user_data, or %NULL
+ *
+ * Subscribe to state changes of @exten in @context. The extension is watched
+ * if it is not already.
+ *
+ * Returns: the ID of the subscription
+ */
+guint
+gami_extension_cache_subscribe (GamiExtensionCache *cache,
+                                const gchar *exten,
+                                const gchar *context,
+                                GamiExtensionStateFunc func,
+                                gpointer user_data,
+                                GDestroyNotify notify)
+{
+    Subscription *sub;
+    GSList       *subs;
+
+    g_return_val_if_fail (GAMI_IS_EXTENSION_CACHE (cache), 0);
+    g_return_val_if_fail (exten != NULL && context != NULL, 0);
+    g_return_val_if_fail (func != NULL, 0);
+
+    gami_extension_cache_watch (cache, exten, context);
+
+    sub = g_new0 (Subscription, 1);
+    sub->id        = ++cache->priv->last_subscription;
+    sub->key       = extension_key (exten, context);
+    sub->func      = func;
+    sub->user_data = user_data;
+    sub->notify    = notify;
+
+    subs = g_hash_table_lookup (cache->priv->subscriptions, sub->key);
+    g_hash_table_replace (cache->priv->subscriptions, g_strdup (sub->key),
+                          g_slist_append (subs, sub));
+
+    return sub->id;
+}
+
+/**
+ * gami_extension_cache_subscribe_hint:
+ * @cache: #GamiExtensionCache
+ * @pattern: a glob-style pattern (see #GPatternSpec), e.g. "SIP/10*"
+ * @func: function to call when the state of a matching extension changed
+ * @user_data: user data to pass to @func
+ * @notify: function to free @user_data, or %NULL
+ *
+ * Subscribe to state changes of all watched extensions whose hint matches
+ * @pattern.
+ *
+ * Returns: the ID of the subscription
+ */
+guint
+gami_extension_cache_subscribe_hint (GamiExtensionCache *cache,
+                                     const gchar *pattern,
+                                     GamiExtensionStateFunc func,
+                                     gpointer user_data,
+                                     GDestroyNotify notify)
+{
+    Subscription *sub;
+
+    g_return_val_if_fail (GAMI_IS_EXTENSION_CACHE (cache), 0);
+    g_return_val_if_fail (pattern != NULL, 0);
+    g_return_val_if_fail (func != NULL, 0);
+
+    sub = g_new0 (Subscription, 1);
+    sub->id        = ++cache->priv->last_subscription;
+    sub->pattern   = g_pattern_spec_new (pattern);
+    sub->func      = func;
+    sub->user_data = user_data;
+    sub->notify    = notify;
+
+    cache->priv->hint_subscriptions =
+        g_slist_append (cache->priv->hint_subscriptions, sub);
+
+    return sub->id;
+}
+
+/* remove subscription id from subs, returns TRUE if it was found */
+static gboolean
+remove_subscription (GSList **subs, guint id)
+{
+    GSList *sub;
+
+    for (sub = *subs; sub; sub = sub->next) {
+        if (((Subscription *) sub->data)->id == id) {
+            subscription_free (sub->data);
+            *subs = g_slist_delete_link (*subs, sub);
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+/**
+ * gami_extension_cache_unsubscribe:
+ * @cache: #GamiExtensionCache
+ * @id: the ID of a subscription
+ *
+ * Cancel the subscription @id, as returned by
+ * gami_extension_cache_subscribe() or gami_extension_cache_subscribe_hint().
+ * The extension remains watched.
+ */
+void
+gami_extension_cache_unsubscribe (GamiExtensionCache *cache, guint id)
+{
+    GHashTableIter  iter;
+    GSList         *subs;
+    gchar          *key;
+
+    g_return_if_fail (GAMI_IS_EXTENSION_CACHE (cache));
+
+    if (remove_subscription (&cache->priv->hint_subscriptions, id))
+        return;
+
+    g_hash_table_iter_init (&iter, cache->priv->subscriptions);
+    while (g_hash_table_iter_next (&iter, (gpointer *) &key,
+                                   (gpointer *) &subs)) {
+        if (! remove_subscription (&subs, id))
+            continue;
+
+        key = g_strdup (key);
+        g_hash_table_iter_remove (&iter);
+        if (subs)
+            g_hash_table_insert (cache->priv->subscriptions, key, subs);
+        else
+            g_free (key);
+        return;
+    }
+}
+
+static void
+free_subscriptions (gchar *key, GSList *subs, gpointer data)
+{
+    g_slist_foreach (subs, (GFunc) subscription_free, NULL);
+    g_slist_free (subs);
+}
+
+static void
+gami_extension_cache_init (GamiExtensionCache *cache)
+{
+    cache->priv = GAMI_EXTENSION_CACHE_GET_PRIVATE (cache);
+
+    cache->priv->extensions =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free, (GDestroyNotify) g_hash_table_unref);
+    cache->priv->pending = g_queue_new ();
+    cache->priv->queued = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                 g_free, NULL);
+    cache->priv->updated = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                  g_free, NULL);
+    cache->priv->subscriptions = g_hash_table_new_full (g_str_hash,
+                                                        g_str_equal,
+                                                        g_free, NULL);
+}
+
+static void
+gami_extension_cache_constructed (GObject *object)
+{
+    GamiExtensionCache *cache = GAMI_EXTENSION_CACHE (object);
+
+    connect_event (cache, "typed-event::ExtensionStatus",
+                   G_CALLBACK (on_extension_status));
+
+    if (G_OBJECT_CLASS (gami_extension_cache_parent_class)->constructed)
+        G_OBJECT_CLASS (gami_extension_cache_parent_class)->constructed (object);
+}
+
+static void
+gami_extension_cache_dispose (GObject *object)
+{
+    GamiExtensionCache *cache = GAMI_EXTENSION_CACHE (object);
+    GSList             *handler;
+
+    if (cache->priv->ami) {
+        for (handler = cache->priv->handlers; handler; handler = handler->next)
+            g_signal_handler_disconnect (cache->priv->ami,
+                                         GPOINTER_TO_SIZE (handler->data));
+        g_slist_free (cache->priv->handlers);
+        cache->priv->handlers = NULL;
+
+        g_object_unref (cache->priv->ami);
+        cache->priv->ami = NULL;
+    }
+
+    g_hash_table_foreach (cache->priv->subscriptions,
+                          (GHFunc) free_subscriptions, NULL);
+    g_hash_table_remove_all (cache->priv->subscriptions);
+    free_subscriptions (NULL, cache->priv->hint_subscriptions, NULL);
+    cache->priv->hint_subscriptions = NULL;
+
+    G_OBJECT_CLASS (gami_extension_cache_parent_class)->dispose (object);
+}
+
+static void
+gami_extension_cache_finalize (GObject *object)
+{
+    GamiExtensionCache *cache = GAMI_EXTENSION_CACHE (object);
+
+    g_hash_table_unref (cache->priv->extensions);
+    g_queue_foreach (cache->priv->pending, (GFunc) g_free, NULL);
+    g_queue_free (cache->priv->pending);
+    g_hash_table_unref (cache->priv->queued);
+    g_hash_table_unref (cache->priv->updated);
+    g_hash_table_unref (cache->priv->subscriptions);
+
+    G_OBJECT_CLASS (gami_extension_cache_parent_class)->finalize (object);
+}
+
+static void
+gami_extension_cache_set_property (GObject *object,
+                                   guint prop_id,
+                                   const GValue *value,
+                                   GParamSpec *pspec)
+{
+    GamiExtensionCache *cache = GAMI_EXTENSION_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            cache->priv->ami = g_value_dup_object (value);
+            break;
+        case PROP_MAX_IN_FLIGHT:
+            cache->priv->max_in_flight = g_value_get_uint (value);
+            if (cache->priv->ami)
+                query_pending (cache);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_extension_cache_get_property (GObject *object,
+                                   guint prop_id,
+                                   GValue *value,
+                                   GParamSpec *pspec)
+{
+    GamiExtensionCache *cache = GAMI_EXTENSION_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            g_value_set_object (value, cache->priv->ami);
+            break;
+        case PROP_MAX_IN_FLIGHT:
+            g_value_set_uint (value, cache->priv->max_in_flight);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_extension_cache_class_init (GamiExtensionCacheClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (klass, sizeof (GamiExtensionCachePrivate));
+
+    object_class->set_property = gami_extension_cache_set_property;
+    object_class->get_property = gami_extension_cache_get_property;
+    object_class->constructed  = gami_extension_cache_constructed;
+    object_class->dispose      = gami_extension_cache_dispose;
+    object_class->finalize     = gami_extension_cache_finalize;
+
+    /**
+     * GamiExtensionCache:manager:
+     *
+     * The #GamiManager the cache receives events from
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_MANAGER,
+                                     g_param_spec_object ("manager",
+                                                          "Manager",
+                                                          "The manager the "
+                                                          "cache is attached "
+                                                          "to",
+                                                          GAMI_TYPE_MANAGER,
+                                                          G_PARAM_CONSTRUCT_ONLY
+                                                          | G_PARAM_READWRITE));
+
+    /**
+     * GamiExtensionCache:max-in-flight:
+     *
+     * Maximum number of ExtensionState queries sent to the server without
+     * having received their response
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_MAX_IN_FLIGHT,
+                                     g_param_spec_uint ("max_in_flight",
+                                                        "MaxInFlight",
+                                                        "Maximum number of "
+                                                        "outstanding queries",
+                                                        1,
+                                                        G_MAXUINT,
+                                                        16,
+                                                        G_PARAM_CONSTRUCT
+                                                        | G_PARAM_READWRITE));
+
+    /**
+     * GamiExtensionCache::extension-changed:
+     * @cache: The #GamiExtensionCache that received the signal
+     * @extension: The extension (stored as #GHashTable)
+     *
+     * The ::extension-changed signal is emitted when the state of a watched
+     * extension changed. The signal detail is the extension in the form
+     * "exten@context".
+     */
+    signals [EXTENSION_CHANGED] = g_signal_new ("extension-changed",
+                                                G_TYPE_FROM_CLASS (object_class),
+                                                G_SIGNAL_RUN_LAST
+                                                | G_SIGNAL_DETAILED,
+                                                0,
+                                                NULL,
+                                                NULL,
+                                                g_cclosure_marshal_VOID__BOXED,
+                                                G_TYPE_NONE,
+                                                1, G_TYPE_HASH_TABLE);
+}
@@ -0,0 +1,189 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)
+#  error "Only <gami.h> can be included directly."
+#endif
+
+#ifndef __GAMI_EXTENSION_CACHE_H__
+#define __GAMI_EXTENSION_CACHE_H__
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#ifdef GAMI_COMPILATION
+#  include <gami-manager.h>
+#else
+#  include <gami/gami-manager.h>
+#endif
+
+G_BEGIN_DECLS
+
+/**
+ * GAMI_TYPE_EXTENSION_CACHE:
+ *
+ * Get the #GType of #GamiExtensionCache
+ *
+ * Returns: The #GType of #GamiExtensionCache
+ */
+#define GAMI_TYPE_EXTENSION_CACHE  (gami_extension_cache_get_type ())
+/**
+ * GAMI_EXTENSION_CACHE:
+ * @object: Object which is subject to casting
+ *
+ * Cast a #GamiExtensionCache derived pointer into a (GamiExtensionCache *) pointer
+ */
+#define GAMI_EXTENSION_CACHE(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), \
+									GAMI_TYPE_EXTENSION_CACHE, \
+									GamiExtensionCache))
+/**
+ * GAMI_EXTENSION_CACHE_CLASS:
+ * @klass: a valid #GamiExtensionCacheClass
+ *
+ * Cast a derived #GamiExtensionCacheClass structure into a
+ * #GamiExtensionCacheClass structure
+ */
+#define GAMI_EXTENSION_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), \
+									GAMI_TYPE_EXTENSION_CACHE, \
+									GamiExtensionCacheClass))
+/**
+ * GAMI_IS_EXTENSION_CACHE:
+ * @object: Instance to check for being a %GAMI_TYPE_EXTENSION_CACHE
+ *
+ * Check whether a valid #GTypeInstance pointer is of type
+ * %GAMI_TYPE_EXTENSION_CACHE
+ *
+ * Returns: %FALSE or %TRUE, indicating whether @object is a
+ *          %GAMI_TYPE_EXTENSION_CACHE
+ */
+#define GAMI_IS_EXTENSION_CACHE(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), \
+									GAMI_TYPE_EXTENSION_CACHE))
+/**
+ * GAMI_IS_EXTENSION_CACHE_CLASS:
+ * @klass: a #GamiExtensionCacheClass
+ *
+ * Check whether @klass is a #GamiExtensionCacheClass
+ *
+ * Returns: %FALSE or %TRUE
+ */
+#define GAMI_IS_EXTENSION_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), \
+									GAMI_TYPE_EXTENSION_CACHE))
+/**
+ * GAMI_EXTENSION_CACHE_GET_CLASS:
+ * @object: a #GamiExtensionCache instance
+ *
+ * Get the class structure associated to a #GamiExtensionCache instance.
+ *
+ * Returns: pointer to object class structure
+ */
+#define GAMI_EXTENSION_CACHE_GET_CLASS(object) (G_TYPE_INSTANCE_GET_CLASS ((object), \
+									GAMI_TYPE_EXTENSION_CACHE, \
+									GamiExtensionCacheClass))
+
+/**
+ * GamiExtensionCache:
+ * @parent_instance: #GObject parent instance
+ *
+ * #GamiExtensionCache keeps a local copy of the state of extensions on the
+ * server of a #GamiManager.
+ */
+typedef struct _GamiExtensionCache GamiExtensionCache;
+
+typedef struct _GamiExtensionCachePrivate GamiExtensionCachePrivate;
+
+/**
+ * GamiExtensionCacheClass:
+ * @parent_class: #GamiExtensionCache's parent class (of type #GObjectClass)
+ *
+ * The class structure for the #GamiExtensionCache type
+ */
+typedef struct _GamiExtensionCacheClass GamiExtensionCacheClass;
+
+struct _GamiExtensionCache
+{
+	GObject parent_instance;
+	GamiExtensionCachePrivate *priv;
+};
+
+struct _GamiExtensionCacheClass
+{
+	GObjectClass parent_class;
+};
+
+/**
+ * GamiExtensionStateFunc:
+ * @cache: the #GamiExtensionCache
+ * @extension: the extension whose state changed (stored as #GHashTable)
+ * @user_data: user data passed to the subscription
+ *
+ * Specifies the type of functions passed to gami_extension_cache_subscribe()
+ * and gami_extension_cache_subscribe_hint()
+ */
+typedef void (*GamiExtensionStateFunc) (GamiExtensionCache *cache,
+										GHashTable *extension,
+										gpointer user_data);
+
+GType gami_extension_cache_get_type (void) G_GNUC_CONST;
+
+GamiExtensionCache *gami_extension_cache_new (GamiManager *ami);
+
+gboolean gami_extension_cache_refresh (GamiExtensionCache *cache,
+									   GError **error);
+void gami_extension_cache_refresh_async (GamiExtensionCache *cache,
+										 GAsyncReadyCallback callback,
+										 gpointer user_data);
+gboolean gami_extension_cache_refresh_finish (GamiExtensionCache *cache,
+											  GAsyncResult *result,
+											  GError **error);
+
+void gami_extension_cache_watch (GamiExtensionCache *cache,
+								 const gchar *exten,
+								 const gchar *context);
+void gami_extension_cache_unwatch (GamiExtensionCache *cache,
+								   const gchar *exten,
+								   const gchar *context);
+
+GHashTable *gami_extension_cache_lookup (GamiExtensionCache *cache,
+										 const gchar *exten,
+										 const gchar *context);
+gint gami_extension_cache_get_state (GamiExtensionCache *cache,
+									 const gchar *exten,
+									 const gchar *context);
+GList *gami_extension_cache_get_extensions (GamiExtensionCache *cache);
+
+guint gami_extension_cache_subscribe (GamiExtensionCache *cache,
+									  const gchar *exten,
+									  const gchar *context,
+									  GamiExtensionStateFunc func,
+									  gpointer user_data,
+									  GDestroyNotify notify);
+guint gami_extension_cache_subscribe_hint (GamiExtensionCache *cache,
+										   const gchar *pattern,
+										   GamiExtensionStateFunc func,
+										   gpointer user_data,
+										   GDestroyNotify notify);
+void gami_extension_cache_unsubscribe (GamiExtensionCache *cache,
+									   guint id);
+
+G_END_DECLS
+
+#endif /* __GAMI_EXTENSION_CACHE_H__ */
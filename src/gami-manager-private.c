@@ -1,13 +1,14 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
+#include <time.h>
 #include <gami-manager-private.h>
-
-typedef gpointer (*GamiPointerFinishFunc) (GamiManager *,
-                                           GAsyncResult *,
-                                           GError **);
+#include <gami-config-private.h>
 
 static gchar *set_action_id (const gchar *action_id);
+static void schedule_packet_processing (GamiManager *ami);
+void free_list_result (GSList *list);
+void gami_queue_status_list_free (GSList *list);
 
 
 gboolean
@@ -102,6 +103,24 @@ wait_queue_status_result (GamiManager *ami,
     return res;
 }
 
+/* for finish functions which return a new reference */
+gpointer
+wait_pointer_result (GamiManager *ami,
+                     GamiPointerFinishFunc finish,
+                     GError **error)
+{
+    gpointer res;
+
+    while (! ami->priv->sync_result)
+        g_main_context_iteration (NULL, TRUE);
+
+    res = finish (ami, ami->priv->sync_result, error);
+    g_object_unref (ami->priv->sync_result);
+    ami->priv->sync_result = NULL;
+
+    return res;
+}
+
 static gchar *
 set_action_id (const gchar *action_id)
 {
@@ -189,7 +208,7 @@ bool_action_finish (GamiManager *ami,
     return g_simple_async_result_get_op_res_gboolean (simple);
 }
 
-static gpointer
+gpointer
 pointer_action_finish (GamiManager *ami,
                        GAsyncResult *result,
                        GamiAsyncFunc func,
@@ -260,7 +279,30 @@ send_action_string (GamiManager *ami,
                                                         error));
 }
 
-void
+/* hook functions whose handler data is owned by the hook; it is freed when
+ * the hook is destroyed, also if that happens before the action finished */
+static const struct {
+    GHookCheckFunc handler;
+    GDestroyNotify handler_data_free;
+} owned_handler_data [] = {
+    { status_variables_hook, g_free },
+    { stream_hook,           (GDestroyNotify) gami_list_stream_free },
+    { command_hook,          (GDestroyNotify) gami_command_stream_free }
+};
+
+static GDestroyNotify
+lookup_handler_data_free (GHookCheckFunc handler)
+{
+    guint i;
+
+    for (i = 0; i < G_N_ELEMENTS (owned_handler_data); i++)
+        if (owned_handler_data [i].handler == handler)
+            return owned_handler_data [i].handler_data_free;
+
+    return NULL;
+}
+
+gulong
 setup_action_hook (GamiManager *ami,
                    GamiAsyncFunc func,
                    GHookCheckFunc handler,
@@ -270,6 +312,8 @@ setup_action_hook (GamiManager *ami,
                    gpointer user_data,
                    GError *error)
 {
+    GDestroyNotify handler_data_free = lookup_handler_data_free (handler);
+
     if (error) {
         g_simple_async_report_gerror_in_idle (G_OBJECT (ami),
                                               callback,
@@ -277,6 +321,10 @@ setup_action_hook (GamiManager *ami,
                                               error);
         g_error_free (error);
         g_free (action_id);
+        if (handler_data_free && handler_data)
+            handler_data_free (handler_data);
+
+        return 0;
     } else {
         GHook *action_hook;
         GamiHookData *hook_data;
@@ -288,11 +336,548 @@ setup_action_hook (GamiManager *ami,
         action_hook = g_hook_alloc (&ami->priv->packet_hooks);
         hook_data = gami_hook_data_new (G_ASYNC_RESULT (simple),
                                         action_id, handler_data);
+        hook_data->handler_data_free = handler_data_free;
         action_hook->data = hook_data;
         action_hook->func = handler;
         action_hook->destroy = (GDestroyNotify) gami_hook_data_free;
         g_hook_append (&ami->priv->packet_hooks, action_hook);
+
+        return action_hook->hook_id;
+    }
+}
+
+/* read-only actions which may share a single response */
+static const struct {
+    GamiAsyncFunc  func;
+    GamiResultKind kind;
+} idempotent_actions [] = {
+    { (GamiAsyncFunc) gami_manager_getvar_async,
+      GAMI_RESULT_STRING },
+    { (GamiAsyncFunc) gami_manager_module_check_async,
+      GAMI_RESULT_BOOLEAN },
+    { (GamiAsyncFunc) gami_manager_meetme_list_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_queue_summary_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_queue_status_async,
+      GAMI_RESULT_QUEUE_STATUS_LIST },
+    { (GamiAsyncFunc) gami_manager_queues_async,
+      GAMI_RESULT_STRING },
+    { (GamiAsyncFunc) gami_manager_queues_list_async,
+      GAMI_RESULT_QUEUE_STATUS_LIST },
+    { (GamiAsyncFunc) gami_manager_zap_show_channels_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_dahdi_show_channels_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_agents_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_db_get_async,
+      GAMI_RESULT_STRING },
+    { (GamiAsyncFunc) gami_manager_parked_calls_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_voicemail_users_list_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_mailbox_count_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_mailbox_status_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_core_status_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_core_show_channels_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_core_settings_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_iax_peerlist_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_sip_peers_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_sip_showpeer_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_sip_showregistry_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_status_async,
+      GAMI_RESULT_LIST },
+    { (GamiAsyncFunc) gami_manager_extension_state_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_list_commands_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_list_categories_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_get_config_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_get_config_json_async,
+      GAMI_RESULT_HASH },
+    { (GamiAsyncFunc) gami_manager_get_config_tree_async,
+      GAMI_RESULT_CONFIG },
+    { (GamiAsyncFunc) gami_manager_get_config_json_tree_async,
+      GAMI_RESULT_CONFIG },
+    { NULL, GAMI_RESULT_NONE }
+};
+
+GamiResultKind
+idempotent_result_kind (GamiAsyncFunc func)
+{
+    guint i;
+
+    for (i = 0; idempotent_actions [i].func; i++)
+        if (idempotent_actions [i].func == func)
+            return idempotent_actions [i].kind;
+
+    return GAMI_RESULT_NONE;
+}
+
+gpointer
+get_action_result (GSimpleAsyncResult *simple, GamiResultKind kind)
+{
+    if (kind == GAMI_RESULT_BOOLEAN)
+        return GINT_TO_POINTER (g_simple_async_result_get_op_res_gboolean
+                                (simple));
+
+    return g_simple_async_result_get_op_res_gpointer (simple);
+}
+
+static void
+copy_hash_entry (gchar *key, gchar *value, GHashTable *copy)
+{
+    g_hash_table_insert (copy, g_strdup (key), g_strdup (value));
+}
+
+/* results are parsed packets, mapping header names to values */
+static GHashTable *
+copy_hash_result (GHashTable *hash)
+{
+    GHashTable *copy;
+
+    copy = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    g_hash_table_foreach (hash, (GHFunc) copy_hash_entry, copy);
+
+    return copy;
+}
+
+static GSList *
+copy_list_result (GSList *list)
+{
+    GSList *copy = NULL;
+
+    for (; list; list = list->next)
+        copy = g_slist_prepend (copy, copy_hash_result (list->data));
+
+    return g_slist_reverse (copy);
+}
+
+static GSList *
+copy_queue_status_list (GSList *list)
+{
+    GSList *copy = NULL;
+
+    for (; list; list = list->next) {
+        GamiQueueStatusEntry *entry = list->data,
+                             *entry_copy;
+        GHashTable           *hash;
+        guint                 i;
+
+        hash = copy_hash_result (gami_queue_status_entry_get_params (entry));
+        entry_copy = gami_queue_status_entry_new (hash);
+        g_hash_table_unref (hash);
+
+        for (i = 0; i < gami_queue_status_entry_get_n_members (entry); i++) {
+            hash = copy_hash_result (gami_queue_status_entry_get_member (entry,
+                                                                         i));
+            gami_queue_status_entry_add_member (entry_copy, hash);
+            g_hash_table_unref (hash);
+        }
+
+        copy = g_slist_prepend (copy, entry_copy);
+    }
+
+    return g_slist_reverse (copy);
+}
+
+static GamiConfig *
+copy_config_result (GamiConfig *config)
+{
+    GamiConfig *copy;
+    guint       i, j;
+
+    copy = gami_config_new ();
+
+    for (i = 0; i < gami_config_get_n_categories (config); i++) {
+        GamiConfigCategory *category, *category_copy;
+
+        category = gami_config_get_category (config, i);
+        category_copy =
+            gami_config_add_category (copy,
+                                      gami_config_category_get_name
+                                      (category));
+
+        for (j = 0; j < gami_config_category_get_n_lines (category); j++) {
+            const GamiConfigLine *line;
+
+            line = gami_config_category_get_line (category, j);
+            gami_config_category_add_line (category_copy,
+                                           line->key,
+                                           line->value);
+        }
+    }
+
+    return copy;
+}
+
+/* a copy of the result of an action which may be handed out to another
+ * request; every request owns its result and may modify it, so nothing is
+ * shared between them */
+static gpointer
+copy_action_result (GamiResultKind kind, gpointer result)
+{
+    switch (kind) {
+        case GAMI_RESULT_STRING:
+            return g_strdup (result);
+        case GAMI_RESULT_HASH:
+            return copy_hash_result (result);
+        case GAMI_RESULT_LIST:
+            return copy_list_result (result);
+        case GAMI_RESULT_QUEUE_STATUS_LIST:
+            return copy_queue_status_list (result);
+        case GAMI_RESULT_CONFIG:
+            return copy_config_result (result);
+        default:
+            return result;
+    }
+}
+
+static GDestroyNotify
+action_result_free_func (GamiResultKind kind)
+{
+    switch (kind) {
+        case GAMI_RESULT_STRING:
+            return g_free;
+        case GAMI_RESULT_HASH:
+            return (GDestroyNotify) g_hash_table_unref;
+        case GAMI_RESULT_LIST:
+            return (GDestroyNotify) free_list_result;
+        case GAMI_RESULT_QUEUE_STATUS_LIST:
+            return (GDestroyNotify) gami_queue_status_list_free;
+        case GAMI_RESULT_CONFIG:
+            return (GDestroyNotify) gami_config_unref;
+        default:
+            return NULL;
+    }
+}
+
+/* set the result of an action for another request */
+void
+share_action_result (GSimpleAsyncResult *simple,
+                     GamiResultKind kind,
+                     gpointer result)
+{
+    g_return_if_fail (kind != GAMI_RESULT_NONE);
+
+    if (kind == GAMI_RESULT_BOOLEAN)
+        g_simple_async_result_set_op_res_gboolean (simple,
+                                                   GPOINTER_TO_INT (result));
+    else
+        g_simple_async_result_set_op_res_gpointer (simple,
+                                                   copy_action_result (kind,
+                                                                       result),
+                                                   action_result_free_func
+                                                   (kind));
+}
+
+void
+gami_cached_response_free (GamiCachedResponse *response)
+{
+    GDestroyNotify free_func;
+
+    free_func = action_result_free_func (response->kind);
+    if (free_func && response->result)
+        free_func (response->result);
+    g_free (response->action);
+    g_slice_free (GamiCachedResponse, response);
+}
+
+static guint
+lookup_response_ttl (GamiManager *ami, const gchar *action)
+{
+    gchar *name;
+    guint  ttl;
+
+    if (! g_hash_table_size (ami->priv->response_ttls))
+        return 0;
+
+    name = g_ascii_strdown (action, -1);
+    ttl = GPOINTER_TO_UINT (g_hash_table_lookup (ami->priv->response_ttls,
+                                                 name));
+    g_free (name);
+
+    return ttl;
+}
+
+static GamiCachedResponse *
+lookup_cached_response (GamiManager *ami, const gchar *key)
+{
+    GamiCachedResponse *response;
+
+    response = g_hash_table_lookup (ami->priv->response_cache, key);
+    if (response && response->expires <= get_current_time_usec ()) {
+        g_hash_table_remove (ami->priv->response_cache, key);
+        ami->priv->response_cache_evictions++;
+        response = NULL;
+    }
+
+    return response;
+}
+
+static gboolean
+response_matches_action (gchar *key,
+                         GamiCachedResponse *response,
+                         const gchar *action)
+{
+    return ! action || ! strcmp (response->action, action);
+}
+
+void
+invalidate_cached_responses (GamiManager *ami, const gchar *action)
+{
+    gchar *name;
+
+    name = action ? g_ascii_strdown (action, -1) : NULL;
+
+    ami->priv->response_cache_generation++;
+    ami->priv->response_cache_evictions +=
+        g_hash_table_foreach_remove (ami->priv->response_cache,
+                                     (GHRFunc) response_matches_action,
+                                     name);
+    g_free (name);
+}
+
+/* events after which cached responses may be outdated */
+static const struct {
+    const gchar *event;
+    const gchar *action;
+} response_invalidations [] = {
+    /* any configuration may have changed */
+    { "Reload",         NULL },
+    { "Shutdown",       NULL },
+    { "FullyBooted",    NULL },
+    { "MessageWaiting", "MailboxCount" },
+    { "MessageWaiting", "MailboxStatus" },
+    { "PeerStatus",     "SIPpeers" },
+    { "PeerStatus",     "SIPShowPeer" },
+    { "PeerStatus",     "IAXpeerlist" },
+    { "Registry",       "SIPshowregistry" },
+    { "ExtensionStatus", "ExtensionState" },
+    { NULL, NULL }
+};
+
+static void
+update_response_cache (GamiManager *ami, const gchar *event)
+{
+    guint i;
+
+    if (! g_hash_table_size (ami->priv->response_cache))
+        return;
+
+    for (i = 0; response_invalidations [i].event; i++)
+        if (! strcmp (event, response_invalidations [i].event))
+            invalidate_cached_responses (ami,
+                                         response_invalidations [i].action);
+}
+
+void
+gami_in_flight_action_free (GamiInFlightAction *action)
+{
+    g_slist_foreach (action->waiters, (GFunc) g_object_unref, NULL);
+    g_slist_free (action->waiters);
+    g_free (action->key);
+    g_free (action->action);
+    g_slice_free (GamiInFlightAction, action);
+}
+
+static gint
+compare_params (gconstpointer a, gconstpointer b)
+{
+    return strcmp (*(const gchar **) a, *(const gchar **) b);
+}
+
+/* identify an action by the kind of its result, its name and parameters,
+ * independent of their order and of the case of their names (the kind keeps
+ * e.g. GetConfig as a hash and as a tree apart); actions with ActionID are
+ * not shared, as the caller may rely on it */
+static gchar *
+in_flight_key (GamiResultKind kind,
+               const gchar *action_name,
+               const gchar *first_param_name,
+               va_list varargs)
+{
+    GPtrArray   *params;
+    GString     *key;
+    const gchar *name, *value;
+    gchar       *lower;
+    guint        i;
+
+    params = g_ptr_array_new ();
+
+    for (name = first_param_name; name; name = va_arg (varargs, gchar *)) {
+        value = va_arg (varargs, gchar *);
+        if (! value)
+            continue;
+
+        if (! g_ascii_strcasecmp (name, "actionid")) {
+            g_ptr_array_foreach (params, (GFunc) g_free, NULL);
+            g_ptr_array_free (params, TRUE);
+            return NULL;
+        }
+
+        lower = g_ascii_strdown (name, -1);
+        g_ptr_array_add (params, g_strconcat (lower, ": ", value, NULL));
+        g_free (lower);
+    }
+
+    g_ptr_array_sort (params, compare_params);
+
+    key = g_string_new (NULL);
+    g_string_printf (key, "%d %s", kind, action_name);
+    for (i = 0; i < params->len; i++) {
+        g_string_append (key, "\r\n");
+        g_string_append (key, g_ptr_array_index (params, i));
+        g_free (g_ptr_array_index (params, i));
+    }
+    g_ptr_array_free (params, TRUE);
+
+    return g_string_free (key, FALSE);
+}
+
+static void
+in_flight_action_complete (GObject *source,
+                           GAsyncResult *result,
+                           gpointer user_data)
+{
+    GamiInFlightAction *action = user_data;
+    GHashTable         *in_flight = action->ami->priv->in_flight;
+    GError             *error = NULL;
+    gpointer            res = NULL;
+    GSList             *waiter;
+
+    if (g_hash_table_lookup (in_flight, action->key) == action)
+        g_hash_table_remove (in_flight, action->key);
+
+    if (! g_simple_async_result_propagate_error (G_SIMPLE_ASYNC_RESULT
+                                                 (result),
+                                                 &error))
+        res = get_action_result (G_SIMPLE_ASYNC_RESULT (result), action->kind);
+
+    /* responses sent before an invalidation are not cached */
+    if (! error && action->ttl
+        && action->generation == action->ami->priv->response_cache_generation) {
+        GamiCachedResponse *response;
+
+        response = g_slice_new (GamiCachedResponse);
+        response->action = g_strdup (action->action);
+        response->kind = action->kind;
+        response->result = action->kind == GAMI_RESULT_BOOLEAN
+                           ? res : copy_action_result (action->kind, res);
+        response->expires = get_current_time_usec ()
+                            + (gint64) action->ttl * 1000;
+        g_hash_table_replace (action->ami->priv->response_cache,
+                              g_strdup (action->key),
+                              response);
+    }
+
+    action->waiters = g_slist_reverse (action->waiters);
+    for (waiter = action->waiters; waiter; waiter = waiter->next) {
+        GSimpleAsyncResult *simple = waiter->data;
+
+        if (error)
+            g_simple_async_result_set_from_error (simple, error);
+        else
+            share_action_result (simple, action->kind, res);
+        g_simple_async_result_complete (simple);
+    }
+
+    if (error)
+        g_error_free (error);
+    gami_in_flight_action_free (action);
+}
+
+/* answer a read-only action from the response cache, or wait for the
+ * result of an identical action awaiting response; otherwise redirect the
+ * response of the action about to be sent to all requests which join it,
+ * and to the cache */
+static gboolean
+answer_action_locally (GamiManager *ami,
+                       GamiAsyncFunc func,
+                       GAsyncReadyCallback *callback,
+                       gpointer *user_data,
+                       const gchar *action_name,
+                       const gchar *first_param_name,
+                       va_list varargs)
+{
+    GamiInFlightAction *action;
+    GamiCachedResponse *response;
+    GamiResultKind      kind;
+    GSimpleAsyncResult *waiter;
+    gchar              *key;
+    guint               ttl;
+    va_list             params;
+
+    kind = idempotent_result_kind (func);
+    if (kind == GAMI_RESULT_NONE)
+        return FALSE;
+
+    ttl = lookup_response_ttl (ami, action_name);
+    if (! ami->priv->deduplicate && ! ttl)
+        return FALSE;
+
+    G_VA_COPY (params, varargs);
+    key = in_flight_key (kind, action_name, first_param_name, params);
+    va_end (params);
+
+    if (! key)
+        return FALSE;
+
+    waiter = g_simple_async_result_new (G_OBJECT (ami),
+                                        *callback,
+                                        *user_data,
+                                        func);
+
+    if (ttl) {
+        if ((response = lookup_cached_response (ami, key))) {
+            ami->priv->response_cache_hits++;
+            share_action_result (waiter, kind, response->result);
+            g_simple_async_result_complete_in_idle (waiter);
+            g_object_unref (waiter);
+            g_free (key);
+
+            return TRUE;
+        }
+        ami->priv->response_cache_misses++;
+    }
+
+    action = g_hash_table_lookup (ami->priv->in_flight, key);
+    if (action) {
+        action->waiters = g_slist_prepend (action->waiters, waiter);
+        ami->priv->deduplicated_actions++;
+        g_free (key);
+
+        return TRUE;
     }
+
+    action = g_slice_new (GamiInFlightAction);
+    action->ami = ami;
+    action->key = key;
+    action->action = g_ascii_strdown (action_name, -1);
+    action->kind = kind;
+    action->ttl = ttl;
+    action->generation = ami->priv->response_cache_generation;
+    action->waiters = g_slist_prepend (NULL, waiter);
+
+    if (ami->priv->deduplicate)
+        g_hash_table_insert (ami->priv->in_flight, action->key, action);
+
+    *callback = in_flight_action_complete;
+    *user_data = action;
+
+    return FALSE;
 }
 
 static void send_async_action_valist (GamiManager *ami,
@@ -324,6 +909,15 @@ send_async_action_valist (GamiManager *ami,
 
     g_assert (ami->priv->connected);
 
+    if (answer_action_locally (ami,
+                               func,
+                               &callback,
+                               &user_data,
+                               action_name,
+                               first_param_name,
+                               varargs))
+        return;
+
     g_debug ("Sending GAMI command");
 
     action = build_action_string_valist (action_name,
@@ -372,153 +966,1428 @@ send_async_action (GamiManager *ami,
     va_end (varargs);
 }
 
-gboolean
-dispatch_ami (GIOChannel *chan, GIOCondition cond, GamiManager *ami)
+/* microseconds on a monotonic clock, so that deadlines and delays are not
+ * disturbed by changes of the system time; only meaningful relative to other
+ * values returned in the same process */
+gint64
+get_current_time_usec (void)
 {
-    GIOStatus status = G_IO_STATUS_NORMAL;
-
-    if (cond & (G_IO_IN | G_IO_PRI)) {
-        static gsize  buffer_size = 0;
-        static gchar *response    = NULL;
-        gsize         channel_buffer_size;
-        GError       *error       = NULL;
-
-        channel_buffer_size = g_io_channel_get_buffer_size (chan);
+    static volatile gsize timer = 0;
 
-        do {
-            gsize mem_avail,
-                  bytes_read,
-                  offset;
+    if (g_once_init_enter (&timer))
+        g_once_init_leave (&timer, (gsize) g_timer_new ());
 
-            if (! response) {
-                buffer_size = channel_buffer_size;
-                response = g_malloc0 (buffer_size);
-            }
+    return (gint64) (g_timer_elapsed ((GTimer *) timer, NULL)
+                     * G_USEC_PER_SEC);
+}
 
-            offset = strlen (response);
-            mem_avail = buffer_size - offset;
-            if (mem_avail < channel_buffer_size) {
-                gsize mem_new;
+static gboolean
+read_budget_exhausted (GamiManagerPrivate *priv, gsize bytes, gint64 start)
+{
+    if (priv->read_budget_bytes && bytes >= priv->read_budget_bytes)
+        return TRUE;
 
-                mem_new = channel_buffer_size - mem_avail;
-                buffer_size += mem_new;
+    if (priv->read_budget_time
+        && get_current_time_usec () - start >= priv->read_budget_time)
+        return TRUE;
 
-                response = g_realloc (response, buffer_size);
-            }
+    return FALSE;
+}
 
-            status = g_io_channel_read_chars (chan,
-                                              response + offset,
-                                              channel_buffer_size-1,
-                                              &bytes_read,
-                                              &error);
-            response [offset + bytes_read] = '\0';
-
-            g_log (ami->priv->log_domain, GAMI_LOG_LEVEL_NET_RX,
-                   "%s", response + offset);
-
-        } while (status == G_IO_STATUS_NORMAL);
-
-        if (*response) {
-            gchar **packets,
-                  **packet;
-            gchar  *shift = NULL;
-
-            packets = g_strsplit (response, "\r\n\r\n", -1);
-            for (packet = packets; g_strv_length (packet) > 1; packet++)
-                g_queue_push_tail (ami->priv->packet_buffer,
-                                   gami_packet_new ((const gchar *) *packet));
-            g_strfreev (packets);
-
-            shift = g_strrstr (response, "\r\n\r\n");
-            if (shift) {
-                if (strlen (shift + 4)) {
-                    g_memmove (response, shift + 4, strlen (shift + 4));
-                    response [strlen (shift + 4)] = '\0';
-                } else {
-                    g_free (response);
-                    g_nullify_pointer ((gpointer *) &response);
-                    buffer_size = 0;
-                }
-            }
-        }
+static gboolean
+packet_buffer_above_high (GamiManagerPrivate *priv)
+{
+    /* the partial packet in the receive buffer is not accounted for, as it
+     * has to be read completely before it can be processed anyway */
+    if (priv->high_watermark_bytes
+        && priv->buffered_bytes >= priv->high_watermark_bytes)
+        return TRUE;
 
-        if (status == G_IO_STATUS_ERROR) {
-            g_warning ("An error occurred during package reception%s%s\n",
-                       error ? ": " : "",
-                       error ? error->message : "");
-            if (error)
-                g_error_free (error);
-        }
+    if (priv->high_watermark_packets
+        && priv->buffered_packets >= priv->high_watermark_packets)
+        return TRUE;
 
-        if (! g_queue_is_empty (ami->priv->packet_buffer))
-            g_timeout_add (0, (GSourceFunc) process_packets, ami);
-    }
+    return FALSE;
+}
 
-    if (cond & (G_IO_HUP | G_IO_ERR) || status == G_IO_STATUS_EOF) {
-        ami->priv->connected = FALSE;
-        //g_signal_emit (ami, signals [DISCONNECTED], 0);
-        //g_idle_add ((GSourceFunc) reconnect_socket, ami);
+static gboolean
+packet_buffer_below_low (GamiManagerPrivate *priv)
+{
+    if (priv->high_watermark_bytes
+        && priv->buffered_bytes > MIN (priv->low_watermark_bytes, priv->high_watermark_bytes))
+        return FALSE;
 
+    if (priv->high_watermark_packets
+        && priv->buffered_packets > MIN (priv->low_watermark_packets, priv->high_watermark_packets))
         return FALSE;
-    }
 
     return TRUE;
 }
 
-void
-set_current_packet (GHook *hook, gpointer packet)
+/* return the name of the event in raw, or NULL if the packet is no event;
+ * events which belong to an action (list items) are never reported */
+static gchar *
+packet_event_name (const gchar *raw)
 {
-    GamiHookData *data;
+    const gchar *end;
 
-    data = (GamiHookData *) hook->data;
-    data->packet = (GamiPacket *) packet;
+    if (! g_str_has_prefix (raw, "Event: "))
+        return NULL;
+
+    if (strstr (raw, "\r\nActionID: "))
+        return NULL;
+
+    raw += strlen ("Event: ");
+    end = strstr (raw, "\r\n");
+
+    return end ? g_strndup (raw, end - raw) : g_strdup (raw);
 }
 
-gboolean
-process_packets (GamiManager *ami)
+/* look up the value of header in an unparsed packet */
+static gchar *
+packet_header_value (const gchar *raw, const gchar *header)
 {
-    GamiPacket         *packet;
+    const gchar *line;
+    gsize        len;
 
-    if (! (packet = g_queue_pop_head (ami->priv->packet_buffer)))
-        return FALSE;
+    len = strlen (header);
 
-    g_hook_list_marshal (&ami->priv->packet_hooks,
-                         FALSE,
-                         set_current_packet,
-                         packet);
-    g_hook_list_invoke_check (&ami->priv->packet_hooks,
-                              FALSE);
-    gami_packet_free (packet);
+    for (line = raw; line; line = strstr (line, "\r\n")) {
+        if (line != raw)
+            line += strlen ("\r\n");
 
-    return ! g_queue_is_empty (ami->priv->packet_buffer);
-}
+        if (! g_ascii_strncasecmp (line, header, len)
+            && line [len] == ':' && line [len + 1] == ' ') {
+            const gchar *end;
 
-void
-set_sync_result (GObject *source, GAsyncResult *result, gpointer user_data)
-{
-    GAMI_MANAGER (source)->priv->sync_result = g_object_ref (result);
+            line += len + 2;
+            end = strstr (line, "\r\n");
+
+            return end ? g_strndup (line, end - line) : g_strdup (line);
+        }
+    }
+
+    return NULL;
 }
 
-gboolean
-reconnect_socket (GamiManager *ami)
+/* events which relate to a channel are never delivered before events for
+ * the same channel which are already queued in a lower priority lane; rather
+ * than holding the event back, those are moved up into its lane, in the
+ * order they were received (packets of a channel in higher lanes are always
+ * older than those in lower lanes) */
+static void
+promote_channel_packets (GamiManagerPrivate *priv,
+                         guint *pending,
+                         const gchar *channel,
+                         guint lane)
 {
-    GError *error = NULL;
+    gint i;
 
-    close (g_io_channel_unix_get_fd (ami->priv->socket));
-    g_io_channel_shutdown (ami->priv->socket, TRUE, NULL);
-    g_io_channel_unref (ami->priv->socket);
+    for (i = (gint) lane - 1; i >= 0; i--) {
+        GList *link,
+              *next;
 
-    return ! gami_manager_connect (ami, &error); /* try again if connection
-                                                    failed */
-}
+        for (link = priv->lanes [i]->head; link && pending [i]; link = next) {
+            GamiPacket *packet = link->data;
 
-GamiPacket *
-gami_packet_new (const gchar *raw_text)
-{
-    GamiPacket *pkt;
+            next = link->next;
+            if (g_strcmp0 (packet->channel, channel))
+                continue;
+
+            g_queue_unlink (priv->lanes [i], link);
+            g_queue_push_tail_link (priv->lanes [lane], link);
+            packet->lane = lane;
+            pending [i]--;
+            pending [lane]++;
+        }
+    }
+}
+
+static void
+push_packet (GamiManager *ami, GamiPacket *packet, const gchar *event)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    guint               lane;
+
+    if (event) {
+        lane = GPOINTER_TO_INT (g_hash_table_lookup (priv->event_priorities,
+                                                     event));
+        if (! lane)
+            lane = GAMI_EVENT_PRIORITY_NORMAL;
+        else
+            lane--;     /* priorities are stored off by one */
+
+        if (packet->channel) {
+            guint *pending;
+
+            pending = g_hash_table_lookup (priv->channel_lanes,
+                                           packet->channel);
+            if (! pending) {
+                pending = g_new0 (guint, N_PACKET_LANES);
+                g_hash_table_insert (priv->channel_lanes,
+                                     g_strdup (packet->channel),
+                                     pending);
+            } else
+                promote_channel_packets (priv, pending, packet->channel, lane);
+            pending [lane]++;
+        }
+    } else
+        lane = GAMI_EVENT_PRIORITY_RESPONSE;
+
+    packet->lane     = lane;
+    packet->enqueued = get_current_time_usec ();
+
+    priv->buffered_bytes += packet->size;
+    priv->buffered_packets++;
+    g_queue_push_tail (priv->lanes [lane], packet);
+}
+
+/* move a packet held back for coalescing into its delivery lane */
+static void
+release_coalesced_packet (GamiManager *ami, GamiPacket *packet)
+{
+    gchar *event;
+
+    g_hash_table_remove (ami->priv->coalesce_pending, packet->coalesce_key);
+    g_free (packet->coalesce_key);
+    packet->coalesce_key = NULL;
+
+    event = packet_event_name (packet->raw);
+    push_packet (ami, packet, event);
+    g_free (event);
+}
+
+void
+flush_coalesced_events (GamiManager *ami, gboolean all)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    GamiPacket         *packet;
+    gint64              deadline;
+
+    if (priv->coalesce_source) {
+        g_source_remove (priv->coalesce_source);
+        priv->coalesce_source = 0;
+    }
+
+    deadline = get_current_time_usec () - (gint64) priv->coalesce_window * 1000;
+
+    while ((packet = g_queue_peek_head (priv->coalesce_queue))) {
+        if (! all && packet->enqueued > deadline)
+            break;
+
+        g_queue_pop_head (priv->coalesce_queue);
+        release_coalesced_packet (ami, packet);
+    }
+
+    if (packet) {
+        gint64 remaining;
+
+        remaining = (packet->enqueued - deadline) / 1000 + 1;
+        priv->coalesce_source = g_timeout_add ((guint) remaining,
+                                               (GSourceFunc) coalesce_timeout,
+                                               ami);
+    }
+
+    schedule_packet_processing (ami);
+}
+
+gboolean
+coalesce_timeout (GamiManager *ami)
+{
+    ami->priv->coalesce_source = 0;
+    flush_coalesced_events (ami, FALSE);
+
+    return FALSE;
+}
+
+/* release the held events of channel, before an event of the channel which
+ * is not coalesced may overtake them */
+static void
+flush_coalesced_channel (GamiManager *ami, const gchar *channel)
+{
+    GList *link,
+          *next;
+
+    for (link = ami->priv->coalesce_queue->head; link; link = next) {
+        GamiPacket *packet = link->data;
+
+        next = link->next;
+        if (g_strcmp0 (packet->channel, channel))
+            continue;
+
+        g_queue_delete_link (ami->priv->coalesce_queue, link);
+        release_coalesced_packet (ami, packet);
+    }
+}
+
+/* whether events of channel other than those coalesced under key are held */
+static gboolean
+holds_other_events (GamiManagerPrivate *priv,
+                    const gchar *channel,
+                    const gchar *key)
+{
+    GList *link;
+
+    for (link = priv->coalesce_queue->head; link; link = link->next) {
+        GamiPacket *packet = link->data;
+
+        if (! g_strcmp0 (packet->channel, channel)
+            && strcmp (packet->coalesce_key, key))
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* hold back events with coalescing rules for the coalescing window; returns
+ * %TRUE if the packet has been consumed */
+static gboolean
+coalesce_packet (GamiManager *ami, GamiPacket *packet, const gchar *event)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    GamiPacket         *held;
+    GString            *key;
+    gchar             **headers;
+
+    if (! priv->coalesce_window)
+        return FALSE;
+
+    headers = g_hash_table_lookup (priv->coalesce_rules, event);
+    if (! headers)
+        return FALSE;
+
+    key = g_string_new (event);
+    for (; *headers; headers++) {
+        gchar *value;
+
+        value = packet_header_value (packet->raw, *headers);
+        g_string_append_printf (key, "\n%s", value ? value : "");
+        g_free (value);
+    }
+
+    /* a replacement keeps the position of the superseded event, so it
+     * could overtake other held events of its channel */
+    if (packet->channel
+        && holds_other_events (priv, packet->channel, key->str))
+        flush_coalesced_channel (ami, packet->channel);
+
+    held = g_hash_table_lookup (priv->coalesce_pending, key->str);
+    if (held) {
+        /* replace the superseded event, keeping its position */
+        g_free (held->raw);
+        held->raw  = packet->raw;
+        held->size = packet->size;
+        g_free (held->channel);
+        held->channel = packet->channel;
+
+        packet->raw     = NULL;
+        packet->channel = NULL;
+        gami_packet_free (packet);
+        g_string_free (key, TRUE);
+
+        priv->coalesced_events++;
+
+        return TRUE;
+    }
+
+    packet->coalesce_key = g_string_free (key, FALSE);
+    packet->enqueued     = get_current_time_usec ();
+
+    g_hash_table_insert (priv->coalesce_pending, packet->coalesce_key, packet);
+    g_queue_push_tail (priv->coalesce_queue, packet);
+
+    if (! priv->coalesce_source)
+        priv->coalesce_source = g_timeout_add (priv->coalesce_window,
+                                               (GSourceFunc) coalesce_timeout,
+                                               ami);
+
+    return TRUE;
+}
+
+/* variables which are expanded by Asterisk (functions like CALLERID(num))
+ * are never reported by VarSet and must not be cached */
+static gboolean
+variable_cacheable (const gchar *channel, const gchar *variable)
+{
+    return channel && variable
+           && g_ascii_strcasecmp (channel, "none")
+           && ! strchr (variable, '(');
+}
+
+static void
+cached_variable_free (GamiCachedVariable *var)
+{
+    g_free (var->name);
+    g_free (var->value);
+    g_free (var);
+}
+
+void
+gami_variable_cache_free (GamiVariableCache *cache)
+{
+    g_hash_table_unref (cache->links);
+    g_queue_foreach (cache->lru, (GFunc) cached_variable_free, NULL);
+    g_queue_free (cache->lru);
+    g_free (cache);
+}
+
+const gchar *
+lookup_cached_variable (GamiManager *ami,
+                        const gchar *channel,
+                        const gchar *variable)
+{
+    GamiVariableCache *cache;
+    GList             *link;
+
+    if (! ami->priv->variable_cache_size
+        || ! variable_cacheable (channel, variable))
+        return NULL;
+
+    cache = g_hash_table_lookup (ami->priv->variable_cache, channel);
+    if (! cache)
+        return NULL;
+
+    link = g_hash_table_lookup (cache->links, variable);
+    if (! link)
+        return NULL;
+
+    /* most recently used variables are kept at the head */
+    g_queue_unlink (cache->lru, link);
+    g_queue_push_head_link (cache->lru, link);
+
+    return ((GamiCachedVariable *) link->data)->value;
+}
+
+/* remember value of variable on channel; unless replace is set, only
+ * variables not yet known for a channel we have seen VarSet events for are
+ * stored, as otherwise the value could be outdated already */
+void
+store_cached_variable (GamiManager *ami,
+                       const gchar *channel,
+                       const gchar *variable,
+                       const gchar *value,
+                       gboolean replace)
+{
+    GamiVariableCache  *cache;
+    GamiCachedVariable *var;
+    GList              *link;
+
+    if (! ami->priv->variable_cache_size
+        || ! variable_cacheable (channel, variable))
+        return;
+
+    cache = g_hash_table_lookup (ami->priv->variable_cache, channel);
+    if (! cache) {
+        if (! replace)
+            return;
+
+        cache = g_new (GamiVariableCache, 1);
+        cache->links = g_hash_table_new (g_str_hash, g_str_equal);
+        cache->lru = g_queue_new ();
+        g_hash_table_insert (ami->priv->variable_cache,
+                             g_strdup (channel), cache);
+    }
+
+    link = g_hash_table_lookup (cache->links, variable);
+    if (link) {
+        if (! replace)
+            return;
+
+        var = link->data;
+        g_free (var->value);
+        var->value = g_strdup (value ? value : "");
+
+        g_queue_unlink (cache->lru, link);
+        g_queue_push_head_link (cache->lru, link);
+        return;
+    }
+
+    var = g_new (GamiCachedVariable, 1);
+    var->name = g_strdup (variable);
+    var->value = g_strdup (value ? value : "");
+    g_queue_push_head (cache->lru, var);
+    g_hash_table_insert (cache->links, var->name, cache->lru->head);
+
+    while (cache->lru->length > ami->priv->variable_cache_size) {
+        var = g_queue_pop_tail (cache->lru);
+        g_hash_table_remove (cache->links, var->name);
+        cached_variable_free (var);
+    }
+}
+
+void
+clear_variable_cache (GamiManager *ami)
+{
+    g_hash_table_remove_all (ami->priv->variable_cache);
+}
+
+/* keep the variable cache in sync with the server; this is done as packets
+ * are read, so that dropped or coalesced events are taken into account */
+static void
+update_variable_cache (GamiManager *ami,
+                       GamiPacket *packet,
+                       const gchar *event)
+{
+    gchar *channel, *variable, *value;
+
+    if (! ami->priv->variable_cache_size)
+        return;
+
+    if (! strcmp (event, "VarSet")) {
+        channel  = packet_header_value (packet->raw, "Channel");
+        variable = packet_header_value (packet->raw, "Variable");
+        value    = packet_header_value (packet->raw, "Value");
+
+        store_cached_variable (ami, channel, variable, value, TRUE);
+
+        g_free (channel);
+        g_free (variable);
+        g_free (value);
+    } else if (! strcmp (event, "Hangup")) {
+        channel = packet_header_value (packet->raw, "Channel");
+        if (channel)
+            g_hash_table_remove (ami->priv->variable_cache, channel);
+        g_free (channel);
+    } else if (! strcmp (event, "Rename")) {
+        GamiVariableCache *cache;
+        gchar             *old_name, *old_key;
+
+        old_name = packet_header_value (packet->raw, "Oldname");
+        channel  = packet_header_value (packet->raw, "Newname");
+
+        if (old_name && channel
+            && g_hash_table_lookup_extended (ami->priv->variable_cache,
+                                             old_name,
+                                             (gpointer *) &old_key,
+                                             (gpointer *) &cache)) {
+            g_hash_table_steal (ami->priv->variable_cache, old_name);
+            g_free (old_key);
+            g_hash_table_replace (ami->priv->variable_cache, channel, cache);
+            channel = NULL;
+        }
+
+        g_free (old_name);
+        g_free (channel);
+    }
+}
+
+static void
+enqueue_packet (GamiManager *ami, GamiPacket *packet)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    gchar              *event;
+
+    event = packet_event_name (packet->raw);
+
+    if (event) {
+        priv->received_events++;
+
+        update_variable_cache (ami, packet, event);
+        update_response_cache (ami, event);
+
+        if (priv->droppable_events
+            && g_hash_table_lookup (priv->droppable_events, event)
+            && packet_buffer_above_high (priv)) {
+            priv->dropped_events++;
+            gami_packet_free (packet);
+            g_free (event);
+            return;
+        }
+
+        packet->channel = packet_header_value (packet->raw, "Uniqueid");
+
+        if (coalesce_packet (ami, packet, event)) {
+            g_free (event);
+            return;
+        }
+
+        if (packet->channel && ! g_queue_is_empty (priv->coalesce_queue))
+            flush_coalesced_channel (ami, packet->channel);
+    }
+
+    push_packet (ami, packet, event);
+    g_free (event);
+}
+
+/* account for packet leaving its lane */
+static void
+release_packet_lane (GamiManagerPrivate *priv, GamiPacket *packet)
+{
+    priv->buffered_bytes -= packet->size;
+    priv->buffered_packets--;
+
+    if (packet->channel) {
+        guint *pending;
+
+        pending = g_hash_table_lookup (priv->channel_lanes, packet->channel);
+        if (pending && ! --pending [packet->lane]) {
+            guint i;
+
+            for (i = 0; i < N_PACKET_LANES && ! pending [i]; i++)
+                ;
+            if (i == N_PACKET_LANES)
+                g_hash_table_remove (priv->channel_lanes, packet->channel);
+        }
+    }
+}
+
+/* discard buffered events of droppable types to relieve the buffer before
+ * the socket has to be throttled */
+static void
+purge_droppable_packets (GamiManager *ami)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    gint                lane;
+
+    if (! priv->droppable_events)
+        return;
+
+    for (lane = 0; lane < GAMI_EVENT_PRIORITY_RESPONSE; lane++) {
+        GList *link,
+              *next;
+
+        for (link = priv->lanes [lane]->head; link; link = next) {
+            GamiPacket *packet = link->data;
+            gchar      *event;
+
+            next = link->next;
+
+            event = packet_event_name (packet->raw);
+            if (event && g_hash_table_lookup (priv->droppable_events, event)) {
+                g_queue_delete_link (priv->lanes [lane], link);
+                release_packet_lane (priv, packet);
+                gami_packet_free (packet);
+                priv->dropped_events++;
+            }
+            g_free (event);
+        }
+    }
+}
+
+static GamiPacket *
+dequeue_packet (GamiManager *ami)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    GamiPacket         *packet = NULL;
+    GamiLaneStats      *stats;
+    gint64              delay;
+    gint                lane;
+
+    /* drain lanes in priority order, responses first */
+    for (lane = N_PACKET_LANES - 1; lane >= 0 && ! packet; lane--)
+        packet = g_queue_pop_head (priv->lanes [lane]);
+
+    if (! packet)
+        return NULL;
+
+    release_packet_lane (priv, packet);
+
+    delay = get_current_time_usec () - packet->enqueued;
+    stats = &priv->lane_stats [packet->lane];
+    stats->delivered++;
+    stats->total_delay += delay;
+    if (delay > stats->max_delay)
+        stats->max_delay = delay;
+
+    return packet;
+}
+
+static gboolean
+is_command_header (const gchar *line)
+{
+    return g_str_has_prefix (line, "Response: ")
+           || g_str_has_prefix (line, "Message: ")
+           || g_str_has_prefix (line, "Privilege: ")
+           || g_str_has_prefix (line, "ActionID: ");
+}
+
+/*
+ * Find the output in text, which is (the start of, unless complete) a
+ * response to Command in one of the formats
+ *
+ *   Response: Follows           Response: Success
+ *   Privilege: Command          ActionID: 42
+ *   ActionID: 42                Message: Command output follows
+ *   output                      Output: output
+ *   --END COMMAND--             Output: more output
+ *
+ * Returns the ActionID, or NULL if text is no such response or its headers
+ * are incomplete
+ */
+static gchar *
+command_output_start (const gchar *text,
+                      gboolean complete,
+                      const gchar **body,
+                      gboolean *follows)
+{
+    const gchar *line, *end;
+    gchar       *action_id = NULL;
+
+    if (g_str_has_prefix (text, "Response: Follows\r\n"))
+        *follows = TRUE;
+    else if (g_str_has_prefix (text, "Response: Success\r\n"))
+        *follows = FALSE;
+    else
+        return NULL;
+
+    for (line = text; *line; line = *end ? end + 2 : end) {
+        if (*follows ? ! is_command_header (line)
+                     : g_str_has_prefix (line, "Output: "))
+            break;
+
+        end = strstr (line, "\r\n");
+        if (! end) {
+            if (! complete) {
+                g_free (action_id);
+                return NULL;
+            }
+            end = line + strlen (line);
+        }
+
+        if (g_str_has_prefix (line, "ActionID: ")) {
+            g_free (action_id);
+            action_id = g_strndup (line + 10, end - line - 10);
+        }
+    }
+
+    /* the first line of output may still turn out to be a header */
+    if (! complete
+        && (! *line || (*follows && ! strchr (line, '\n')))) {
+        g_free (action_id);
+        return NULL;
+    }
+
+    *body = line;
+    return action_id;
+}
+
+/* queue the output between start and end for the hook of the Command being
+ * cut, as plain text; the last piece ends the output */
+static void
+push_command_output (GamiManager *ami,
+                     const gchar *start,
+                     const gchar *end,
+                     gboolean last)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    GamiPacket         *packet;
+    GString            *output;
+
+    if (priv->command_output_follows) {
+        const gchar *footer;
+
+        footer = last ? g_strrstr_len (start, end - start, "--END COMMAND--")
+                      : NULL;
+        output = g_string_new_len (start, (footer ? footer : end) - start);
+    } else {
+        const gchar *line, *eol;
+
+        output = g_string_sized_new (end - start);
+        for (line = start; line < end; line = eol + 2) {
+            eol = g_strstr_len (line, end - line, "\r\n");
+            if (! eol)
+                eol = end;
+
+            if (eol - line >= 8 && ! strncmp (line, "Output: ", 8)) {
+                g_string_append_len (output, line + 8, eol - line - 8);
+                g_string_append_c (output, '\n');
+            }
+        }
+    }
+
+    if (! last && ! output->len) {
+        g_string_free (output, TRUE);
+        return;
+    }
+
+    packet = g_new0 (GamiPacket, 1);
+    packet->raw = g_strconcat ("ActionID: ", priv->command_output_id, NULL);
+    packet->size = strlen (packet->raw) + output->len;
+    packet->output = g_string_free (output, FALSE);
+    packet->partial = ! last;
+
+    push_packet (ami, packet, NULL);
+}
+
+/*
+ * Hand out the output of a pending Command from text, which is a complete
+ * packet if complete is set or the incomplete rest of the receive buffer,
+ * so that large output neither waits for its end nor piles up in the
+ * buffer. Returns FALSE if text is not part of a Command response; otherwise
+ * *consumed is set to the length of the text handed out.
+ */
+static gboolean
+split_command_output (GamiManager *ami,
+                      gchar *text,
+                      gboolean complete,
+                      gsize *consumed)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    const gchar        *body;
+    const gchar        *cut;
+
+    if (! priv->command_output_id) {
+        gchar    *action_id;
+        gboolean  follows;
+
+        if (! g_hash_table_size (priv->command_streams))
+            return FALSE;
+
+        action_id = command_output_start (text, complete, &body, &follows);
+        if (! action_id
+            || ! g_hash_table_lookup_extended (priv->command_streams,
+                                               action_id, NULL, NULL)) {
+            g_free (action_id);
+            return FALSE;
+        }
+
+        priv->command_output_id = action_id;
+        priv->command_output_follows = follows;
+    } else
+        body = text;
+
+    if (complete) {
+        push_command_output (ami, body, body + strlen (body), TRUE);
+
+        g_hash_table_remove (priv->command_streams, priv->command_output_id);
+        g_free (priv->command_output_id);
+        priv->command_output_id = NULL;
+
+        *consumed = strlen (text);
+        return TRUE;
+    }
+
+    /* never cut into a "\r\n" which may start the packet separator: CLI
+     * output ends its lines in "\n", "Output:" headers in "\r\n" */
+    if (priv->command_output_follows) {
+        for (cut = body + strlen (body); cut > body; cut--)
+            if (cut [-1] == '\n' && (cut - 1 == body || cut [-2] != '\r'))
+                break;
+    } else {
+        cut = g_strrstr (body, "\r\n");
+        if (! cut)
+            cut = body;
+    }
+
+    push_command_output (ami, body, cut, FALSE);
+
+    *consumed = cut - text;
+    return TRUE;
+}
+
+/* move all complete packets from the receive buffer to the packet buffer;
+ * data before offset has been scanned for packet separators before */
+static void
+split_packets (GamiManager *ami, gsize offset)
+{
+    GString *buffer = ami->priv->recv_buffer;
+    gchar   *packet,
+            *end;
+    gsize    consumed;
+
+    packet = buffer->str;
+    end    = buffer->str + (offset > 3 ? offset - 3 : 0);
+
+    while ((end = g_strstr_len (end,
+                                buffer->str + buffer->len - end,
+                                "\r\n\r\n"))) {
+        *end = '\0';
+        if (! split_command_output (ami, packet, TRUE, &consumed))
+            enqueue_packet (ami, gami_packet_new (packet));
+        packet = end = end + 4;
+    }
+
+    if (split_command_output (ami, packet, FALSE, &consumed))
+        packet += consumed;
+
+    g_string_erase (buffer, 0, packet - buffer->str);
+}
+
+static void
+schedule_packet_processing (GamiManager *ami)
+{
+    if (ami->priv->process_source || ! ami->priv->buffered_packets)
+        return;
+
+    ami->priv->process_source = g_timeout_add (0,
+                                               (GSourceFunc) process_packets,
+                                               ami);
+}
+
+void
+add_socket_watch (GamiManager *ami)
+{
+    ami->priv->socket_watch = g_io_add_watch (ami->priv->socket,
+                                              G_IO_IN | G_IO_PRI
+                                              | G_IO_ERR | G_IO_HUP,
+                                              (GIOFunc) dispatch_ami,
+                                              ami);
+}
+
+void
+release_backpressure (GamiManager *ami)
+{
+    if (! ami->priv->throttled || ! packet_buffer_below_low (ami->priv))
+        return;
+
+    ami->priv->throttled = FALSE;
+    if (ami->priv->connected && ! ami->priv->socket_watch)
+        add_socket_watch (ami);
+
+    g_signal_emit (ami, signals [BACKPRESSURE_OFF], 0);
+}
+
+gboolean
+dispatch_ami (GIOChannel *chan, GIOCondition cond, GamiManager *ami)
+{
+    GIOStatus status = G_IO_STATUS_NORMAL;
+
+    if (cond & (G_IO_IN | G_IO_PRI)) {
+        GString      *buffer      = ami->priv->recv_buffer;
+        gsize         channel_buffer_size,
+                      total_read  = 0;
+        gint64        start,
+                      elapsed;
+        gboolean      budget_hit;
+        GError       *error       = NULL;
+
+        start = get_current_time_usec ();
+        channel_buffer_size = g_io_channel_get_buffer_size (chan);
+
+        do {
+            gsize bytes_read,
+                  offset;
+
+            offset = buffer->len;
+            g_string_set_size (buffer, offset + channel_buffer_size);
+
+            status = g_io_channel_read_chars (chan,
+                                              buffer->str + offset,
+                                              channel_buffer_size,
+                                              &bytes_read,
+                                              &error);
+            g_string_truncate (buffer, offset + bytes_read);
+
+            if (bytes_read) {
+                g_log (ami->priv->log_domain, GAMI_LOG_LEVEL_NET_RX,
+                       "%s", buffer->str + offset);
+
+                split_packets (ami, offset);
+            }
+
+            total_read += bytes_read;
+            budget_hit  = read_budget_exhausted (ami->priv, total_read, start);
+
+        } while (status == G_IO_STATUS_NORMAL
+                 && ! budget_hit
+                 && ! packet_buffer_above_high (ami->priv));
+
+        /* when the budget is used up, yield to other main loop sources - the
+         * watch will trigger again for the data left in the channel */
+        if (status == G_IO_STATUS_NORMAL && budget_hit)
+            ami->priv->read_budget_hits++;
+
+        elapsed = get_current_time_usec () - start;
+        if (elapsed > ami->priv->max_dispatch_time)
+            ami->priv->max_dispatch_time = elapsed;
+
+        if (status == G_IO_STATUS_ERROR) {
+            g_warning ("An error occurred during package reception%s%s\n",
+                       error ? ": " : "",
+                       error ? error->message : "");
+            if (error)
+                g_error_free (error);
+        }
+
+        schedule_packet_processing (ami);
+
+        if (packet_buffer_above_high (ami->priv))
+            purge_droppable_packets (ami);
+
+        if (status == G_IO_STATUS_NORMAL
+            && packet_buffer_above_high (ami->priv)) {
+            /* stop reading until the consumer caught up, so that TCP flow
+             * control pushes back on the server */
+            ami->priv->throttled    = TRUE;
+            ami->priv->socket_watch = 0;
+            g_signal_emit (ami, signals [BACKPRESSURE_ON], 0);
+
+            return FALSE;
+        }
+    }
+
+    if (cond & (G_IO_HUP | G_IO_ERR) || status == G_IO_STATUS_EOF) {
+        ami->priv->connected = FALSE;
+        ami->priv->socket_watch = 0;
+        clear_variable_cache (ami);
+        /* requests after reconnecting must not wait for lost responses */
+        g_hash_table_remove_all (ami->priv->in_flight);
+        invalidate_cached_responses (ami, NULL);
+        g_hash_table_remove_all (ami->priv->command_streams);
+        g_free (ami->priv->command_output_id);
+        ami->priv->command_output_id = NULL;
+        g_signal_emit (ami, signals [DISCONNECTED], 0);
+        //g_idle_add ((GSourceFunc) reconnect_socket, ami);
+
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+set_current_packet (GHook *hook, gpointer packet)
+{
+    GamiHookData *data;
+
+    data = (GamiHookData *) hook->data;
+    data->packet = (GamiPacket *) packet;
+}
+
+gboolean
+process_packets (GamiManager *ami)
+{
+    GamiManagerPrivate *priv = ami->priv;
+    GamiPacket         *packet;
+    guint               processed = 0;
+
+    while (processed < PACKET_BATCH_SIZE && (packet = dequeue_packet (ami))) {
+        g_hook_list_marshal (&priv->packet_hooks,
+                             FALSE,
+                             set_current_packet,
+                             packet);
+        g_hook_list_invoke_check (&priv->packet_hooks,
+                                  FALSE);
+        gami_packet_free (packet);
+        processed++;
+    }
+
+    if (priv->event_batch->len) {
+        g_signal_emit (ami, signals [EVENTS], 0, priv->event_batch);
+        g_ptr_array_set_size (priv->event_batch, 0);
+    }
+
+    release_backpressure (ami);
+
+    if (! priv->buffered_packets) {
+        priv->process_source = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+static void
+getvar_bulk_add (GHashTable *table,
+                 const gchar *channel,
+                 const gchar *variable,
+                 const gchar *value)
+{
+    GHashTable *vars;
+
+    vars = g_hash_table_lookup (table, channel);
+    if (! vars) {
+        vars = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                      g_free, g_free);
+        g_hash_table_insert (table, g_strdup (channel), vars);
+    }
+
+    g_hash_table_insert (vars, g_strdup (variable), g_strdup (value));
+}
+
+GamiGetvarBulk *
+gami_getvar_bulk_new (GamiManager *ami,
+                      const gchar **channels,
+                      const gchar **variables)
+{
+    GamiGetvarBulk *bulk;
+    guint           i;
+
+    bulk = g_new0 (GamiGetvarBulk, 1);
+    bulk->ami = ami;
+
+    for (i = 0; channels [i] && variables [i]; i++)
+        ;
+    bulk->n_items = i;
+    bulk->channels = g_new0 (gchar *, i + 1);
+    bulk->variables = g_new0 (gchar *, i + 1);
+    for (i = 0; i < bulk->n_items; i++) {
+        bulk->channels [i] = g_strdup (channels [i]);
+        bulk->variables [i] = g_strdup (variables [i]);
+    }
+
+    bulk->values = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                          (GDestroyNotify) g_hash_table_unref);
+    bulk->errors = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                          (GDestroyNotify) g_hash_table_unref);
+
+    return bulk;
+}
+
+void
+gami_getvar_bulk_free (GamiGetvarBulk *bulk)
+{
+    g_strfreev (bulk->channels);
+    g_strfreev (bulk->variables);
+    g_hash_table_unref (bulk->values);
+    g_hash_table_unref (bulk->errors);
+    g_free (bulk);
+}
+
+static void
+append_param (gchar *name, gchar *value, GString *action)
+{
+    g_string_append_printf (action, "%s: %s\r\n", name, value);
+}
+
+void
+send_list_action (GamiManager *ami,
+                  GamiAsyncFunc func,
+                  const gchar *action,
+                  const GHashTable *params,
+                  GamiListStream *stream,
+                  const gchar *action_id,
+                  GAsyncReadyCallback callback,
+                  gpointer user_data)
+{
+    GString *str;
+    GError  *error = NULL;
+    gchar   *id;
+
+    g_assert (ami->priv->connected);
+
+    id = set_action_id (action_id);
+
+    str = g_string_new ("Action: ");
+    g_string_append_printf (str, "%s\r\nActionID: %s\r\n", action, id);
+    if (params)
+        g_hash_table_foreach ((GHashTable *) params, (GHFunc) append_param,
+                              str);
+    g_string_append (str, "\r\n");
+
+    send_action_string (ami, str->str, &error);
+    g_string_free (str, TRUE);
+
+    stream->hook_id = setup_action_hook (ami,
+                                         func,
+                                         stream_hook,
+                                         stream,
+                                         id,
+                                         callback,
+                                         user_data,
+                                         error);
+}
+
+void
+send_command_action (GamiManager *ami,
+                     GamiAsyncFunc func,
+                     GamiCommandStream *stream,
+                     const gchar *command,
+                     const gchar *action_id,
+                     GAsyncReadyCallback callback,
+                     gpointer user_data)
+{
+    GError *error = NULL;
+    gchar  *action, *id = NULL;
+
+    g_assert (ami->priv->connected);
+
+    action = build_action_string ("Command",
+                                  &id,
+                                  "Command", command,
+                                  "ActionID", action_id,
+                                  NULL);
+    send_action_string (ami, action, &error);
+    g_free (action);
+
+    /* have the output cut out of the receive buffer as it arrives */
+    if (! error)
+        g_hash_table_insert (ami->priv->command_streams, g_strdup (id), NULL);
+
+    setup_action_hook (ami,
+                       func,
+                       command_hook,
+                       stream,
+                       id,
+                       callback,
+                       user_data,
+                       error);
+}
+
+/* send as many queued GetVar actions of bulk as the window allows, all in a
+ * single write; items which could not be sent are recorded as failed */
+static gboolean
+send_getvar_bulk (GamiGetvarBulk *bulk, const gchar *prefix, GError **error)
+{
+    GString *actions;
+    GError  *send_error = NULL;
+    guint    first;
+
+    if (bulk->next == bulk->n_items
+        || bulk->in_flight >= GETVAR_BULK_WINDOW)
+        return TRUE;
+
+    actions = g_string_new ("");
+    first = bulk->next;
+
+    while (bulk->next < bulk->n_items
+           && bulk->in_flight < GETVAR_BULK_WINDOW) {
+        const gchar *channel = bulk->channels [bulk->next];
+
+        g_string_append_printf (actions,
+                                "Action: GetVar\r\n"
+                                "Variable: %s\r\n",
+                                bulk->variables [bulk->next]);
+        if (*channel)
+            g_string_append_printf (actions, "Channel: %s\r\n", channel);
+        g_string_append_printf (actions, "ActionID: %s-%u\r\n\r\n",
+                                prefix, bulk->next);
+
+        bulk->next++;
+        bulk->in_flight++;
+    }
+
+    send_action_string (bulk->ami, actions->str, &send_error);
+    g_string_free (actions, TRUE);
+
+    if (send_error) {
+        guint i;
+
+        /* nothing of this write can be expected to be answered */
+        bulk->in_flight -= bulk->next - first;
+        for (i = first; i < bulk->n_items; i++)
+            getvar_bulk_add (bulk->errors,
+                             bulk->channels [i],
+                             bulk->variables [i],
+                             send_error->message);
+        bulk->next = bulk->n_items;
+
+        g_propagate_error (error, send_error);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+start_getvar_bulk (GamiManager *ami,
+                   GamiAsyncFunc func,
+                   GamiGetvarBulk *bulk,
+                   const gchar *action_id,
+                   GAsyncReadyCallback callback,
+                   gpointer user_data)
+{
+    GSimpleAsyncResult *simple;
+    GError             *error = NULL;
+    gchar              *prefix;
+
+    g_assert (ami->priv->connected);
+
+    if (! bulk->n_items) {
+        simple = g_simple_async_result_new (G_OBJECT (ami),
+                                            callback,
+                                            user_data,
+                                            func);
+        g_simple_async_result_set_op_res_gpointer (simple, bulk,
+                                                   (GDestroyNotify)
+                                                   gami_getvar_bulk_free);
+        g_simple_async_result_complete_in_idle (simple);
+        g_object_unref (simple);
+        return;
+    }
+
+    prefix = set_action_id (action_id);
+
+    if (! send_getvar_bulk (bulk, prefix, &error)) {
+        gami_getvar_bulk_free (bulk);
+        bulk = NULL;
+    }
+
+    setup_action_hook (ami,
+                       func,
+                       getvar_bulk_hook,
+                       bulk,
+                       prefix,
+                       callback,
+                       user_data,
+                       error);
+}
+
+/* UpdateConfig names of the values of GamiConfigAction */
+static const gchar *config_actions [] = {
+    "NewCat",
+    "RenameCat",
+    "DelCat",
+    "EmptyCat",
+    "Update",
+    "Delete",
+    "Append"
+};
+
+GamiConfigUpdate *
+gami_config_update_new (GamiManager *ami,
+                        const gchar *src_filename,
+                        const gchar *dst_filename,
+                        const GSList *changes,
+                        const gchar *reload)
+{
+    GamiConfigUpdate *update;
+
+    update = g_new0 (GamiConfigUpdate, 1);
+    update->ami = ami;
+    update->src_filename = g_strdup (src_filename);
+    update->dst_filename = g_strdup (dst_filename ? dst_filename
+                                                  : src_filename);
+    update->reload = g_strdup (reload);
+
+    update->changes = g_ptr_array_new ();
+    for (; changes; changes = changes->next)
+        g_ptr_array_add (update->changes,
+                         gami_config_change_copy (changes->data));
+
+    return update;
+}
+
+void
+gami_config_update_free (GamiConfigUpdate *update)
+{
+    g_free (update->src_filename);
+    g_free (update->dst_filename);
+    g_free (update->reload);
+    g_ptr_array_foreach (update->changes, (GFunc) gami_config_change_free,
+                         NULL);
+    g_ptr_array_free (update->changes, TRUE);
+    g_free (update);
+}
+
+/* send the next changes of update which fit into UPDATE_CONFIG_MAX_HEADERS
+ * as a single UpdateConfig action with the ActionID <prefix>-<chunk>; the
+ * server numbers changes per action, so every chunk starts at 000000.
+ * Later chunks read the file written by the previous one, so they do not
+ * start over from an unchanged source file */
+static gboolean
+send_config_update (GamiConfigUpdate *update,
+                    const gchar *prefix,
+                    GError **error)
+{
+    GString *action;
+    GError  *send_error = NULL;
+    guint    headers, n;
+
+    action = g_string_new ("Action: UpdateConfig\r\n");
+    g_string_append_printf (action,
+                            "ActionID: %s-%u\r\n"
+                            "SrcFilename: %s\r\n"
+                            "DstFilename: %s\r\n",
+                            prefix, update->chunk,
+                            update->chunk ? update->dst_filename
+                                          : update->src_filename,
+                            update->dst_filename);
+
+    /* the above, plus Reload in the last chunk */
+    headers = 5;
+
+    update->first = update->next;
+    for (n = 0; update->next < update->changes->len; n++, update->next++) {
+        GamiConfigChange *change;
+
+        change = g_ptr_array_index (update->changes, update->next);
+
+        headers += 2 + (change->variable != NULL) + (change->value != NULL)
+                     + (change->match != NULL);
+        if (n && headers > UPDATE_CONFIG_MAX_HEADERS)
+            break;
+
+        g_string_append_printf (action,
+                                "Action-%06u: %s\r\n"
+                                "Cat-%06u: %s\r\n",
+                                n, config_actions [change->action],
+                                n, change->category);
+        if (change->variable)
+            g_string_append_printf (action, "Var-%06u: %s\r\n",
+                                    n, change->variable);
+        if (change->value)
+            g_string_append_printf (action, "Value-%06u: %s\r\n",
+                                    n, change->value);
+        if (change->match)
+            g_string_append_printf (action, "Match-%06u: %s\r\n",
+                                    n, change->match);
+    }
+
+    if (update->next == update->changes->len && update->reload)
+        g_string_append_printf (action, "Reload: %s\r\n", update->reload);
+    g_string_append (action, "\r\n");
+
+    update->chunk++;
+
+    send_action_string (update->ami, action->str, &send_error);
+    g_string_free (action, TRUE);
+
+    if (send_error) {
+        g_propagate_error (error, send_error);
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void
+start_config_update (GamiManager *ami,
+                     GamiAsyncFunc func,
+                     GamiConfigUpdate *update,
+                     const gchar *action_id,
+                     GAsyncReadyCallback callback,
+                     gpointer user_data)
+{
+    GError *error = NULL;
+    gchar  *prefix;
+
+    g_assert (ami->priv->connected);
+
+    prefix = set_action_id (action_id);
+
+    if (! send_config_update (update, prefix, &error)) {
+        gami_config_update_free (update);
+        update = NULL;
+    }
+
+    setup_action_hook (ami,
+                       func,
+                       config_update_hook,
+                       update,
+                       prefix,
+                       callback,
+                       user_data,
+                       error);
+}
+
+void
+set_sync_result (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    GAMI_MANAGER (source)->priv->sync_result = g_object_ref (result);
+}
+
+gboolean
+reconnect_socket (GamiManager *ami)
+{
+    GError *error = NULL;
+
+    close (g_io_channel_unix_get_fd (ami->priv->socket));
+    g_io_channel_shutdown (ami->priv->socket, TRUE, NULL);
+    g_io_channel_unref (ami->priv->socket);
+
+    return ! gami_manager_connect (ami, &error); /* try again if connection
+                                                    failed */
+}
+
+GamiPacket *
+gami_packet_new (const gchar *raw_text)
+{
+    GamiPacket *pkt;
 
     pkt = g_new0 (GamiPacket, 1);
     pkt->raw = g_strdup (raw_text);
+    pkt->size = strlen (pkt->raw);
     pkt->parsed = NULL;
     pkt->handled = FALSE;
 
@@ -532,10 +2401,144 @@ gami_packet_free (GamiPacket *packet)
 
     if (packet->parsed)
         g_hash_table_unref (packet->parsed);
+    g_free (packet->coalesce_key);
+    g_free (packet->channel);
+    g_free (packet->output);
     g_free (packet->raw);
     g_free (packet);
 }
 
+GamiListStream *
+gami_list_stream_new (GamiManager *ami,
+                      const gchar *complete_event,
+                      GamiListItemFunc func,
+                      gpointer user_data)
+{
+    GamiListStream *stream;
+
+    stream = g_new0 (GamiListStream, 1);
+    stream->ami = ami;
+    stream->complete_event = g_strdup (complete_event);
+    stream->func = func;
+    stream->user_data = user_data;
+
+    return stream;
+}
+
+void
+gami_list_stream_free (GamiListStream *stream)
+{
+    if (stream->idle_source)
+        g_source_remove (stream->idle_source);
+    g_free (stream->complete_event);
+    g_free (stream);
+}
+
+GamiCommandStream *
+gami_command_stream_new (GamiManager *ami,
+                         GamiCommandOutputFunc func,
+                         gpointer user_data)
+{
+    GamiCommandStream *stream;
+
+    stream = g_new0 (GamiCommandStream, 1);
+    stream->ami = ami;
+    stream->func = func;
+    stream->user_data = user_data;
+    stream->output = g_string_new (NULL);
+
+    return stream;
+}
+
+void
+gami_command_stream_free (GamiCommandStream *stream)
+{
+    if (stream->output)
+        g_string_free (stream->output, TRUE);
+    g_free (stream);
+}
+
+/* whether packets for the action of stream wait in the packet buffer; as
+ * they carry an ActionID, they are queued with the responses */
+static gboolean
+list_stream_buffered (GamiListStream *stream)
+{
+    GamiManagerPrivate *priv = stream->ami->priv;
+    GamiHookData       *hook_data;
+    GHook              *hook;
+    GList              *link;
+
+    hook = g_hook_get (&priv->packet_hooks, stream->hook_id);
+    if (! hook)
+        return FALSE;
+    hook_data = hook->data;
+
+    for (link = priv->lanes [GAMI_EVENT_PRIORITY_RESPONSE]->head;
+         link;
+         link = link->next) {
+        GamiPacket *packet = link->data;
+        gchar      *action_id;
+        gboolean    match;
+
+        action_id = packet_header_value (packet->raw, "ActionID");
+        match = ! g_strcmp0 (action_id, hook_data->action_id);
+        g_free (action_id);
+
+        if (match)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+/* complete a list action which has no completion event once no more items
+ * arrived for the list timeout; unrelated traffic does not delay it */
+static gboolean
+list_stream_timeout (GamiListStream *stream)
+{
+    GamiManager *ami = stream->ami;
+    gint64       idle, timeout;
+
+    timeout = (gint64) MAX (ami->priv->list_timeout, 1) * 1000;
+    idle = get_current_time_usec () - stream->last_item;
+
+    /* wait for the rest of the timeout after the last item */
+    if (idle < timeout) {
+        stream->idle_source = g_timeout_add ((timeout - idle + 999) / 1000,
+                                             (GSourceFunc) list_stream_timeout,
+                                             stream);
+        return FALSE;
+    }
+
+    /* items of the list may still be waiting in the packet buffer; check
+     * again after a full timeout rather than polling at the last interval */
+    if (list_stream_buffered (stream)) {
+        stream->idle_source = g_timeout_add (MAX (ami->priv->list_timeout, 1),
+                                             (GSourceFunc) list_stream_timeout,
+                                             stream);
+        return FALSE;
+    }
+
+    g_simple_async_result_set_op_res_gssize (stream->result, stream->n_items);
+    g_simple_async_result_complete_in_idle (stream->result);
+
+    /* destroying the hook frees the stream */
+    stream->idle_source = 0;
+    g_hook_destroy (&ami->priv->packet_hooks, stream->hook_id);
+
+    return FALSE;
+}
+
+static void
+arm_list_stream_timeout (GamiListStream *stream)
+{
+    stream->last_item = get_current_time_usec ();
+    stream->idle_source =
+        g_timeout_add (MAX (stream->ami->priv->list_timeout, 1),
+                       (GSourceFunc) list_stream_timeout,
+                       stream);
+}
+
 GamiHookData *
 gami_hook_data_new (GAsyncResult *result,
                     gchar *action_id,
@@ -559,8 +2562,18 @@ gami_hook_data_free (GamiHookData *data)
         g_object_unref (data->result);
     if (data->action_id)
         g_free (data->action_id);
+    if (data->items)
+        free_list_result (data->items);
+    if (data->text)
+        g_string_free (data->text, TRUE);
+    if (data->handler_data_free && data->handler_data)
+        data->handler_data_free (data->handler_data);
+    if (data->entries) {
+        g_ptr_array_foreach (data->entries,
+                             (GFunc) gami_queue_status_entry_unref, NULL);
+        g_ptr_array_free (data->entries, TRUE);
+    }
     g_free (data);
-    /* FIXME: handler_data ? */
 }
 
 void
@@ -621,6 +2634,7 @@ emit_event (gpointer data)
 {
     GamiManager *ami;
     GHashTable  *pkt;
+    GQuark       detail;
 
     pkt = ((GamiHookData *) data)->packet->parsed;
     ami = (GamiManager *) ((GamiHookData *) data)->handler_data;
@@ -637,6 +2651,21 @@ emit_event (gpointer data)
 
     g_signal_emit (ami, signals [EVENT], 0, pkt);
 
+    /* decode typed events once for all handlers */
+    detail = g_quark_from_string (g_hash_table_lookup (pkt, "Event"));
+    if (g_signal_has_handler_pending (ami, signals [TYPED_EVENT], detail,
+                                      FALSE)) {
+        GamiEvent *event;
+
+        event = gami_event_new (pkt);
+        g_signal_emit (ami, signals [TYPED_EVENT], detail, event);
+        gami_event_unref (event);
+    }
+
+    /* collect events for the batched ::events signal */
+    if (g_signal_has_handler_pending (ami, signals [EVENTS], 0, FALSE))
+        g_ptr_array_add (ami->priv->event_batch, g_hash_table_ref (pkt));
+
     return TRUE;
 }
 
@@ -689,51 +2718,417 @@ bool_hook (gpointer data)
 }
 
 gboolean
-string_hook (gpointer data)
+string_hook (gpointer data)
+{
+    GamiPacket *packet;
+    gchar *response, *result, *action_id, *message;
+    GSimpleAsyncResult *simple;
+
+    packet = ((GamiHookData *) data)->packet;
+
+    if (packet->handled)
+        return TRUE;
+    g_return_val_if_fail (packet->parsed != NULL, TRUE);
+
+    response = g_hash_table_lookup (packet->parsed, "Response");
+
+    if (! response)
+        return TRUE;
+
+    action_id = g_hash_table_lookup (packet->parsed, "ActionID");
+    if (action_id
+        && g_strcmp0 (action_id, ((GamiHookData *) data)->action_id))
+        return TRUE;
+
+    packet->handled = TRUE;
+    result = g_hash_table_lookup (packet->parsed,
+                                  ((GamiHookData *) data)->handler_data);
+    message = g_hash_table_lookup (packet->parsed, "Message");
+
+    simple = (GSimpleAsyncResult *) ((GamiHookData *) data)->result;
+
+    if (! g_strcmp0 (g_hash_table_lookup (packet->parsed, "Response"),
+                     "Success")
+        && result)
+        g_simple_async_result_set_op_res_gpointer (simple,
+                                                   g_strdup (result),
+                                                   g_free);
+    else
+        g_simple_async_result_set_error (simple,
+                                         GAMI_ERROR,
+                                         GAMI_ERROR_FAILED,
+                                         "%s",
+                                         message ?  message : "Action failed");
+
+    g_simple_async_result_complete_in_idle (simple);
+
+    return FALSE;
+}
+
+gboolean
+getvar_bulk_hook (gpointer data)
+{
+    GamiHookData       *hook_data = data;
+    GamiGetvarBulk     *bulk;
+    GamiPacket         *packet;
+    GSimpleAsyncResult *simple;
+    const gchar        *action_id, *value;
+    gchar              *end;
+    gsize               len;
+    guint               item;
+
+    packet = hook_data->packet;
+
+    if (packet->handled)
+        return TRUE;
+    g_return_val_if_fail (packet->parsed != NULL, TRUE);
+
+    if (! g_hash_table_lookup (packet->parsed, "Response"))
+        return TRUE;
+
+    /* responses carry the ActionID <prefix>-<item> */
+    action_id = g_hash_table_lookup (packet->parsed, "ActionID");
+    len = strlen (hook_data->action_id);
+    if (! action_id
+        || strncmp (action_id, hook_data->action_id, len)
+        || action_id [len] != '-')
+        return TRUE;
+
+    bulk = hook_data->handler_data;
+    item = strtoul (action_id + len + 1, &end, 10);
+    if (*end || item >= bulk->next)
+        return TRUE;
+
+    packet->handled = TRUE;
+    bulk->in_flight--;
+
+    value = g_hash_table_lookup (packet->parsed, "Value");
+    if (! g_strcmp0 (g_hash_table_lookup (packet->parsed, "Response"),
+                     "Success")
+        && value)
+        getvar_bulk_add (bulk->values,
+                         bulk->channels [item],
+                         bulk->variables [item],
+                         value);
+    else {
+        const gchar *message;
+
+        message = g_hash_table_lookup (packet->parsed, "Message");
+        getvar_bulk_add (bulk->errors,
+                         bulk->channels [item],
+                         bulk->variables [item],
+                         message ? message : "Action failed");
+    }
+
+    /* refill the window once half of it has been answered */
+    if (bulk->in_flight <= GETVAR_BULK_WINDOW / 2)
+        send_getvar_bulk (bulk, hook_data->action_id, NULL);
+
+    if (bulk->in_flight || bulk->next < bulk->n_items)
+        return TRUE;
+
+    simple = (GSimpleAsyncResult *) hook_data->result;
+    g_simple_async_result_set_op_res_gpointer (simple, bulk,
+                                               (GDestroyNotify)
+                                               gami_getvar_bulk_free);
+    g_simple_async_result_complete_in_idle (simple);
+
+    return FALSE;
+}
+
+/* chunks of a config update are sent one at a time, so that a failing
+ * chunk stops the update before later changes are applied on top of it */
+gboolean
+config_update_hook (gpointer data)
+{
+    GamiHookData       *hook_data = data;
+    GamiConfigUpdate   *update;
+    GamiPacket         *packet;
+    GSimpleAsyncResult *simple;
+    GError             *error = NULL;
+    const gchar        *action_id, *message;
+    gchar              *end;
+    gsize               len;
+    guint               chunk;
+
+    packet = hook_data->packet;
+
+    if (packet->handled)
+        return TRUE;
+    g_return_val_if_fail (packet->parsed != NULL, TRUE);
+
+    if (! g_hash_table_lookup (packet->parsed, "Response"))
+        return TRUE;
+
+    /* responses carry the ActionID <prefix>-<chunk> */
+    update = hook_data->handler_data;
+    action_id = g_hash_table_lookup (packet->parsed, "ActionID");
+    len = strlen (hook_data->action_id);
+    if (! action_id
+        || strncmp (action_id, hook_data->action_id, len)
+        || action_id [len] != '-')
+        return TRUE;
+
+    chunk = strtoul (action_id + len + 1, &end, 10);
+    if (*end || chunk + 1 != update->chunk)
+        return TRUE;
+
+    packet->handled = TRUE;
+
+    /* whatever happened, cached copies of the file may be outdated now */
+    invalidate_cached_responses (update->ami, "GetConfig");
+    invalidate_cached_responses (update->ami, "GetConfigJSON");
+
+    simple = (GSimpleAsyncResult *) hook_data->result;
+
+    /* the result holds the index of the failed chunk, -1 on success; there
+     * is no way to roll back the chunks the server has already applied */
+    if (g_strcmp0 (g_hash_table_lookup (packet->parsed, "Response"),
+                   "Success")) {
+        message = g_hash_table_lookup (packet->parsed, "Message");
+        g_simple_async_result_set_error (simple,
+                                         GAMI_ERROR,
+                                         GAMI_ERROR_FAILED,
+                                         "%s (in update %u of %s, "
+                                         "%u of %u changes applied)",
+                                         message ? message : "Action failed",
+                                         chunk + 1,
+                                         update->dst_filename,
+                                         update->first,
+                                         update->changes->len);
+        g_simple_async_result_set_op_res_gssize (simple, chunk);
+    } else if (update->next < update->changes->len) {
+        if (send_config_update (update, hook_data->action_id, &error))
+            return TRUE;
+
+        g_simple_async_result_set_from_error (simple, error);
+        g_simple_async_result_set_op_res_gssize (simple, update->chunk - 1);
+        g_error_free (error);
+    } else
+        g_simple_async_result_set_op_res_gssize (simple, -1);
+
+    gami_config_update_free (update);
+    g_simple_async_result_complete_in_idle (simple);
+
+    return FALSE;
+}
+
+/* collect the "Variable: name=value" headers of a Status event, which do not
+ * survive parsing into a hash table as they repeat */
+static GHashTable *
+parse_status_variables (const gchar *raw)
+{
+    GHashTable  *variables;
+    gchar      **lines, **line;
+
+    variables = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                       g_free, g_free);
+
+    lines = g_strsplit (raw, "\r\n", -1);
+    for (line = lines; *line; line++) {
+        const gchar *var;
+        gchar       *sep;
+
+        if (g_str_has_prefix (*line, "Variable: "))
+            var = *line + strlen ("Variable: ");
+        else if (g_str_has_prefix (*line, "ChanVariable: "))
+            var = *line + strlen ("ChanVariable: ");
+        else
+            continue;
+
+        sep = strchr (var, '=');
+        if (sep)
+            g_hash_table_insert (variables,
+                                 g_strndup (var, sep - var),
+                                 g_strdup (sep + 1));
+    }
+    g_strfreev (lines);
+
+    return variables;
+}
+
+gboolean
+status_variables_hook (gpointer data)
+{
+    GamiHookData       *hook_data = data;
+    GamiStatusStream   *stream;
+    GamiPacket         *packet;
+    GSimpleAsyncResult *simple;
+    GHashTable         *pkt, *variables;
+    const gchar        *response, *event;
+
+    packet = hook_data->packet;
+
+    if (packet->handled)
+        return TRUE;
+    g_return_val_if_fail (packet->parsed != NULL, TRUE);
+
+    pkt = packet->parsed;
+    if (g_strcmp0 (g_hash_table_lookup (pkt, "ActionID"),
+                   hook_data->action_id))
+        return TRUE;
+
+    packet->handled = TRUE;
+    stream = hook_data->handler_data;
+    simple = (GSimpleAsyncResult *) hook_data->result;
+
+    if ((response = g_hash_table_lookup (pkt, "Response"))) {
+        const gchar *message;
+
+        if (! g_strcmp0 (response, "Success"))
+            return TRUE;
+
+        message = g_hash_table_lookup (pkt, "Message");
+        g_simple_async_result_set_error (simple,
+                                         GAMI_ERROR,
+                                         GAMI_ERROR_FAILED,
+                                         "%s",
+                                         message ? message : "Action failed");
+        g_simple_async_result_complete_in_idle (simple);
+
+        return FALSE;
+    }
+
+    event = g_hash_table_lookup (pkt, "Event");
+
+    if (! g_strcmp0 (event, "StatusComplete")) {
+        g_simple_async_result_set_op_res_gssize (simple, stream->n_channels);
+        g_simple_async_result_complete_in_idle (simple);
+
+        return FALSE;
+    }
+
+    if (g_strcmp0 (event, "Status") || stream->stopped)
+        return TRUE;
+
+    stream->n_channels++;
+
+    g_hash_table_remove (pkt, "Event");
+    g_hash_table_remove (pkt, "Variable");
+    g_hash_table_remove (pkt, "ChanVariable");
+    variables = parse_status_variables (packet->raw);
+
+    if (! stream->func (stream->ami, pkt, variables, stream->user_data))
+        stream->stopped = TRUE;
+
+    g_hash_table_unref (variables);
+
+    return TRUE;
+}
+
+/* whether pkt ends a list, either by the "EventList: Complete" convention
+ * or by the completion event known for the action */
+static gboolean
+list_complete (GHashTable *pkt, const gchar *complete_event)
+{
+    const gchar *event_list;
+
+    event_list = g_hash_table_lookup (pkt, "EventList");
+    if (event_list && ! g_ascii_strcasecmp (event_list, "Complete"))
+        return TRUE;
+
+    return complete_event
+           && ! g_strcmp0 (g_hash_table_lookup (pkt, "Event"), complete_event);
+}
+
+/* pass the items of a list action to a callback one at a time, so that
+ * memory use does not grow with the length of the list */
+gboolean
+stream_hook (gpointer data)
 {
-    GamiPacket *packet;
-    gchar *response, *result, *action_id, *message;
+    GamiHookData       *hook_data = data;
+    GamiListStream     *stream;
+    GamiPacket         *packet;
     GSimpleAsyncResult *simple;
+    GHashTable         *pkt;
+    const gchar        *response;
 
-    packet = ((GamiHookData *) data)->packet;
+    packet = hook_data->packet;
 
     if (packet->handled)
         return TRUE;
     g_return_val_if_fail (packet->parsed != NULL, TRUE);
 
-    response = g_hash_table_lookup (packet->parsed, "Response");
-
-    if (! response)
-        return TRUE;
-
-    action_id = g_hash_table_lookup (packet->parsed, "ActionID");
-    if (action_id
-        && g_strcmp0 (action_id, ((GamiHookData *) data)->action_id))
+    pkt = packet->parsed;
+    if (g_strcmp0 (g_hash_table_lookup (pkt, "ActionID"),
+                   hook_data->action_id))
         return TRUE;
 
     packet->handled = TRUE;
-    result = g_hash_table_lookup (packet->parsed,
-                                  ((GamiHookData *) data)->handler_data);
-    message = g_hash_table_lookup (packet->parsed, "Message");
+    stream = hook_data->handler_data;
+    simple = (GSimpleAsyncResult *) hook_data->result;
+    stream->result = simple;
 
-    simple = (GSimpleAsyncResult *) ((GamiHookData *) data)->result;
+    if ((response = g_hash_table_lookup (pkt, "Response"))) {
+        const gchar *message;
+
+        if (! g_strcmp0 (response, "Success")) {
+            const gchar *event_list;
+
+            /* without a known completion event or an EventList announced,
+             * the list is over once no more items arrive */
+            event_list = g_hash_table_lookup (pkt, "EventList");
+            if ((! stream->complete_event || stream->idle_complete)
+                && ! (event_list && ! g_ascii_strcasecmp (event_list,
+                                                          "start")))
+                arm_list_stream_timeout (stream);
+            return TRUE;
+        }
 
-    if (! g_strcmp0 (g_hash_table_lookup (packet->parsed, "Response"),
-                     "Success")
-        && result)
-        g_simple_async_result_set_op_res_gpointer (simple,
-                                                   g_strdup (result),
-                                                   g_free);
-    else
+        message = g_hash_table_lookup (pkt, "Message");
         g_simple_async_result_set_error (simple,
                                          GAMI_ERROR,
                                          GAMI_ERROR_FAILED,
                                          "%s",
-                                         message ?  message : "Action failed");
+                                         message ? message : "Action failed");
+        g_simple_async_result_complete_in_idle (simple);
 
-    g_simple_async_result_complete_in_idle (simple);
+        return FALSE;
+    }
 
-    return FALSE;
+    if (list_complete (pkt, stream->complete_event)) {
+        g_simple_async_result_set_op_res_gssize (simple, stream->n_items);
+        g_simple_async_result_complete_in_idle (simple);
+
+        return FALSE;
+    }
+
+    /* the timeout checks this when it fires, instead of being rearmed */
+    if (stream->idle_source)
+        stream->last_item = get_current_time_usec ();
+
+    if (stream->stopped)
+        return TRUE;
+
+    if (stream->item_type != GAMI_EVENT_TYPE_UNKNOWN) {
+        GamiEvent *item;
+        gboolean   more;
+
+        item = gami_event_new (pkt);
+        if (gami_event_get_event_type (item) != stream->item_type) {
+            gami_event_unref (item);
+            return TRUE;
+        }
+
+        stream->n_items++;
+        more = ((GamiTypedItemFunc) stream->func) (stream->ami,
+                                                   item,
+                                                   stream->user_data);
+        gami_event_unref (item);
+
+        if (! more)
+            stream->stopped = TRUE;
+        return TRUE;
+    }
+
+    stream->n_items++;
+    g_hash_table_remove (pkt, "Event");
+    g_hash_table_remove (pkt, "EventList");
+
+    if (! stream->func (stream->ami, pkt, stream->user_data))
+        stream->stopped = TRUE;
+
+    return TRUE;
 }
 
 gboolean
@@ -787,24 +3182,111 @@ hash_hook (gpointer data)
     return FALSE;
 }
 
+/* item events of list actions by their completion event; list events
+ * without ActionID are only taken if they are of one of these types */
+static const struct {
+    const gchar *complete_event;
+    const gchar *item_event;
+} list_item_events [] = {
+    { "MeetMeListComplete",         "MeetmeList" },
+    { "QueueSummaryComplete",       "QueueSummary" },
+    { "ZapShowChannelsComplete",    "ZapShowChannels" },
+    { "DAHDIShowChannelsComplete",  "DAHDIShowChannels" },
+    { "AgentsComplete",             "Agents" },
+    { "ParkedCallsComplete",        "ParkedCall" },
+    { "VoicemailUserEntryComplete", "VoicemailUserEntry" },
+    { "CoreShowChannelsComplete",   "CoreShowChannel" },
+    { "PeerlistComplete",           "PeerEntry" },
+    { "RegistrationsComplete",      "RegistryEntry" },
+    { "StatusComplete",             "Status" },
+    { NULL, NULL }
+};
+
+static gboolean
+is_list_event (const gchar *complete_event, const gchar *event)
+{
+    guint i;
+
+    if (! complete_event || ! event)
+        return FALSE;
+
+    if (! g_ascii_strcasecmp (event, complete_event))
+        return TRUE;
+
+    for (i = 0; list_item_events [i].complete_event; i++)
+        if (! g_ascii_strcasecmp (complete_event,
+                                  list_item_events [i].complete_event)
+            && ! g_ascii_strcasecmp (event, list_item_events [i].item_event))
+            return TRUE;
+
+    return FALSE;
+}
+
+/* some server versions omit the ActionID in the events of some lists; such
+ * items can only be attributed to a list when no other list with the same
+ * completion event is pending */
+static gboolean
+owns_anonymous_items (GamiHookData *hook_data)
+{
+    GamiManager *ami;
+    GHookList   *hooks;
+    GHook       *hook;
+    gboolean     owned = TRUE;
+
+    if (! hook_data->started)
+        return FALSE;
+
+    ami = GAMI_MANAGER (g_async_result_get_source_object (hook_data->result));
+    hooks = &ami->priv->packet_hooks;
+
+    for (hook = g_hook_first_valid (hooks, TRUE);
+         hook;
+         hook = g_hook_next_valid (hooks, hook, TRUE)) {
+        GamiHookData *other = hook->data;
+
+        if (hook->func == list_hook && other != hook_data
+            && ! g_strcmp0 (other->handler_data, hook_data->handler_data)) {
+            g_hook_unref (hooks, hook);
+            owned = FALSE;
+            break;
+        }
+    }
+
+    g_object_unref (ami);
+
+    return owned;
+}
+
 gboolean
 list_hook (gpointer data)
 {
-    static GSList *list;
+    GamiHookData *hook_data = data;
+    GamiPacket *packet;
     GHashTable *pkt;
     gchar *response, *action_id;
     GSimpleAsyncResult *simple;
 
-    pkt = ((GamiHookData *) data)->packet->parsed;
+    packet = hook_data->packet;
+
+    if (packet->handled)
+        return TRUE;
+
+    pkt = packet->parsed;
 
     g_return_val_if_fail (pkt != NULL, TRUE);
 
+    /* several list actions may be in progress at the same time, so only
+     * packets carrying our ActionID are taken; events of the list without
+     * ActionID only if no other list of the same action is pending */
     action_id = g_hash_table_lookup (pkt, "ActionID");
-    if (action_id
-        && g_strcmp0 (action_id, ((GamiHookData *) data)->action_id))
+    if (action_id ? g_strcmp0 (action_id, hook_data->action_id) != 0
+                  : ! is_list_event (hook_data->handler_data,
+                                     g_hash_table_lookup (pkt, "Event"))
+                    || ! owns_anonymous_items (hook_data))
         return TRUE;
 
-    simple = (GSimpleAsyncResult *) ((GamiHookData *) data)->result;
+    packet->handled = TRUE;
+    simple = (GSimpleAsyncResult *) hook_data->result;
 
     if ((response = g_hash_table_lookup (pkt, "Response"))) {
         gchar *message;
@@ -812,9 +3294,9 @@ list_hook (gpointer data)
 
         success = ! g_strcmp0 (response, "Success");
         message = g_hash_table_lookup (pkt, "Message");
-        list = NULL;
 
         if (success) {
+            hook_data->started = TRUE;
             return TRUE;
         } else {
             g_simple_async_result_set_error (simple,
@@ -829,21 +3311,22 @@ list_hook (gpointer data)
         }
 
     } else {
-        gchar *event;
         gboolean finished;
         GDestroyNotify list_free = (GDestroyNotify) free_list_result;
 
-        event = g_hash_table_lookup (pkt, "Event");
-        finished = ! g_strcmp0 (event, ((GamiHookData *) data)->handler_data);
+        finished = list_complete (pkt, hook_data->handler_data);
 
         if (! finished) {
             g_hash_table_remove (pkt, "Event");
-            list = g_slist_prepend (list, g_hash_table_ref (pkt));
+            g_hash_table_remove (pkt, "EventList");
+            hook_data->items = g_slist_prepend (hook_data->items,
+                                                g_hash_table_ref (pkt));
         } else {
             g_simple_async_result_set_op_res_gpointer (simple,
-                                                       g_slist_reverse (list),
+                                                       g_slist_reverse (hook_data->items),
                                                        list_free);
             g_simple_async_result_complete_in_idle (simple);
+            hook_data->items = NULL;
         }
 
         return ! finished;
@@ -953,23 +3436,45 @@ queue_rule_hook (gpointer data)
     return FALSE;
 }
 
+static gboolean
+is_queue_status_event (const gchar *complete_event, const gchar *event)
+{
+    return event
+           && (! g_strcmp0 (event, complete_event)
+               || ! strcmp (event, "QueueParams")
+               || ! strcmp (event, "QueueMember")
+               || ! strcmp (event, "QueueEntry"));
+}
+
 gboolean
 queue_status_hook (gpointer data)
 {
+    GamiHookData *hook_data = data;
+    GamiPacket *packet;
     GHashTable *pkt;
     gchar *response, *action_id;
     GSimpleAsyncResult *simple;
 
-    pkt = ((GamiHookData *) data)->packet->parsed;
+    packet = hook_data->packet;
+
+    if (packet->handled)
+        return TRUE;
+
+    pkt = packet->parsed;
 
     g_return_val_if_fail (pkt != NULL, TRUE);
 
+    /* packets without ActionID are only taken if they are events of the
+     * queue status, any other event is left to the other hooks */
     action_id = g_hash_table_lookup (pkt, "ActionID");
-    if (action_id
-        && g_strcmp0 (action_id, ((GamiHookData *) data)->action_id))
+    if (action_id ? g_strcmp0 (action_id, hook_data->action_id) != 0
+                  : ! is_queue_status_event (hook_data->handler_data,
+                                             g_hash_table_lookup (pkt,
+                                                                  "Event")))
         return TRUE;
 
-    simple = (GSimpleAsyncResult *) ((GamiHookData *) data)->result;
+    packet->handled = TRUE;
+    simple = (GSimpleAsyncResult *) hook_data->result;
 
     if ((response = g_hash_table_lookup (pkt, "Response"))) {
         gchar *message;
@@ -987,82 +3492,201 @@ queue_status_hook (gpointer data)
                                              "%s",
                                              message ? message
                                                      : "Action failed");
+            g_simple_async_result_complete_in_idle (simple);
             return FALSE;
         }
 
     } else {
-        GSList *list;
+        GPtrArray *entries;
         gchar *event;
-        gboolean finished;
-        GDestroyNotify list_free = (GDestroyNotify) gami_queue_status_list_free;
 
         event = g_hash_table_lookup (pkt, "Event");
-        list = (GSList *) g_simple_async_result_get_op_res_gpointer (simple);
-        finished = ! g_strcmp0 (event, ((GamiHookData *) data)->handler_data);
-
-        if (! finished) {
-            if (! g_strcmp0 (event, "QueueParams")) {
-                list = g_slist_prepend (list,
-                                        gami_queue_status_entry_new (pkt));
-            } else {
-                GamiQueueStatusEntry *entry;
-
-                entry = (GamiQueueStatusEntry *) list->data;
-                gami_queue_status_entry_add_member (entry, pkt);
+        entries = hook_data->entries;
+
+        if (! g_strcmp0 (event, hook_data->handler_data)) {
+            GSList *list = NULL;
+            guint i;
+
+            /* hand the collected entries over to the result, in order */
+            if (entries) {
+                for (i = entries->len; i > 0; i--)
+                    list = g_slist_prepend (list,
+                                            g_ptr_array_index (entries,
+                                                               i - 1));
+                g_ptr_array_free (entries, TRUE);
+                hook_data->entries = NULL;
             }
-            g_hash_table_remove (pkt, "Event");
-            g_simple_async_result_set_op_res_gpointer (simple, list, list_free);
-        } else {
+
             g_simple_async_result_set_op_res_gpointer (simple,
-                                                       g_slist_reverse (list),
-                                                       list_free);
+                                                       list,
+                                                       (GDestroyNotify)
+                                                       gami_queue_status_list_free);
             g_simple_async_result_complete_in_idle (simple);
+            return FALSE;
         }
 
-        return ! finished;
+        if (! g_strcmp0 (event, "QueueParams")) {
+            if (! entries)
+                entries = hook_data->entries = g_ptr_array_new ();
+            g_ptr_array_add (entries, gami_queue_status_entry_new (pkt));
+        } else if ((! g_strcmp0 (event, "QueueMember")
+                    || ! g_strcmp0 (event, "QueueEntry"))
+                   && entries && entries->len) {
+            gami_queue_status_entry_add_member (g_ptr_array_index
+                                                (entries, entries->len - 1),
+                                                pkt);
+        }
+        g_hash_table_remove (pkt, "Event");
+
+        return TRUE;
+    }
+}
+
+/* pass the complete lines of output to the function of stream; the last
+ * line of the output may lack its line end */
+static void
+deliver_command_lines (GamiCommandStream *stream,
+                       const gchar *output,
+                       gboolean last)
+{
+    gchar *line, *end;
+
+    g_string_append (stream->output, output);
+
+    line = stream->output->str;
+    while (! stream->stopped && (end = strchr (line, '\n'))) {
+        *end = '\0';
+        if (end > line && end [-1] == '\r')
+            end [-1] = '\0';
+
+        stream->n_lines++;
+        if (! stream->func (stream->ami, line, stream->user_data))
+            stream->stopped = TRUE;
+        line = end + 1;
+    }
+
+    if (last && ! stream->stopped && *line) {
+        stream->n_lines++;
+        stream->func (stream->ami, line, stream->user_data);
     }
+
+    g_string_erase (stream->output, 0, line - stream->output->str);
 }
 
+/* collect the output of a Command, which split_command_output() hands out
+ * in pieces, or pass it on line by line if the stream has a function */
 gboolean
 command_hook (gpointer data)
 {
-    GamiPacket *packet;
+    GamiHookData       *hook_data = data;
+    GamiCommandStream  *stream;
+    GamiPacket         *packet;
     GSimpleAsyncResult *simple;
-    gchar *result, *footer;
-    gint   result_len;
 
-    packet = ((GamiHookData *) data)->packet;
+    packet = hook_data->packet;
 
     if (packet->handled)
         return TRUE;
+    g_return_val_if_fail (packet->parsed != NULL, TRUE);
+
+    if (g_strcmp0 (g_hash_table_lookup (packet->parsed, "ActionID"),
+                   hook_data->action_id))
+        return TRUE;
 
-    if (packet->parsed) {
-        gchar *action_id;
+    packet->handled = TRUE;
+    stream = hook_data->handler_data;
+    simple = (GSimpleAsyncResult *) hook_data->result;
 
-        action_id = g_hash_table_lookup (packet->parsed, "ActionID");
-        if (action_id
-            && g_strcmp0 (action_id, ((GamiHookData *) data)->action_id))
-            return TRUE;
+    if (! packet->output) {
+        const gchar *message;
+
+        /* no output follows, e.g. for lack of privileges */
+        g_hash_table_remove (stream->ami->priv->command_streams,
+                             hook_data->action_id);
+
+        message = g_hash_table_lookup (packet->parsed, "Message");
+        g_simple_async_result_set_error (simple,
+                                         GAMI_ERROR,
+                                         GAMI_ERROR_FAILED,
+                                         "%s",
+                                         message ? message : "Action failed");
+        g_simple_async_result_complete_in_idle (simple);
+
+        return FALSE;
     }
 
-    packet->handled = TRUE;
+    if (! stream->func)
+        g_string_append (stream->output, packet->output);
+    else if (! stream->stopped)
+        deliver_command_lines (stream, packet->output, ! packet->partial);
+
+    if (packet->partial)
+        return TRUE;
 
-    result = packet->raw;
-    while (g_str_has_prefix (result, "Response: ")
-           || g_str_has_prefix (result, "Message: ")
-           || g_str_has_prefix (result, "Privilege: ")
-           || g_str_has_prefix (result, "ActionID: ")) {
-        result = g_strstr_len (result, -1, "\r\n") + strlen ("\r\n");
+    if (stream->func)
+        g_simple_async_result_set_op_res_gssize (simple, stream->n_lines);
+    else {
+        g_simple_async_result_set_op_res_gpointer (simple,
+                                                   g_string_free (stream->output,
+                                                                  FALSE),
+                                                   g_free);
+        stream->output = NULL;
     }
+    g_simple_async_result_complete_in_idle (simple);
 
-    footer = g_strrstr (result, "--END COMMAND--");
-    result_len = footer ? footer - result : strlen (result);
+    return FALSE;
+}
 
-    simple = (GSimpleAsyncResult *) ((GamiHookData *) data)->result;
+/* build a #GamiConfig from a GetConfig response, or from the JSON header of
+ * a GetConfigJSON response if handler_data is set */
+gboolean
+config_hook (gpointer data)
+{
+    GamiHookData       *hook_data = data;
+    GamiPacket         *packet;
+    GSimpleAsyncResult *simple;
+    GHashTable         *pkt;
+    GamiConfig         *config = NULL;
+    const gchar        *message;
+
+    packet = hook_data->packet;
+
+    if (packet->handled)
+        return TRUE;
+    g_return_val_if_fail (packet->parsed != NULL, TRUE);
+
+    pkt = packet->parsed;
+    if (g_strcmp0 (g_hash_table_lookup (pkt, "ActionID"),
+                   hook_data->action_id))
+        return TRUE;
+
+    packet->handled = TRUE;
+    simple = (GSimpleAsyncResult *) hook_data->result;
+    message = g_hash_table_lookup (pkt, "Message");
+
+    if (! g_strcmp0 (g_hash_table_lookup (pkt, "Response"), "Success")) {
+        const gchar *json;
+
+        if (! hook_data->handler_data)
+            config = gami_config_new_from_packet (packet->raw);
+        else if ((json = g_hash_table_lookup (pkt, "JSON")))
+            config = gami_config_new_from_json (json);
+
+        message = "Malformed configuration";
+    }
+
+    if (config)
+        g_simple_async_result_set_op_res_gpointer (simple,
+                                                   config,
+                                                   (GDestroyNotify)
+                                                   gami_config_unref);
+    else
+        g_simple_async_result_set_error (simple,
+                                         GAMI_ERROR,
+                                         GAMI_ERROR_FAILED,
+                                         "%s",
+                                         message ? message : "Action failed");
 
-    g_simple_async_result_set_op_res_gpointer (simple,
-                                               g_strndup (result, result_len),
-                                               g_free);
     g_simple_async_result_complete_in_idle (simple);
 
     return FALSE;
@@ -1100,39 +3724,292 @@ text_hook (gpointer data)
     return FALSE;
 }
 
+/* copy the text following prefix in line, up to one of the stop characters */
+static gchar *
+text_after (const gchar *line, const gchar *prefix, const gchar *stop)
+{
+    const gchar *start;
+
+    start = strstr (line, prefix);
+    if (! start)
+        return NULL;
+    start += strlen (prefix);
+
+    return g_strndup (start, strcspn (start, stop));
+}
+
+/* copy the number directly preceding suffix in line */
+static gchar *
+number_before (const gchar *line, const gchar *suffix)
+{
+    const gchar *start, *end;
+
+    end = strstr (line, suffix);
+    if (! end)
+        return NULL;
+
+    for (start = end; start > line && g_ascii_isdigit (start [-1]); start--)
+        ;
+
+    return start < end ? g_strndup (start, end - start) : NULL;
+}
+
+static void
+insert_param (GHashTable *params, const gchar *name, gchar *value)
+{
+    if (value)
+        g_hash_table_insert (params, g_strdup (name), value);
+}
+
+/*
+ * Parse the first line of a queue in the Queues dump into the parameters of
+ * a QueueParams event:
+ *
+ * support has 2 calls (max 10) in 'ringall' strategy (5s holdtime),
+ *         W:0, C:12, A:3, SL:80.0% within 60s
+ */
+static GHashTable *
+parse_queue_params (const gchar *line)
+{
+    GHashTable  *params;
+    const gchar *has;
+    gchar       *max;
+
+    has = strstr (line, " has ");
+    if (! has)
+        return NULL;
+
+    params = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    insert_param (params, "Queue", g_strstrip (g_strndup (line, has - line)));
+    insert_param (params, "Calls", text_after (has, " has ", " "));
+    insert_param (params, "Strategy", text_after (has, "in '", "'"));
+    insert_param (params, "Holdtime", number_before (has, "s holdtime"));
+    insert_param (params, "TalkTime", number_before (has, "s talktime"));
+    insert_param (params, "Weight", text_after (has, "W:", ", "));
+    insert_param (params, "Completed", text_after (has, "C:", ", "));
+    insert_param (params, "Abandoned", text_after (has, "A:", ", "));
+    insert_param (params, "ServicelevelPerf", text_after (has, "SL:", "%"));
+    insert_param (params, "ServiceLevel", text_after (has, "within ", "s"));
+
+    /* QueueParams reports no limit as 0 */
+    max = text_after (has, "(max ", ")");
+    if (max && ! strcmp (max, "unlimited")) {
+        g_free (max);
+        max = g_strdup ("0");
+    }
+    insert_param (params, "Max", max);
+
+    return params;
+}
+
+/* device states as printed by the CLI, in the order of their values */
+static const gchar *device_states [] = {
+    "Unknown",
+    "Not in use",
+    "In use",
+    "Busy",
+    "Invalid",
+    "Unavailable",
+    "Ringing",
+    "Ring+Inuse",
+    "On Hold",
+    NULL
+};
+
+/*
+ * Parse a member line of the Queues dump into the fields of a QueueMember
+ * event:
+ *
+ * Bob (SIP/100) with penalty 2 (dynamic) (paused) (Not in use)
+ *     has taken 3 calls (last was 120 secs ago)
+ */
+static GHashTable *
+parse_queue_member (const gchar *queue, const gchar *line)
+{
+    GHashTable  *member;
+    const gchar *end, *p;
+    gchar       *name;
+    gboolean     first = TRUE;
+
+    member = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+    end = strstr (line, " has taken ");
+    if (! end)
+        end = line + strlen (line);
+
+    for (p = line; p < end; p++)
+        if (! strncmp (p, " (", 2) || ! strncmp (p, " with penalty ", 14))
+            break;
+
+    name = g_strndup (line, p - line);
+    insert_param (member, "Queue", g_strdup (queue));
+    insert_param (member, "Name", g_strdup (name));
+    insert_param (member, "Location", name);
+    insert_param (member, "Membership", g_strdup ("static"));
+    insert_param (member, "Penalty", g_strdup ("0"));
+    insert_param (member, "Paused", g_strdup ("0"));
+
+    while (p < end) {
+        const gchar *close;
+        gchar       *group;
+        guint        i;
+
+        if (! strncmp (p, " with penalty ", 14)) {
+            p += 14;
+            insert_param (member, "Penalty",
+                          g_strndup (p, strspn (p, "0123456789")));
+            continue;
+        }
+
+        if (strncmp (p, " (", 2)
+            || ! (close = memchr (p + 2, ')', end - p - 2))) {
+            p++;
+            continue;
+        }
+
+        group = g_strndup (p + 2, close - p - 2);
+        p = close + 1;
+
+        for (i = 0; device_states [i]; i++)
+            if (! strcmp (group, device_states [i]))
+                break;
+
+        if (device_states [i])
+            insert_param (member, "Status", g_strdup_printf ("%u", i));
+        else if (! strcmp (group, "dynamic") || ! strcmp (group, "realtime"))
+            insert_param (member, "Membership", g_strdup (group));
+        else if (! strcmp (group, "paused"))
+            insert_param (member, "Paused", g_strdup ("1"));
+        else if (first && strchr (group, '/'))
+            insert_param (member, "Location", g_strdup (group));
+
+        g_free (group);
+        first = FALSE;
+    }
+
+    if (*end && ! strstr (end, "no calls yet")) {
+        gchar *ago;
+
+        insert_param (member, "CallsTaken",
+                      text_after (end, " has taken ", " "));
+
+        /* QueueMember reports the time of the last call */
+        ago = number_before (end, " secs ago");
+        if (ago) {
+            insert_param (member, "LastCall",
+                          g_strdup_printf ("%ld",
+                                           (glong) time (NULL) - atol (ago)));
+            g_free (ago);
+        }
+    } else {
+        insert_param (member, "CallsTaken", g_strdup ("0"));
+        insert_param (member, "LastCall", g_strdup ("0"));
+    }
+
+    return member;
+}
+
+/* parse the text of the Queues action into a list of #GamiQueueStatusEntry,
+ * each holding the queue parameters and its members */
+static GSList *
+parse_queues_dump (const gchar *text)
+{
+    GamiQueueStatusEntry *entry = NULL;
+    GSList               *entries = NULL;
+    gchar               **lines, **line;
+    gboolean              members = FALSE;
+
+    lines = g_strsplit (text, "\n", -1);
+
+    for (line = lines; *line; line++) {
+        GHashTable *params;
+        gchar      *item;
+
+        g_strchomp (*line);
+        if (! **line)
+            continue;
+
+        if (! g_ascii_isspace (**line)) {
+            /* a new queue, or a message like "No queues." */
+            params = parse_queue_params (*line);
+            if (! params) {
+                entry = NULL;
+                continue;
+            }
+
+            entry = gami_queue_status_entry_new (params);
+            g_hash_table_unref (params);
+            entries = g_slist_prepend (entries, entry);
+            members = FALSE;
+            continue;
+        }
+
+        item = g_strchug (*line);
+        if (! strcmp (item, "Members:"))
+            members = TRUE;
+        else if (! strcmp (item, "Callers:") || g_str_has_prefix (item, "No "))
+            members = FALSE;
+        else if (members && entry) {
+            GHashTable *member;
+
+            params = gami_queue_status_entry_get_params (entry);
+            member = parse_queue_member (g_hash_table_lookup (params,
+                                                              "Queue"),
+                                         item);
+            gami_queue_status_entry_add_member (entry, member);
+            g_hash_table_unref (member);
+        }
+    }
+
+    g_strfreev (lines);
+
+    return g_slist_reverse (entries);
+}
+
 gboolean
 queues_hook (gpointer data)
 {
-    GamiPacket *packet;
+    GamiHookData       *hook_data = data;
+    GamiPacket         *packet;
     GSimpleAsyncResult *simple;
 
-    packet = ((GamiHookData *) data)->packet;
+    packet = hook_data->packet;
 
     if (packet->handled)
         return TRUE;
 
     packet->handled = TRUE;
 
-    simple = (GSimpleAsyncResult *) ((GamiHookData *) data)->result;
-
     if (g_strcmp0 (packet->raw, "")) {
-        gchar *result;
-
-        result = (gchar *) g_simple_async_result_get_op_res_gpointer (simple);
-        if (result)
-            g_simple_async_result_set_op_res_gpointer (simple,
-                                                       g_strjoin ("\r\n\r\n",
-                                                                  result,
-                                                                  packet->raw,
-                                                                  NULL),
-                                                       g_free);
-        else
-            g_simple_async_result_set_op_res_gpointer (simple,
-                                                       g_strdup (packet->raw),
-                                                       g_free);
+        /* restore the separators between packets */
+        if (! hook_data->text)
+            hook_data->text = g_string_new (packet->raw);
+        else {
+            g_string_append (hook_data->text, "\r\n\r\n");
+            g_string_append (hook_data->text, packet->raw);
+        }
         return TRUE;
     }
 
+    simple = (GSimpleAsyncResult *) hook_data->result;
+
+    if (hook_data->handler_data)
+        g_simple_async_result_set_op_res_gpointer (simple,
+                                                   parse_queues_dump
+                                                   (hook_data->text
+                                                    ? hook_data->text->str
+                                                    : ""),
+                                                   (GDestroyNotify)
+                                                   gami_queue_status_list_free);
+    else if (hook_data->text) {
+        g_simple_async_result_set_op_res_gpointer (simple,
+                                                   g_string_free
+                                                   (hook_data->text, FALSE),
+                                                   g_free);
+        hook_data->text = NULL;
+    }
+
     g_simple_async_result_complete_in_idle (simple);
 
     return FALSE;
@@ -6,18 +6,97 @@
 #include <gami-manager.h>
 #include <gami-manager-types.h>
 #include <gami-error.h>
+#include <gami-event.h>
+#include <gami-config.h>
+
+/* maximum number of packets processed in one main loop iteration */
+#define PACKET_BATCH_SIZE 256
+
+/* one packet buffer lane per #GamiEventPriority */
+#define N_PACKET_LANES (GAMI_EVENT_PRIORITY_RESPONSE + 1)
+
+typedef struct _GamiLaneStats GamiLaneStats;
+struct _GamiLaneStats {
+    guint  delivered;
+    gint64 total_delay;
+    gint64 max_delay;
+};
 
 struct _GamiManagerPrivate
 {
     GIOChannel   *socket;
+    guint         socket_watch;
     gboolean      connected;
     gchar        *host;
     guint         port;
 
     gchar        *log_domain;
 
+    GString      *recv_buffer;
     GHookList     packet_hooks;
-    GQueue       *packet_buffer;
+    GQueue       *lanes [N_PACKET_LANES];
+    gsize         buffered_bytes;
+    guint         buffered_packets;
+    guint         process_source;
+
+    /* priority delivery */
+    GHashTable   *event_priorities;
+    GHashTable   *channel_lanes;
+    GamiLaneStats lane_stats [N_PACKET_LANES];
+
+    /* event coalescing */
+    GHashTable   *coalesce_rules;
+    GHashTable   *coalesce_pending;
+    GQueue       *coalesce_queue;
+    guint         coalesce_window;
+    guint         coalesce_source;
+    guint         received_events;
+    guint         coalesced_events;
+
+    /* channel variables learned from VarSet events */
+    GHashTable   *variable_cache;
+    guint         variable_cache_size;
+    guint         variable_cache_hits;
+    guint         variable_cache_misses;
+
+    /* list actions without completion event */
+    guint         list_timeout;
+
+    /* identical read-only actions awaiting response */
+    gboolean      deduplicate;
+    GHashTable   *in_flight;
+    guint         deduplicated_actions;
+
+    /* responses of read-only actions, see gami_manager_set_response_ttl() */
+    GHashTable   *response_ttls;
+    GHashTable   *response_cache;
+    guint         response_cache_generation;
+    guint         response_cache_hits;
+    guint         response_cache_misses;
+    guint         response_cache_evictions;
+
+    /* Command actions whose output is handed out as it arrives */
+    GHashTable   *command_streams;
+    gchar        *command_output_id;
+    gboolean      command_output_follows;
+
+    /* events parsed in the current processing pass */
+    GPtrArray    *event_batch;
+
+    /* flow control */
+    guint         high_watermark_bytes;
+    guint         low_watermark_bytes;
+    guint         high_watermark_packets;
+    guint         low_watermark_packets;
+    gboolean      throttled;
+    GHashTable   *droppable_events;
+    guint         dropped_events;
+
+    /* read budget per dispatch */
+    guint         read_budget_bytes;
+    guint         read_budget_time;
+    guint         read_budget_hits;
+    gint64        max_dispatch_time;
 
     GAsyncResult *sync_result;
 };
@@ -30,6 +109,10 @@ enum {
     CONNECTED,
     DISCONNECTED,
     EVENT,
+    EVENTS,
+    TYPED_EVENT,
+    BACKPRESSURE_ON,
+    BACKPRESSURE_OFF,
     LAST_SIGNAL
 };
 
@@ -38,8 +121,16 @@ guint signals [LAST_SIGNAL];
 typedef struct _GamiPacket GamiPacket;
 struct _GamiPacket {
 	gchar *raw;
+	gsize size;
+	guint lane;
+	gchar *channel;
+	gchar *coalesce_key;
+	gint64 enqueued;
 	GHashTable *parsed;
 	gboolean handled;
+	/* a piece of the output of a Command, see split_command_output() */
+	gchar *output;
+	gboolean partial;
 };
 
 GamiPacket *
@@ -48,12 +139,183 @@ gami_packet_new (const gchar *raw_text);
 void
 gami_packet_free (GamiPacket *packet);
 
+typedef struct _GamiCachedVariable GamiCachedVariable;
+struct _GamiCachedVariable {
+	gchar *name;
+	gchar *value;
+};
+
+/* variables of one channel, in least recently used order */
+typedef struct _GamiVariableCache GamiVariableCache;
+struct _GamiVariableCache {
+	GHashTable *links;
+	GQueue *lru;
+};
+
+void
+gami_variable_cache_free (GamiVariableCache *cache);
+
+/* maximum number of GetVar actions of a bulk request awaiting response */
+#define GETVAR_BULK_WINDOW 64
+
+typedef struct _GamiGetvarBulk GamiGetvarBulk;
+struct _GamiGetvarBulk {
+	GamiManager *ami;
+	gchar **channels;
+	gchar **variables;
+	guint n_items;
+	guint next;
+	guint in_flight;
+	GHashTable *values;
+	GHashTable *errors;
+};
+
+GamiGetvarBulk *
+gami_getvar_bulk_new (GamiManager *ami,
+                      const gchar **channels,
+                      const gchar **variables);
+
+void
+gami_getvar_bulk_free (GamiGetvarBulk *bulk);
+
+/* maximum number of headers the server parses in a single action
+ * (AST_MAX_MANHEADERS); an UpdateConfig exceeding it is split */
+#define UPDATE_CONFIG_MAX_HEADERS 128
+
+typedef struct _GamiConfigUpdate GamiConfigUpdate;
+struct _GamiConfigUpdate {
+	GamiManager *ami;
+	gchar *src_filename;
+	gchar *dst_filename;
+	gchar *reload;
+	GPtrArray *changes;
+	guint next;
+	guint first;
+	guint chunk;
+};
+
+GamiConfigUpdate *
+gami_config_update_new (GamiManager *ami,
+                        const gchar *src_filename,
+                        const gchar *dst_filename,
+                        const GSList *changes,
+                        const gchar *reload);
+
+void
+gami_config_update_free (GamiConfigUpdate *update);
+
+typedef struct _GamiStatusStream GamiStatusStream;
+struct _GamiStatusStream {
+	GamiManager *ami;
+	GamiChannelStatusFunc func;
+	gpointer user_data;
+	gint n_channels;
+	gboolean stopped;
+};
+
+typedef struct _GamiListStream GamiListStream;
+struct _GamiListStream {
+	GamiManager *ami;
+	gchar *complete_event;
+	GamiListItemFunc func;
+	gpointer user_data;
+	gint n_items;
+	gboolean stopped;
+	gulong hook_id;
+	GSimpleAsyncResult *result;
+	guint idle_source;
+	/* when the last item of the list was received */
+	gint64 last_item;
+	/* deliver items of this type as #GamiEvent, see GamiTypedItemFunc */
+	GamiEventType item_type;
+	/* the completion event is not sent by all server versions */
+	gboolean idle_complete;
+};
+
+typedef struct _GamiCommandStream GamiCommandStream;
+struct _GamiCommandStream {
+	GamiManager *ami;
+	GamiCommandOutputFunc func;
+	gpointer user_data;
+	/* the whole output without func, otherwise the last incomplete line */
+	GString *output;
+	gint n_lines;
+	gboolean stopped;
+};
+
+GamiCommandStream *
+gami_command_stream_new (GamiManager *ami,
+                         GamiCommandOutputFunc func,
+                         gpointer user_data);
+
+void
+gami_command_stream_free (GamiCommandStream *stream);
+
+typedef gboolean (*GamiTypedItemFunc) (GamiManager *ami,
+                                       GamiEvent *item,
+                                       gpointer user_data);
+
+GamiListStream *
+gami_list_stream_new (GamiManager *ami,
+                      const gchar *complete_event,
+                      GamiListItemFunc func,
+                      gpointer user_data);
+
+void
+gami_list_stream_free (GamiListStream *stream);
+
+/* representation of the result of an action, see share_action_result() */
+typedef enum {
+	GAMI_RESULT_NONE,
+	GAMI_RESULT_BOOLEAN,
+	GAMI_RESULT_STRING,
+	GAMI_RESULT_HASH,
+	GAMI_RESULT_LIST,
+	GAMI_RESULT_QUEUE_STATUS_LIST,
+	GAMI_RESULT_CONFIG
+} GamiResultKind;
+
+/* a read-only action sent once for several identical requests */
+typedef struct _GamiInFlightAction GamiInFlightAction;
+struct _GamiInFlightAction {
+	GamiManager *ami;
+	gchar *key;
+	gchar *action;
+	GamiResultKind kind;
+	guint ttl;
+	guint generation;
+	GSList *waiters;
+};
+
+void
+gami_in_flight_action_free (GamiInFlightAction *action);
+
+typedef struct _GamiCachedResponse GamiCachedResponse;
+struct _GamiCachedResponse {
+	gchar *action;
+	GamiResultKind kind;
+	gpointer result;
+	gint64 expires;
+};
+
+void
+gami_cached_response_free (GamiCachedResponse *response);
+
 typedef struct _GamiHookData GamiHookData;
 struct _GamiHookData {
 	GamiPacket *packet;
 	GAsyncResult *result;
     gchar *action_id;
 	gpointer handler_data;
+	/* frees handler_data when the hook is destroyed, may be NULL */
+	GDestroyNotify handler_data_free;
+	GSList *items;
+	/* the action has been acknowledged, list items may follow */
+	gboolean started;
+	/* output of text dumps like Queues, accumulated across packets */
+	GString *text;
+	/* GamiQueueStatusEntry records collected by queue_status_hook */
+	GPtrArray *entries;
 };
 
 GamiHookData *
@@ -76,14 +338,39 @@ typedef GHashTable *(*GamiHashFinishFunc) (GamiManager *,
 typedef GSList *(*GamiListFinishFunc) (GamiManager *,
                                        GAsyncResult *,
                                        GError **);
+typedef gpointer (*GamiPointerFinishFunc) (GamiManager *,
+                                           GAsyncResult *,
+                                           GError **);
+
+gint64 get_current_time_usec (void);
 
 gboolean dispatch_ami (GIOChannel *chan,
                        GIOCondition cond,
                        GamiManager *ami);
 gboolean process_packets (GamiManager *manager);
+void add_socket_watch (GamiManager *ami);
+void release_backpressure (GamiManager *ami);
+void flush_coalesced_events (GamiManager *ami, gboolean all);
+gboolean coalesce_timeout (GamiManager *ami);
+const gchar *lookup_cached_variable (GamiManager *ami,
+                                     const gchar *channel,
+                                     const gchar *variable);
+void store_cached_variable (GamiManager *ami,
+                            const gchar *channel,
+                            const gchar *variable,
+                            const gchar *value,
+                            gboolean replace);
+void clear_variable_cache (GamiManager *ami);
 
 typedef void (*GamiAsyncFunc)           (GamiManager *ami);
 
+GamiResultKind idempotent_result_kind (GamiAsyncFunc func);
+gpointer get_action_result (GSimpleAsyncResult *simple, GamiResultKind kind);
+void share_action_result (GSimpleAsyncResult *simple,
+                          GamiResultKind kind,
+                          gpointer result);
+void invalidate_cached_responses (GamiManager *ami, const gchar *action);
+
 gchar *build_action_string_valist (const gchar *action,
                                    gchar **action_id,
                                    const gchar *first_prop_name,
@@ -115,7 +402,16 @@ GSList *wait_queue_status_result (GamiManager *ami,
                                   GamiListFinishFunc func,
                                   GError **error);
 
+gpointer wait_pointer_result (GamiManager *ami,
+                              GamiPointerFinishFunc func,
+                              GError **error);
+
 /* finish functions */
+gpointer pointer_action_finish (GamiManager *ami,
+                                GAsyncResult *result,
+                                GamiAsyncFunc func,
+                                GError **error);
+
 gboolean bool_action_finish (GamiManager *ami,
                              GAsyncResult *result,
                              GamiAsyncFunc func,
@@ -147,7 +443,7 @@ send_async_action (GamiManager *ami,
                    const gchar *first_param_name,
                    ...);
 
-void
+gulong
 setup_action_hook (GamiManager *ami,
                    GamiAsyncFunc func,
 		   GHookCheckFunc handler,
@@ -162,6 +458,41 @@ send_action_string (GamiManager *ami,
                     const gchar *action,
                     GError **error);
 
+void
+send_list_action (GamiManager *ami,
+                  GamiAsyncFunc func,
+                  const gchar *action,
+                  const GHashTable *params,
+                  GamiListStream *stream,
+                  const gchar *action_id,
+                  GAsyncReadyCallback callback,
+                  gpointer user_data);
+
+void
+send_command_action (GamiManager *ami,
+                     GamiAsyncFunc func,
+                     GamiCommandStream *stream,
+                     const gchar *command,
+                     const gchar *action_id,
+                     GAsyncReadyCallback callback,
+                     gpointer user_data);
+
+void
+start_getvar_bulk (GamiManager *ami,
+                   GamiAsyncFunc func,
+                   GamiGetvarBulk *bulk,
+                   const gchar *action_id,
+                   GAsyncReadyCallback callback,
+                   gpointer user_data);
+
+void
+start_config_update (GamiManager *ami,
+                     GamiAsyncFunc func,
+                     GamiConfigUpdate *update,
+                     const gchar *action_id,
+                     GAsyncReadyCallback callback,
+                     gpointer user_data);
+
 /* response callbacks used internally in synchronous mode */
 void set_sync_result (GObject *ami, GAsyncResult *result, gpointer data);
 gboolean check_response (GHashTable *p, const gchar *expected_value);
@@ -178,6 +509,11 @@ gboolean queues_hook       (gpointer data);
 gboolean queue_rule_hook   (gpointer data);
 gboolean queue_status_hook (gpointer data);
 gboolean command_hook      (gpointer data);
+gboolean config_hook       (gpointer data);
+gboolean getvar_bulk_hook  (gpointer data);
+gboolean config_update_hook (gpointer data);
+gboolean status_variables_hook (gpointer data);
+gboolean stream_hook       (gpointer data);
 
 gboolean reconnect_socket (GamiManager *ami);
 
@@ -67,7 +67,10 @@ gami_queue_rule_get_type ()
 
 struct _GamiQueueStatusEntry {
 	GHashTable    *params;
-	GSList        *members;
+	GPtrArray     *members;
+	/* the same members in a list for gami_queue_status_entry_get_members */
+	GSList        *member_list;
+	GSList        *member_tail;
 	volatile gint  ref_count;
 };
 
@@ -110,9 +113,10 @@ GamiQueueStatusEntry *
 gami_queue_status_entry_new (GHashTable *params) {
     GamiQueueStatusEntry *entry;
 
-    entry = g_new (GamiQueueStatusEntry, 1);
+    entry = g_new0 (GamiQueueStatusEntry, 1);
     entry->params    = g_hash_table_ref (params);
-    entry->members   = NULL;
+    entry->members   = g_ptr_array_new_with_free_func ((GDestroyNotify)
+                                                      g_hash_table_unref);
     entry->ref_count = 1;
 
     return entry;
@@ -151,8 +155,8 @@ gami_queue_status_entry_unref (GamiQueueStatusEntry *entry)
 
     if (g_atomic_int_exchange_and_add (&entry->ref_count, -1) - 1 == 0) {
         g_hash_table_unref (entry->params);
-        g_slist_foreach (entry->members, (GFunc) g_hash_table_unref, NULL);
-        g_slist_free (entry->members);
+        g_ptr_array_free (entry->members, TRUE);
+        g_slist_free (entry->member_list);
         g_free (entry);
     }
 }
@@ -162,26 +166,75 @@ gami_queue_status_entry_unref (GamiQueueStatusEntry *entry)
  * @entry: a #GamiQueueStatusEntry
  * @member: a #GHashTable representing a single queue member
  *
- * Add @member to the list held by @entry.
+ * Append @member to the members held by @entry. Members keep the order in
+ * which they were added. An entry must not be modified once it has been
+ * passed to other threads.
  */
 void
 gami_queue_status_entry_add_member (GamiQueueStatusEntry *entry,
                                     GHashTable *member)
 {
+    GSList *link;
+
     g_return_if_fail (entry != NULL);
     g_return_if_fail (entry->ref_count > 0);
 
-    entry->members = g_slist_prepend (entry->members,
-                                      g_hash_table_ref (member));
+    g_ptr_array_add (entry->members, g_hash_table_ref (member));
+
+    link = g_slist_prepend (NULL, member);
+    if (entry->member_tail)
+        entry->member_tail->next = link;
+    else
+        entry->member_list = link;
+    entry->member_tail = link;
+}
+
+/**
+ * gami_queue_status_entry_get_n_members:
+ * @entry: a #GamiQueueStatusEntry
+ *
+ * Get the number of members stored in @entry.
+ *
+ * Returns: the number of queue members
+ */
+guint
+gami_queue_status_entry_get_n_members (GamiQueueStatusEntry *entry)
+{
+    g_return_val_if_fail (entry != NULL, 0);
+    g_return_val_if_fail (entry->ref_count > 0, 0);
+
+    return entry->members->len;
+}
+
+/**
+ * gami_queue_status_entry_get_member:
+ * @entry: a #GamiQueueStatusEntry
+ * @index: the position of the member
+ *
+ * Get the member at @index in the order the members were added. The returned
+ * #GHashTable remains property of @entry and should not be modified.
+ *
+ * Returns: the queue member, or %NULL if @index is out of range
+ */
+GHashTable *
+gami_queue_status_entry_get_member (GamiQueueStatusEntry *entry, guint index)
+{
+    g_return_val_if_fail (entry != NULL, NULL);
+    g_return_val_if_fail (entry->ref_count > 0, NULL);
+
+    if (index >= entry->members->len)
+        return NULL;
+
+    return g_ptr_array_index (entry->members, index);
 }
 
 /**
  * gami_queue_status_entry_get_members:
  * @entry: a #GamiQueueStatusEntry
  *
- * Retrieve the list of members stored in @entry. Each member is represented 
- * by a #GHashTable. The returned list remains property of @entry and should
- * not be freed or modified.
+ * Retrieve the list of members stored in @entry, in the order they were
+ * added. Each member is represented by a #GHashTable. The returned list
+ * remains property of @entry and should not be freed or modified.
  *
  * Returns: a #GSList of queue members
  */
@@ -191,7 +244,7 @@ gami_queue_status_entry_get_members (GamiQueueStatusEntry *entry)
     g_return_val_if_fail (entry != NULL, NULL);
     g_return_val_if_fail (entry->ref_count > 0, NULL);
 
-    return g_slist_reverse (entry->members);
+    return entry->member_list;
 }
 
 /**
@@ -72,7 +72,8 @@ GType gami_queue_rule_get_type (void) G_GNUC_CONST;
  * gami_manager_queue_status() action.
  * It is an ref-counted opaque structure holding both queue properties and a
  * list of queue members, which should only be accessed by the corresponding
- * functions.
+ * functions. Once filled, an entry is not modified and may be shared between
+ * threads.
  */
 typedef struct _GamiQueueStatusEntry GamiQueueStatusEntry;
 
@@ -104,6 +105,9 @@ void gami_queue_status_entry_add_member (GamiQueueStatusEntry *entry,
 
 GHashTable *gami_queue_status_entry_get_params  (GamiQueueStatusEntry *entry);
 GSList     *gami_queue_status_entry_get_members (GamiQueueStatusEntry *entry);
+guint       gami_queue_status_entry_get_n_members (GamiQueueStatusEntry *entry);
+GHashTable *gami_queue_status_entry_get_member  (GamiQueueStatusEntry *entry,
+												 guint index);
 
 G_END_DECLS
 
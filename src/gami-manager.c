@@ -96,7 +96,28 @@ enum {
     PROP_0,
     PROP_HOST,
     PROP_PORT,
-    PROP_LOG_DOMAIN
+    PROP_LOG_DOMAIN,
+    PROP_HIGH_WATERMARK_BYTES,
+    PROP_LOW_WATERMARK_BYTES,
+    PROP_HIGH_WATERMARK_PACKETS,
+    PROP_LOW_WATERMARK_PACKETS,
+    PROP_DROPPED_EVENTS,
+    PROP_READ_BUDGET_BYTES,
+    PROP_READ_BUDGET_TIME,
+    PROP_READ_BUDGET_HITS,
+    PROP_MAX_DISPATCH_TIME,
+    PROP_COALESCE_WINDOW,
+    PROP_RECEIVED_EVENTS,
+    PROP_COALESCED_EVENTS,
+    PROP_VARIABLE_CACHE_SIZE,
+    PROP_VARIABLE_CACHE_HITS,
+    PROP_VARIABLE_CACHE_MISSES,
+    PROP_LIST_TIMEOUT,
+    PROP_DEDUPLICATE,
+    PROP_DEDUPLICATED_ACTIONS,
+    PROP_RESPONSE_CACHE_HITS,
+    PROP_RESPONSE_CACHE_MISSES,
+    PROP_RESPONSE_CACHE_EVICTIONS
 };
 
 G_DEFINE_TYPE (GamiManager, gami_manager, G_TYPE_OBJECT);
@@ -269,8 +290,7 @@ gami_manager_connect (GamiManager *ami, GError **error)
     }
 
     g_io_channel_set_flags (ami->priv->socket, G_IO_FLAG_NONBLOCK, error);
-    g_io_add_watch (ami->priv->socket, G_IO_IN | G_IO_PRI | G_IO_ERR | G_IO_HUP,
-                    (GIOFunc) dispatch_ami, ami);
+    add_socket_watch (ami);
 
     return ami->priv->connected;
 }
@@ -289,6 +309,277 @@ gami_manager_set_log_domain (GamiManager *ami, const gchar *log_domain)
     g_object_set (G_OBJECT (ami), "log_domain", log_domain, NULL);
 }
 
+/**
+ * gami_manager_set_droppable_events:
+ * @ami: #GamiManager
+ * @events: %NULL-terminated array of event names, or %NULL
+ *
+ * Set the low-priority event types which may be discarded while the inbound
+ * packet buffer is above its high watermark (see
+ * #GamiManager:high-watermark-bytes and #GamiManager:high-watermark-packets).
+ * When the buffer reaches the high watermark, events of these types which
+ * are still waiting for delivery are discarded first, and reading from the
+ * server is only paused if that does not bring the buffer back below the
+ * watermark. Passing %NULL disables dropping, which is the default. The
+ * number of discarded events is available as #GamiManager:dropped-events.
+ */
+void
+gami_manager_set_droppable_events (GamiManager *ami, const gchar **events)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+
+    if (ami->priv->droppable_events) {
+        g_hash_table_unref (ami->priv->droppable_events);
+        ami->priv->droppable_events = NULL;
+    }
+
+    if (! events || ! *events)
+        return;
+
+    ami->priv->droppable_events = g_hash_table_new_full (g_str_hash,
+                                                         g_str_equal,
+                                                         g_free,
+                                                         NULL);
+    for (; *events; events++)
+        g_hash_table_insert (ami->priv->droppable_events,
+                             g_strdup (*events),
+                             GINT_TO_POINTER (TRUE));
+}
+
+/**
+ * gami_manager_set_event_priority:
+ * @ami: #GamiManager
+ * @event: name of the event
+ * @priority: the lane @event is delivered in
+ *
+ * Set the priority used to deliver events named @event while packets are
+ * backlogged. Lanes are drained in priority order, with responses to actions
+ * always delivered first. Events which carry a Uniqueid header never overtake
+ * events for the same channel which are already queued in a lower priority
+ * lane; those are moved up and delivered just before them. Events default to
+ * %GAMI_EVENT_PRIORITY_NORMAL.
+ */
+void
+gami_manager_set_event_priority (GamiManager *ami,
+                                 const gchar *event,
+                                 GamiEventPriority priority)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (event != NULL);
+    g_return_if_fail (priority < GAMI_EVENT_PRIORITY_RESPONSE);
+
+    /* store priority + 1, so that a failed lookup reads as unset */
+    if (priority == GAMI_EVENT_PRIORITY_NORMAL)
+        g_hash_table_remove (ami->priv->event_priorities, event);
+    else
+        g_hash_table_insert (ami->priv->event_priorities,
+                             g_strdup (event),
+                             GINT_TO_POINTER (priority + 1));
+}
+
+/**
+ * gami_manager_get_lane_stats:
+ * @ami: #GamiManager
+ * @priority: the lane to query
+ * @delivered: return location for the number of delivered packets, or %NULL
+ * @pending: return location for the number of queued packets, or %NULL
+ * @average_delay: return location for the average queueing delay in
+ *                 microseconds, or %NULL
+ * @max_delay: return location for the maximum queueing delay in
+ *             microseconds, or %NULL
+ *
+ * Retrieve delivery statistics of the lane for packets of @priority.
+ */
+void
+gami_manager_get_lane_stats (GamiManager *ami,
+                             GamiEventPriority priority,
+                             guint *delivered,
+                             guint *pending,
+                             guint *average_delay,
+                             guint *max_delay)
+{
+    GamiLaneStats *stats;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (priority < N_PACKET_LANES);
+
+    stats = &ami->priv->lane_stats [priority];
+
+    if (delivered)
+        *delivered = stats->delivered;
+    if (pending)
+        *pending = g_queue_get_length (ami->priv->lanes [priority]);
+    if (average_delay)
+        *average_delay = stats->delivered
+                         ? (guint) (stats->total_delay / stats->delivered)
+                         : 0;
+    if (max_delay)
+        *max_delay = (guint) MIN (stats->max_delay, G_MAXUINT);
+}
+
+/**
+ * gami_manager_coalesce_event:
+ * @ami: #GamiManager
+ * @event: name of the event
+ * @key_headers: %NULL-terminated array of header names, or %NULL
+ *
+ * Enable coalescing of events named @event. Events with identical values for
+ * all of @key_headers which arrive within #GamiManager:coalesce-window are
+ * delivered once, with the content of the latest event. Held events are
+ * delivered before any event of the same channel (by Uniqueid) which is not
+ * coalesced with them, so the order of events per channel is kept. Passing %NULL as
+ * @key_headers disables coalescing for @event.
+ */
+void
+gami_manager_coalesce_event (GamiManager *ami,
+                             const gchar *event,
+                             const gchar **key_headers)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (event != NULL);
+
+    if (key_headers)
+        g_hash_table_insert (ami->priv->coalesce_rules,
+                             g_strdup (event),
+                             g_strdupv ((gchar **) key_headers));
+    else
+        g_hash_table_remove (ami->priv->coalesce_rules, event);
+}
+
+/**
+ * gami_manager_set_response_ttl:
+ * @ami: #GamiManager
+ * @action: name of the action, e.g. "CoreSettings"
+ * @ttl: time in milliseconds responses are cached, or 0
+ *
+ * Cache the responses of the read-only action @action for @ttl milliseconds.
+ * Later requests with the same parameters and without an explicit ActionID
+ * are then answered without contacting the server, with a copy of the cached
+ * result. Passing 0 as @ttl disables caching for @action and drops its
+ * cached responses.
+ *
+ * Cached responses are dropped when the server reloads its configuration,
+ * and when events indicate that they are outdated (e.g. PeerStatus events for
+ * SIPpeers); see gami_manager_invalidate_responses() to drop them explicitly.
+ * Only actions which do not change the state of the server may be cached,
+ * like ListCommands, CoreSettings, GetConfig, ListCategories,
+ * VoicemailUsersList or ModuleCheck.
+ */
+void
+gami_manager_set_response_ttl (GamiManager *ami,
+                               const gchar *action,
+                               guint ttl)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (action != NULL);
+
+    if (ttl)
+        g_hash_table_insert (ami->priv->response_ttls,
+                             g_ascii_strdown (action, -1),
+                             GUINT_TO_POINTER (ttl));
+    else {
+        gchar *name = g_ascii_strdown (action, -1);
+
+        g_hash_table_remove (ami->priv->response_ttls, name);
+        g_free (name);
+        invalidate_cached_responses (ami, action);
+    }
+}
+
+/**
+ * gami_manager_invalidate_responses:
+ * @ami: #GamiManager
+ * @action: name of the action, or %NULL
+ *
+ * Drop the cached responses of @action, or all cached responses if @action is
+ * %NULL. Responses to requests already sent are not cached either.
+ */
+void
+gami_manager_invalidate_responses (GamiManager *ami, const gchar *action)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+
+    invalidate_cached_responses (ami, action);
+}
+
+/**
+ * gami_manager_list_stream_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with one of the streaming list
+ * actions, like gami_manager_sip_peers_stream_async(), or with
+ * gami_manager_command_stream_async()
+ *
+ * Returns: the number of items (or lines of output) passed to the callback
+ *          on success, -1 on failure
+ */
+gint
+gami_manager_list_stream_finish (GamiManager *ami,
+                                 GAsyncResult *result,
+                                 GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), -1);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), -1);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+    g_warn_if_fail (g_simple_async_result_is_valid (result,
+                                                    G_OBJECT (ami),
+                                                    NULL));
+    if (g_simple_async_result_propagate_error (simple, error))
+        return -1;
+
+    return (gint) g_simple_async_result_get_op_res_gssize (simple);
+}
+
+/**
+ * gami_manager_list_action_stream_async:
+ * @ami: #GamiManager
+ * @action: name of the action
+ * @params: parameters of the action (stored as #GHashTable), or %NULL
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Send an arbitrary action which returns a list of events, and pass each
+ * event carrying the ActionID of the action to @func. This allows using list
+ * actions libgami has no dedicated function for.
+ *
+ * The end of the list is recognized by the "EventList: Complete" header sent
+ * by Asterisk 1.6 and later. For actions which do not announce an event list
+ * in their response, the list is considered complete once no more items
+ * have arrived for #GamiManager:list-timeout milliseconds. Finish with
+ * gami_manager_list_stream_finish().
+ */
+void
+gami_manager_list_action_stream_async (GamiManager *ami,
+                                       const gchar *action,
+                                       const GHashTable *params,
+                                       GamiListItemFunc func,
+                                       gpointer func_data,
+                                       const gchar *action_id,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (action != NULL);
+    g_return_if_fail (func != NULL);
+
+    send_list_action (ami,
+                      (GamiAsyncFunc) gami_manager_list_action_stream_async,
+                      action,
+                      params,
+                      gami_list_stream_new (ami, NULL, func, func_data),
+                      action_id,
+                      callback,
+                      user_data);
+}
+
 /*
  * Login/Logoff
  */
@@ -556,10 +847,297 @@ gami_manager_getvar_finish (GamiManager *ami,
 {
     return string_action_finish (ami,
                                  result,
-                                 (GamiAsyncFunc) gami_manager_setvar_async,
+                                 (GamiAsyncFunc) gami_manager_getvar_async,
+                                 error);
+}
+
+/**
+ * gami_manager_getvar_cached:
+ * @ami: #GamiManager
+ * @channel: Channel to retrieve variable from
+ * @variable: Name of the variable to retrieve
+ * @action_id: ActionID to ease response matching
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Get value of @variable from @channel like gami_manager_getvar(), but answer
+ * from the variable cache if possible. See
+ * #GamiManager:variable-cache-size for details.
+ *
+ * Returns: value of @variable or %NULL
+ */
+gchar *
+gami_manager_getvar_cached (GamiManager *ami,
+                            const gchar *channel,
+                            const gchar *variable,
+                            const gchar *action_id,
+                            GError **error)
+{
+    const gchar *value;
+
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), NULL);
+    g_return_val_if_fail (variable != NULL, NULL);
+
+    value = lookup_cached_variable (ami, channel, variable);
+    if (value) {
+        ami->priv->variable_cache_hits++;
+        return g_strdup (value);
+    }
+
+    gami_manager_getvar_cached_async (ami,
+                                      channel,
+                                      variable,
+                                      action_id,
+                                      set_sync_result,
+                                      NULL);
+    return wait_string_result (ami, gami_manager_getvar_cached_finish, error);
+}
+
+typedef struct {
+    GSimpleAsyncResult *simple;
+    gchar              *channel;
+    gchar              *variable;
+} GetvarCachedData;
+
+static void
+getvar_cached_cb (GamiManager *ami,
+                  GAsyncResult *result,
+                  GetvarCachedData *data)
+{
+    gchar  *value;
+    GError *error = NULL;
+
+    value = gami_manager_getvar_finish (ami, result, &error);
+
+    if (error) {
+        g_simple_async_result_set_from_error (data->simple, error);
+        g_error_free (error);
+    } else {
+        store_cached_variable (ami, data->channel, data->variable, value,
+                               FALSE);
+        g_simple_async_result_set_op_res_gpointer (data->simple,
+                                                   g_strdup (value),
+                                                   g_free);
+    }
+
+    g_simple_async_result_complete (data->simple);
+
+    g_object_unref (data->simple);
+    g_free (data->channel);
+    g_free (data->variable);
+    g_free (data);
+}
+
+/**
+ * gami_manager_getvar_cached_async:
+ * @ami: #GamiManager
+ * @channel: Channel to retrieve variable from
+ * @variable: Name of the variable to retrieve
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Get value of @variable from @channel, answering from the variable cache if
+ * possible
+ */
+void
+gami_manager_getvar_cached_async (GamiManager *ami,
+                                  const gchar *channel,
+                                  const gchar *variable,
+                                  const gchar *action_id,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    GSimpleAsyncResult *simple;
+    GetvarCachedData   *data;
+    const gchar        *value;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (variable != NULL);
+
+    simple = g_simple_async_result_new (G_OBJECT (ami),
+                                        callback,
+                                        user_data,
+                                        gami_manager_getvar_cached_async);
+
+    value = lookup_cached_variable (ami, channel, variable);
+    if (value) {
+        ami->priv->variable_cache_hits++;
+        g_simple_async_result_set_op_res_gpointer (simple,
+                                                   g_strdup (value),
+                                                   g_free);
+        g_simple_async_result_complete_in_idle (simple);
+        g_object_unref (simple);
+        return;
+    }
+
+    ami->priv->variable_cache_misses++;
+
+    data = g_new (GetvarCachedData, 1);
+    data->simple   = simple;
+    data->channel  = g_strdup (channel);
+    data->variable = g_strdup (variable);
+
+    gami_manager_getvar_async (ami,
+                               channel,
+                               variable,
+                               action_id,
+                               (GAsyncReadyCallback) getvar_cached_cb,
+                               data);
+}
+
+/**
+ * gami_manager_getvar_cached_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_getvar_cached_async()
+ *
+ * Returns: the value of the requested variable, or %NULL
+ */
+gchar *
+gami_manager_getvar_cached_finish (GamiManager *ami,
+                                   GAsyncResult *result,
+                                   GError **error)
+{
+    return string_action_finish (ami,
+                                 result,
+                                 (GamiAsyncFunc)
+                                 gami_manager_getvar_cached_async,
                                  error);
 }
 
+/**
+ * gami_manager_getvar_bulk:
+ * @ami: #GamiManager
+ * @channels: %NULL-terminated array of channel names
+ * @variables: %NULL-terminated array of variable names
+ * @action_id: ActionID prefix to ease response matching
+ * @errors: location to return per-item errors, or %NULL
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Get the values of many channel variables at once. Item i is the variable
+ * @variables[i] of the channel @channels[i]; an empty channel name denotes a
+ * global variable. The GetVar actions are pipelined, see
+ * gami_manager_getvar_bulk_async().
+ *
+ * Items which could not be retrieved are missing from the returned table and
+ * stored in @errors instead, which maps channel names to #GHashTable<!-- -->s
+ * of variable names and error messages. Both tables must be freed with
+ * g_hash_table_unref().
+ *
+ * Returns: #GHashTable of channel names and #GHashTable<!-- -->s of variable
+ *          names and values on success, %NULL on failure
+ */
+GHashTable *
+gami_manager_getvar_bulk (GamiManager *ami,
+                          const gchar **channels,
+                          const gchar **variables,
+                          const gchar *action_id,
+                          GHashTable **errors,
+                          GError **error)
+{
+    GHashTable *values;
+
+    gami_manager_getvar_bulk_async (ami,
+                                    channels,
+                                    variables,
+                                    action_id,
+                                    set_sync_result,
+                                    NULL);
+
+    while (! ami->priv->sync_result)
+        g_main_context_iteration (NULL, TRUE);
+
+    values = gami_manager_getvar_bulk_finish (ami,
+                                              ami->priv->sync_result,
+                                              errors,
+                                              error);
+    if (values)
+        g_hash_table_ref (values);
+    if (errors && *errors)
+        g_hash_table_ref (*errors);
+
+    g_object_unref (ami->priv->sync_result);
+    ami->priv->sync_result = NULL;
+
+    return values;
+}
+
+/**
+ * gami_manager_getvar_bulk_async:
+ * @ami: #GamiManager
+ * @channels: %NULL-terminated array of channel names
+ * @variables: %NULL-terminated array of variable names
+ * @action_id: ActionID prefix to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Get the values of many channel variables at once, see
+ * gami_manager_getvar_bulk(). Instead of sending one action per variable,
+ * the GetVar actions are written to the server in batches, with a bounded
+ * number of them awaiting their response. Responses are matched by ActionID
+ * (@action_id followed by "-" and the index of the item), and @callback is
+ * called once all items have been answered.
+ */
+void
+gami_manager_getvar_bulk_async (GamiManager *ami,
+                                const gchar **channels,
+                                const gchar **variables,
+                                const gchar *action_id,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (channels != NULL && variables != NULL);
+
+    start_getvar_bulk (ami,
+                       (GamiAsyncFunc) gami_manager_getvar_bulk_async,
+                       gami_getvar_bulk_new (ami, channels, variables),
+                       action_id,
+                       callback,
+                       user_data);
+}
+
+/**
+ * gami_manager_getvar_bulk_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @errors: location to return per-item errors, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_getvar_bulk_async(). The returned tables are owned by
+ * @result.
+ *
+ * Returns: #GHashTable of channel names and #GHashTable<!-- -->s of variable
+ *          names and values on success, %NULL on failure
+ */
+GHashTable *
+gami_manager_getvar_bulk_finish (GamiManager *ami,
+                                 GAsyncResult *result,
+                                 GHashTable **errors,
+                                 GError **error)
+{
+    GamiGetvarBulk *bulk;
+
+    if (errors)
+        *errors = NULL;
+
+    bulk = pointer_action_finish (ami,
+                                  result,
+                                  (GamiAsyncFunc) gami_manager_getvar_bulk_async,
+                                  error);
+    if (! bulk)
+        return NULL;
+
+    if (errors)
+        *errors = bulk->errors;
+
+    return bulk->values;
+}
+
 /**
  * gami_manager_setvar:
  * @ami: #GamiManager
@@ -1507,6 +2085,46 @@ gami_manager_meetme_list_finish (GamiManager *ami,
                                error);
 }
 
+/**
+ * gami_manager_meetme_list_stream_async:
+ * @ami: #GamiManager
+ * @conference: The MeetMe conference bridge number
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * List all users in conference @meetme
+ *
+ * Like gami_manager_meetme_list_async(), but each item is passed to @func as
+ * soon as it has been received instead of being collected into a list.
+ * Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_meetme_list_stream_async (GamiManager *ami,
+                                       const gchar *conference,
+                                       GamiListItemFunc func,
+                                       gpointer func_data,
+                                       const gchar *action_id,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_meetme_list_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "MeetMeListComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "MeetmeList",
+                       "Conference", conference,
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /*
  * Queue management
@@ -1963,15 +2581,55 @@ gami_manager_queue_summary_finish (GamiManager *ami,
                                error);
 }
 
-
 /**
- * gami_manager_queue_log:
+ * gami_manager_queue_summary_stream_async:
  * @ami: #GamiManager
- * @queue: Queue to generate queue_log entry for
- * @event: Log event to generate
+ * @queue: Only send summary information for @queue
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
  * @action_id: ActionID to ease response matching
- * @error: A location to return an error of type #GIOChannelError
- *
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Get summary of queue statistics
+ *
+ * Like gami_manager_queue_summary_async(), but each item is passed to @func
+ * as soon as it has been received instead of being collected into a list.
+ * Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_queue_summary_stream_async (GamiManager *ami,
+                                         const gchar *queue,
+                                         GamiListItemFunc func,
+                                         gpointer func_data,
+                                         const gchar *action_id,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_queue_summary_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "QueueSummaryComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "QueueSummary",
+                       "Queue", queue,
+                       "ActionID", action_id,
+                       NULL);
+}
+
+
+/**
+ * gami_manager_queue_log:
+ * @ami: #GamiManager
+ * @queue: Queue to generate queue_log entry for
+ * @event: Log event to generate
+ * @action_id: ActionID to ease response matching
+ * @error: A location to return an error of type #GIOChannelError
+ *
  * Generate a queue_log entry for @queue
  *
  * Returns: %TRUE on success, %FALSE on failure
@@ -2272,6 +2930,80 @@ gami_manager_queues_finish (GamiManager *ami,
                                  error);
 }
 
+/**
+ * gami_manager_queues_list:
+ * @ami: #GamiManager
+ * @action_id: ActionID to ease response matching
+ * @error: a #GError, or %NULL
+ *
+ * Receive the queue statistics of gami_manager_queues () parsed into records.
+ * Queue parameters and members are stored with the keys of the QueueParams
+ * and QueueMember events, as returned by gami_manager_queue_status ().
+ * Waiting callers are not included.
+ *
+ * Returns: #GSList of queues status information (stored as
+ *          #GamiQueueStatusEntry) on success, %NULL on failure
+ */
+GSList *
+gami_manager_queues_list (GamiManager *ami,
+                          const gchar *action_id,
+                          GError **error)
+{
+    gami_manager_queues_list_async (ami, action_id, set_sync_result, NULL);
+    return wait_queue_status_result (ami,
+                                     gami_manager_queues_list_finish,
+                                     error);
+}
+
+/**
+ * gami_manager_queues_list_async:
+ * @ami: #GamiManager
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Receive the queue statistics of gami_manager_queues () parsed into records
+ */
+void
+gami_manager_queues_list_async (GamiManager *ami,
+                                const gchar *action_id,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_queues_list_async,
+                       queues_hook,
+                       GINT_TO_POINTER (TRUE),
+                       callback,
+                       user_data,
+                       "Queues",
+                       "ActionID", action_id,
+                       NULL);
+}
+
+/**
+ * gami_manager_queues_list_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_queues_list_async ()
+ *
+ * Returns: #GSList of queues status information (stored as
+ *          #GamiQueueStatusEntry) on success, %NULL on failure
+ */
+GSList *
+gami_manager_queues_list_finish (GamiManager *ami,
+                                 GAsyncResult *result,
+                                 GError **error)
+{
+    return list_action_finish (ami,
+                               result,
+                               (GamiAsyncFunc) gami_manager_queues_list_async,
+                               error);
+}
+
 
 /*
  * ZAP Channels
@@ -2663,6 +3395,43 @@ gami_manager_zap_show_channels_finish (GamiManager *ami,
     return list_action_finish (ami, result, func, error);
 }
 
+/**
+ * gami_manager_zap_show_channels_stream_async:
+ * @ami: #GamiManager
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Show the status of all ZAP channels
+ *
+ * Like gami_manager_zap_show_channels_async(), but each item is passed to
+ * @func as soon as it has been received instead of being collected into a
+ * list. Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_zap_show_channels_stream_async (GamiManager *ami,
+                                             GamiListItemFunc func,
+                                             gpointer func_data,
+                                             const gchar *action_id,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_zap_show_channels_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "ZapShowChannelsComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "ZapShowChannels",
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /**
  * gami_manager_zap_transfer:
@@ -3211,6 +3980,46 @@ gami_manager_dahdi_show_channels_finish (GamiManager *ami,
     return list_action_finish (ami, result, func, error);
 }
 
+/**
+ * gami_manager_dahdi_show_channels_stream_async:
+ * @ami: #GamiManager
+ * @dahdi_channel: Limit status information to this channel
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Show the status of all DAHDI channels
+ *
+ * Like gami_manager_dahdi_show_channels_async(), but each item is passed to
+ * @func as soon as it has been received instead of being collected into a
+ * list. Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_dahdi_show_channels_stream_async (GamiManager *ami,
+                                               const gchar *dahdi_channel,
+                                               GamiListItemFunc func,
+                                               gpointer func_data,
+                                               const gchar *action_id,
+                                               GAsyncReadyCallback callback,
+                                               gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_dahdi_show_channels_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "DAHDIShowChannelsComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "DAHDIShowChannels",
+                       "DAHDIChannel", dahdi_channel,
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /**
  * gami_manager_dahdi_transfer:
@@ -3433,6 +4242,43 @@ gami_manager_agents_finish (GamiManager *ami,
                                error);
 }
 
+/**
+ * gami_manager_agents_stream_async:
+ * @ami: #GamiManager
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * List information about all configured agents and their status
+ *
+ * Like gami_manager_agents_async(), but each item is passed to @func as soon
+ * as it has been received instead of being collected into a list. Finish
+ * with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_agents_stream_async (GamiManager *ami,
+                                  GamiListItemFunc func,
+                                  gpointer func_data,
+                                  const gchar *action_id,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_agents_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "AgentsComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "Agents",
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /**
  * gami_manager_agent_callback_login:
@@ -4143,6 +4989,43 @@ gami_manager_parked_calls_finish (GamiManager *ami,
                                error);
 }
 
+/**
+ * gami_manager_parked_calls_stream_async:
+ * @ami: #GamiManager
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve a list of parked calls
+ *
+ * Like gami_manager_parked_calls_async(), but each item is passed to @func
+ * as soon as it has been received instead of being collected into a list.
+ * Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_parked_calls_stream_async (GamiManager *ami,
+                                        GamiListItemFunc func,
+                                        gpointer func_data,
+                                        const gchar *action_id,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_parked_calls_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "ParkedCallsComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "ParkedCalls",
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /*
  * Mailboxes
@@ -4222,6 +5105,43 @@ gami_manager_voicemail_users_list_finish (GamiManager *ami,
     return list_action_finish (ami, result, func, error);
 }
 
+/**
+ * gami_manager_voicemail_users_list_stream_async:
+ * @ami: #GamiManager
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve a list of voicemail users
+ *
+ * Like gami_manager_voicemail_users_list_async(), but each item is passed to
+ * @func as soon as it has been received instead of being collected into a
+ * list. Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_voicemail_users_list_stream_async (GamiManager *ami,
+                                                GamiListItemFunc func,
+                                                gpointer func_data,
+                                                const gchar *action_id,
+                                                GAsyncReadyCallback callback,
+                                                gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_voicemail_users_list_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "VoicemailUserEntryComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "VoicemailUsersList",
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /**
  * gami_manager_mailbox_count:
@@ -4525,6 +5445,43 @@ gami_manager_core_show_channels_finish (GamiManager *ami,
     return list_action_finish (ami, result, func, error);
 }
 
+/**
+ * gami_manager_core_show_channels_stream_async:
+ * @ami: #GamiManager
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve a list of currently active channels
+ *
+ * Like gami_manager_core_show_channels_async(), but each item is passed to
+ * @func as soon as it has been received instead of being collected into a
+ * list. Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_core_show_channels_stream_async (GamiManager *ami,
+                                              GamiListItemFunc func,
+                                              gpointer func_data,
+                                              const gchar *action_id,
+                                              GAsyncReadyCallback callback,
+                                              gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_core_show_channels_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "CoreShowChannelsComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "CoreShowChannels",
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /**
  * gami_manager_core_settings:
@@ -4669,6 +5626,90 @@ gami_manager_iax_peerlist_finish (GamiManager *ami,
     return list_action_finish (ami, result, func, error);
 }
 
+/**
+ * gami_manager_iax_peerlist_stream_async:
+ * @ami: #GamiManager
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve a list of IAX2 peers
+ *
+ * Like gami_manager_iax_peerlist_async(), but each item is passed to @func
+ * as soon as it has been received instead of being collected into a list.
+ * Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_iax_peerlist_stream_async (GamiManager *ami,
+                                        GamiListItemFunc func,
+                                        gpointer func_data,
+                                        const gchar *action_id,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_iax_peerlist_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "PeerlistComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "IAXpeerlist",
+                       "ActionID", action_id,
+                       NULL);
+}
+
+/**
+ * gami_manager_iax_peers_async:
+ * @ami: #GamiManager
+ * @func: function called for each peer
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve the IAX2 peers configured on the server. Each PeerEntry event is
+ * decoded into a #GamiPeerEntryEvent and passed to @func as soon as it has
+ * been received. Finish with gami_manager_list_stream_finish().
+ *
+ * Unlike IAXpeerlist, the IAXpeers action is available since asterisk 1.6.0,
+ * which does not announce the end of the list; the list is completed by
+ * #GamiManager:list-timeout in that case.
+ */
+void
+gami_manager_iax_peers_async (GamiManager *ami,
+                              GamiPeerEntryFunc func,
+                              gpointer func_data,
+                              const gchar *action_id,
+                              GAsyncReadyCallback callback,
+                              gpointer user_data)
+{
+    GamiListStream *stream;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (func != NULL);
+
+    stream = gami_list_stream_new (ami,
+                                   "PeerlistComplete",
+                                   (GamiListItemFunc) func,
+                                   func_data);
+    stream->item_type = GAMI_EVENT_TYPE_PEER_ENTRY;
+    stream->idle_complete = TRUE;
+
+    send_list_action (ami,
+                      (GamiAsyncFunc) gami_manager_iax_peers_async,
+                      "IAXpeers",
+                      NULL,
+                      stream,
+                      action_id,
+                      callback,
+                      user_data);
+}
+
 
 /**
  * gami_manager_sip_peers:
@@ -4741,15 +5782,52 @@ gami_manager_sip_peers_finish (GamiManager *ami,
                                error);
 }
 
-
 /**
- * gami_manager_sip_showpeer:
+ * gami_manager_sip_peers_stream_async:
  * @ami: #GamiManager
- * @peer: SIP peer to get status information for
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
  * @action_id: ActionID to ease response matching
- * @error: A location to return an error of type #GIOChannelError
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
  *
- * Retrieve status information for @peer
+ * Retrieve a list of SIP peers
+ *
+ * Like gami_manager_sip_peers_async(), but each item is passed to @func as
+ * soon as it has been received instead of being collected into a list.
+ * Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_sip_peers_stream_async (GamiManager *ami,
+                                     GamiListItemFunc func,
+                                     gpointer func_data,
+                                     const gchar *action_id,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_sip_peers_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "PeerlistComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "SIPpeers",
+                       "ActionID", action_id,
+                       NULL);
+}
+
+
+/**
+ * gami_manager_sip_showpeer:
+ * @ami: #GamiManager
+ * @peer: SIP peer to get status information for
+ * @action_id: ActionID to ease response matching
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Retrieve status information for @peer
  *
  * Returns: #GHashTable of peer status information on success, %NULL on failure
  */
@@ -4890,6 +5968,43 @@ gami_manager_sip_showregistry_finish (GamiManager *ami,
     return list_action_finish (ami, result, func, error);
 }
 
+/**
+ * gami_manager_sip_showregistry_stream_async:
+ * @ami: #GamiManager
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve registry information of SIP peers
+ *
+ * Like gami_manager_sip_showregistry_async(), but each item is passed to
+ * @func as soon as it has been received instead of being collected into a
+ * list. Finish with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_sip_showregistry_stream_async (GamiManager *ami,
+                                            GamiListItemFunc func,
+                                            gpointer func_data,
+                                            const gchar *action_id,
+                                            GAsyncReadyCallback callback,
+                                            gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_sip_showregistry_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "RegistrationsComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "SIPshowregistry",
+                       "ActionID", action_id,
+                       NULL);
+}
+
 
 /**
  * gami_manager_status:
@@ -4969,6 +6084,178 @@ gami_manager_status_finish (GamiManager *ami,
                                error);
 }
 
+/**
+ * gami_manager_status_stream_async:
+ * @ami: #GamiManager
+ * @channel: Only retrieve status information for this channel
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve status information of active channels (or @channel)
+ *
+ * Like gami_manager_status_async(), but each item is passed to @func as soon
+ * as it has been received instead of being collected into a list. Finish
+ * with gami_manager_list_stream_finish().
+ */
+void
+gami_manager_status_stream_async (GamiManager *ami,
+                                  const gchar *channel,
+                                  GamiListItemFunc func,
+                                  gpointer func_data,
+                                  const gchar *action_id,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_status_stream_async,
+                       stream_hook,
+                       gami_list_stream_new (ami,
+                                             "StatusComplete",
+                                             func,
+                                             func_data),
+                       callback,
+                       user_data,
+                       "Status",
+                       "Channel", channel,
+                       "ActionID", action_id,
+                       NULL);
+}
+
+
+/**
+ * gami_manager_status_variables:
+ * @ami: #GamiManager
+ * @channel: Only retrieve status information for this channel
+ * @variables: %NULL-terminated array of variables to retrieve for each
+ *             channel
+ * @func: function called for each channel
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Retrieve status information of active channels (or @channel) together
+ * with the values of @variables. Instead of being collected into a list,
+ * each channel is passed to @func as soon as it has been received.
+ *
+ * Returns: the number of channels on success, -1 on failure
+ */
+gint
+gami_manager_status_variables (GamiManager *ami,
+                               const gchar *channel,
+                               const gchar **variables,
+                               GamiChannelStatusFunc func,
+                               gpointer func_data,
+                               const gchar *action_id,
+                               GError **error)
+{
+    gint n_channels;
+
+    gami_manager_status_variables_async (ami,
+                                         channel,
+                                         variables,
+                                         func,
+                                         func_data,
+                                         action_id,
+                                         set_sync_result,
+                                         NULL);
+
+    while (! ami->priv->sync_result)
+        g_main_context_iteration (NULL, TRUE);
+
+    n_channels = gami_manager_status_variables_finish (ami,
+                                                       ami->priv->sync_result,
+                                                       error);
+    g_object_unref (ami->priv->sync_result);
+    ami->priv->sync_result = NULL;
+
+    return n_channels;
+}
+
+/**
+ * gami_manager_status_variables_async:
+ * @ami: #GamiManager
+ * @channel: Only retrieve status information for this channel
+ * @variables: %NULL-terminated array of variables to retrieve for each
+ *             channel
+ * @func: function called for each channel
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve status information of active channels (or @channel) together
+ * with the values of @variables, see gami_manager_status_variables()
+ */
+void
+gami_manager_status_variables_async (GamiManager *ami,
+                                     const gchar *channel,
+                                     const gchar **variables,
+                                     GamiChannelStatusFunc func,
+                                     gpointer func_data,
+                                     const gchar *action_id,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data)
+{
+    GamiStatusStream *stream;
+    gchar            *vars;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (func != NULL);
+
+    stream = g_new0 (GamiStatusStream, 1);
+    stream->ami       = ami;
+    stream->func      = func;
+    stream->user_data = func_data;
+
+    vars = variables ? g_strjoinv (",", (gchar **) variables) : NULL;
+
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_status_variables_async,
+                       status_variables_hook,
+                       stream,
+                       callback,
+                       user_data,
+                       "Status",
+                       "Channel", channel,
+                       "Variables", vars,
+                       "ActionID", action_id,
+                       NULL);
+    g_free (vars);
+}
+
+/**
+ * gami_manager_status_variables_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_status_variables_async()
+ *
+ * Returns: the number of channels on success, -1 on failure
+ */
+gint
+gami_manager_status_variables_finish (GamiManager *ami,
+                                      GAsyncResult *result,
+                                      GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), -1);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), -1);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+    g_warn_if_fail (g_simple_async_result_is_valid (result,
+                                                    G_OBJECT (ami),
+                                                    gami_manager_status_variables_async));
+    if (g_simple_async_result_propagate_error (simple, error))
+        return -1;
+
+    return (gint) g_simple_async_result_get_op_res_gssize (simple);
+}
 
 /**
  * gami_manager_extension_state:
@@ -5056,6 +6343,58 @@ gami_manager_extension_state_finish (GamiManager *ami,
     return hash_action_finish (ami, result, func, error);
 }
 
+/**
+ * gami_manager_show_dialplan_stream_async:
+ * @ami: #GamiManager
+ * @extension: Only show this extension
+ * @context: Only show this context
+ * @func: function called for each item
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Retrieve the dialplan (or the part matching @context and @extension). Each
+ * ListDialplan event is passed to @func as soon as it has been received;
+ * there is one event per priority and one per included context. Finish with
+ * gami_manager_list_stream_finish(). See gami_dialplan_load_async() to
+ * build a #GamiDialplan snapshot.
+ *
+ * As older servers send no event at the end of the dialplan, the list may be
+ * completed by #GamiManager:list-timeout.
+ */
+void
+gami_manager_show_dialplan_stream_async (GamiManager *ami,
+                                         const gchar *extension,
+                                         const gchar *context,
+                                         GamiListItemFunc func,
+                                         gpointer func_data,
+                                         const gchar *action_id,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data)
+{
+    GHashTable *params;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (func != NULL);
+
+    params = g_hash_table_new (g_str_hash, g_str_equal);
+    if (extension)
+        g_hash_table_insert (params, "Extension", (gpointer) extension);
+    if (context)
+        g_hash_table_insert (params, "Context", (gpointer) context);
+
+    send_list_action (ami,
+                      (GamiAsyncFunc) gami_manager_show_dialplan_stream_async,
+                      "ShowDialPlan",
+                      params,
+                      gami_list_stream_new (ami, NULL, func, func_data),
+                      action_id,
+                      callback,
+                      user_data);
+    g_hash_table_unref (params);
+}
+
 
 /**
  * gami_manager_ping:
@@ -5774,7 +7113,8 @@ gami_manager_command (GamiManager *ami,
  * @callback: Callback for asynchronious operation.
  * @user_data: User data to pass to the callback.
  *
- * Execute a CLI command and get its output
+ * Execute a CLI command and get its output. Both the "Response: Follows"
+ * format and the "Output:" headers of newer servers are understood.
  */
 void
 gami_manager_command_async (GamiManager *ami,
@@ -5785,16 +7125,13 @@ gami_manager_command_async (GamiManager *ami,
 {
     g_assert (command != NULL);
 
-    send_async_action (ami,
-                       (GamiAsyncFunc) gami_manager_command_async,
-                       command_hook,
-                       "Follows",
-                       callback,
-                       user_data,
-                       "Command",
-                       "Command", command,
-                       "ActionID", action_id,
-                       NULL);
+    send_command_action (ami,
+                         (GamiAsyncFunc) gami_manager_command_async,
+                         gami_command_stream_new (ami, NULL, NULL),
+                         command,
+                         action_id,
+                         callback,
+                         user_data);
 }
 
 /**
@@ -5818,6 +7155,44 @@ gami_manager_command_finish (GamiManager *ami,
                                  error);
 }
 
+/**
+ * gami_manager_command_stream_async:
+ * @ami: #GamiManager
+ * @command: the CLI command to execute
+ * @func: function called for each line of output
+ * @func_data: user data to pass to @func
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Execute a CLI command and pass its output to @func line by line, as it
+ * arrives: unlike gami_manager_command_async(), neither the response nor
+ * the whole output is held in memory, which matters for commands like
+ * "core show channels verbose" on large systems. Finish the operation with
+ * gami_manager_list_stream_finish(), which returns the number of lines.
+ */
+void
+gami_manager_command_stream_async (GamiManager *ami,
+                                   const gchar *command,
+                                   GamiCommandOutputFunc func,
+                                   gpointer func_data,
+                                   const gchar *action_id,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data)
+{
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (command != NULL);
+    g_return_if_fail (func != NULL);
+
+    send_command_action (ami,
+                         (GamiAsyncFunc) gami_manager_command_stream_async,
+                         gami_command_stream_new (ami, func, func_data),
+                         command,
+                         action_id,
+                         callback,
+                         user_data);
+}
+
 
 /**
  * gami_manager_agi:
@@ -6484,114 +7859,694 @@ gami_manager_get_config_json_finish (GamiManager *ami,
     return hash_action_finish (ami, result, func, error);
 }
 
-
 /**
- * gami_manager_create_config:
+ * gami_manager_get_config_tree:
  * @ami: #GamiManager
- * @filename: The name of the configuration file to create
+ * @filename: The name of the configuration file to get content for
  * @action_id: ActionID to ease response matching
  * @error: A location to return an error of type #GIOChannelError
  *
- * Create an empty configurion file @filename
+ * Get content of configuration file @filename using the GetConfig action, parsed into a
+ * #GamiConfig. This is the preferred way to read configuration files, as it avoids
+ * decoding the numbered headers returned by gami_manager_get_config().
  *
- * Returns: %TRUE on success, %FALSE on failure
+ * Returns: A new #GamiConfig on success, %NULL on failure
  */
-gboolean
-gami_manager_create_config (GamiManager *ami,
-                            const gchar *filename,
-                            const gchar *action_id,
-                            GError **error)
+GamiConfig *
+gami_manager_get_config_tree (GamiManager *ami,
+                              const gchar *filename,
+                              const gchar *action_id,
+                              GError **error)
 {
-    gami_manager_create_config_async (ami,
-                                      filename,
-                                      action_id,
-                                      set_sync_result,
-                                      NULL);
-    return wait_bool_result (ami, gami_manager_create_config_finish, error);
+    gami_manager_get_config_tree_async (ami,
+                                        filename,
+                                        action_id,
+                                        set_sync_result,
+                                        NULL);
+    return wait_pointer_result (ami,
+                                (GamiPointerFinishFunc)
+                                gami_manager_get_config_tree_finish,
+                                error);
 }
 
 /**
- * gami_manager_create_config_async:
+ * gami_manager_get_config_tree_async:
  * @ami: #GamiManager
- * @filename: The name of the configuration file to create
+ * @filename: The name of the configuration file to get content for
  * @action_id: ActionID to ease response matching
  * @callback: Callback for asynchronious operation.
  * @user_data: User data to pass to the callback.
  *
- * Create an empty configurion file @filename
+ * Get content of configuration file @filename using the GetConfig action, parsed into a
+ * #GamiConfig
  */
 void
-gami_manager_create_config_async (GamiManager *ami,
-                                  const gchar *filename,
-                                  const gchar *action_id,
-                                  GAsyncReadyCallback callback,
-                                  gpointer user_data)
+gami_manager_get_config_tree_async (GamiManager *ami,
+                                    const gchar *filename,
+                                    const gchar *action_id,
+                                    GAsyncReadyCallback callback,
+                                    gpointer user_data)
 {
     g_assert (filename != NULL);
 
     send_async_action (ami,
-                       (GamiAsyncFunc) gami_manager_create_config_async,
-                       bool_hook,
-                       "Success",
+                       (GamiAsyncFunc) gami_manager_get_config_tree_async,
+                       config_hook,
+                       NULL,
                        callback,
                        user_data,
-                       "CreateConfig",
+                       "GetConfig",
                        "Filename", filename,
                        "ActionID", action_id,
                        NULL);
 }
 
 /**
- * gami_manager_create_config_finish:
+ * gami_manager_get_config_tree_finish:
  * @ami: #GamiManager
  * @result: #GAsyncResult
  * @error: a #GError, or %NULL
  *
  * Finishes an asynchronous action started with
- * gami_manager_create_config_async()
+ * gami_manager_get_config_tree_async()
  *
- * Returns: %TRUE if the action succeeded, otherwise %FALSE
+ * Returns: A new #GamiConfig on success, %NULL on failure
  */
-gboolean
-gami_manager_create_config_finish (GamiManager *ami,
-                                   GAsyncResult *result,
-                                   GError **error)
+GamiConfig *
+gami_manager_get_config_tree_finish (GamiManager *ami,
+                                     GAsyncResult *result,
+                                     GError **error)
 {
-    return bool_action_finish (ami,
-                               result,
-                               (GamiAsyncFunc) gami_manager_create_config_async,
-                               error);
-}
+    GamiAsyncFunc func = (GamiAsyncFunc) gami_manager_get_config_tree_async;
+    GamiConfig   *config;
 
+    config = pointer_action_finish (ami, result, func, error);
+
+    return config ? gami_config_ref (config) : NULL;
+}
 
 /**
- * gami_manager_originate:
+ * gami_manager_get_config_json_tree:
  * @ami: #GamiManager
- * @channel: The name of the channel to call. Once the channel has answered,
- *           the call will be passed to the specified exten/context/priority or
- *           application/data
- * @application_exten: Extension to dial or application to call (depending on
- *                     @priority)
- * @data_context: Context to dial or data to pass to application (depending on
- *                @priority)
- * @priority: Priority to dial - if %NULL, @application_exten will be
- *            interpretated as application and @data_context as data
- * @timeout: Time to wait for @channel to answer in milliseconds
- * @caller_id: CallerID to set on the outgoing channel
- * @account: AccountCode to set for the call
- * @variables: A #GHashTable with name / value pairs to pass as channel
- *             variables
- * @async: Whether to originate call asynchronously - this allows to originate
- *         further calls before a response is received
+ * @filename: The name of the configuration file to get content for
  * @action_id: ActionID to ease response matching
  * @error: A location to return an error of type #GIOChannelError
  *
- * Generate an outbound call from Asterisk and connect the channel to
- * Exten / Context / Priority or execute Application (Data) on the channel
+ * Get content of configuration file @filename using the GetConfigJSON action, parsed into a
+ * #GamiConfig.
  *
- * Returns: %TRUE on success, %FALSE on failure
+ * Returns: A new #GamiConfig on success, %NULL on failure
  */
-gboolean
+GamiConfig *
+gami_manager_get_config_json_tree (GamiManager *ami,
+                                   const gchar *filename,
+                                   const gchar *action_id,
+                                   GError **error)
+{
+    gami_manager_get_config_json_tree_async (ami,
+                                             filename,
+                                             action_id,
+                                             set_sync_result,
+                                             NULL);
+    return wait_pointer_result (ami,
+                                (GamiPointerFinishFunc)
+                                gami_manager_get_config_json_tree_finish,
+                                error);
+}
+
+/**
+ * gami_manager_get_config_json_tree_async:
+ * @ami: #GamiManager
+ * @filename: The name of the configuration file to get content for
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Get content of configuration file @filename using the GetConfigJSON action, parsed into a
+ * #GamiConfig
+ */
+void
+gami_manager_get_config_json_tree_async (GamiManager *ami,
+                                         const gchar *filename,
+                                         const gchar *action_id,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data)
+{
+    g_assert (filename != NULL);
+
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_get_config_json_tree_async,
+                       config_hook,
+                       GINT_TO_POINTER (TRUE),
+                       callback,
+                       user_data,
+                       "GetConfigJSON",
+                       "Filename", filename,
+                       "ActionID", action_id,
+                       NULL);
+}
+
+/**
+ * gami_manager_get_config_json_tree_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_get_config_json_tree_async()
+ *
+ * Returns: A new #GamiConfig on success, %NULL on failure
+ */
+GamiConfig *
+gami_manager_get_config_json_tree_finish (GamiManager *ami,
+                                          GAsyncResult *result,
+                                          GError **error)
+{
+    GamiAsyncFunc func = (GamiAsyncFunc) gami_manager_get_config_json_tree_async;
+    GamiConfig   *config;
+
+    config = pointer_action_finish (ami, result, func, error);
+
+    return config ? gami_config_ref (config) : NULL;
+}
+
+
+/**
+ * gami_manager_create_config:
+ * @ami: #GamiManager
+ * @filename: The name of the configuration file to create
+ * @action_id: ActionID to ease response matching
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Create an empty configurion file @filename
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_manager_create_config (GamiManager *ami,
+                            const gchar *filename,
+                            const gchar *action_id,
+                            GError **error)
+{
+    gami_manager_create_config_async (ami,
+                                      filename,
+                                      action_id,
+                                      set_sync_result,
+                                      NULL);
+    return wait_bool_result (ami, gami_manager_create_config_finish, error);
+}
+
+/**
+ * gami_manager_create_config_async:
+ * @ami: #GamiManager
+ * @filename: The name of the configuration file to create
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Create an empty configurion file @filename
+ */
+void
+gami_manager_create_config_async (GamiManager *ami,
+                                  const gchar *filename,
+                                  const gchar *action_id,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    g_assert (filename != NULL);
+
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_create_config_async,
+                       bool_hook,
+                       "Success",
+                       callback,
+                       user_data,
+                       "CreateConfig",
+                       "Filename", filename,
+                       "ActionID", action_id,
+                       NULL);
+}
+
+/**
+ * gami_manager_create_config_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_create_config_async()
+ *
+ * Returns: %TRUE if the action succeeded, otherwise %FALSE
+ */
+gboolean
+gami_manager_create_config_finish (GamiManager *ami,
+                                   GAsyncResult *result,
+                                   GError **error)
+{
+    return bool_action_finish (ami,
+                               result,
+                               (GamiAsyncFunc) gami_manager_create_config_async,
+                               error);
+}
+
+/**
+ * gami_manager_update_config:
+ * @ami: #GamiManager
+ * @src_filename: The configuration file to read
+ * @dst_filename: The configuration file to write, or %NULL for @src_filename
+ * @changes: A #GSList of #GamiConfigChange<!-- -->s to apply in order
+ * @reload: Value of the Reload header ("yes" or, on servers supporting it,
+ *          the name of a module), or %NULL to not reload
+ * @action_id: ActionID to ease response matching
+ * @failed_chunk: location to return the index of the UpdateConfig action
+ *                which failed, or %NULL
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Apply @changes to @src_filename and save the result as @dst_filename,
+ * see gami_manager_update_config_async()
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_manager_update_config (GamiManager *ami,
+                            const gchar *src_filename,
+                            const gchar *dst_filename,
+                            const GSList *changes,
+                            const gchar *reload,
+                            const gchar *action_id,
+                            gint *failed_chunk,
+                            GError **error)
+{
+    gboolean res;
+
+    gami_manager_update_config_async (ami,
+                                      src_filename,
+                                      dst_filename,
+                                      changes,
+                                      reload,
+                                      action_id,
+                                      set_sync_result,
+                                      NULL);
+
+    while (! ami->priv->sync_result)
+        g_main_context_iteration (NULL, TRUE);
+
+    res = gami_manager_update_config_finish (ami,
+                                             ami->priv->sync_result,
+                                             failed_chunk,
+                                             error);
+
+    g_object_unref (ami->priv->sync_result);
+    ami->priv->sync_result = NULL;
+
+    return res;
+}
+
+/**
+ * gami_manager_update_config_async:
+ * @ami: #GamiManager
+ * @src_filename: The configuration file to read
+ * @dst_filename: The configuration file to write, or %NULL for @src_filename
+ * @changes: A #GSList of #GamiConfigChange<!-- -->s to apply in order
+ * @reload: Value of the Reload header ("yes" or, on servers supporting it,
+ *          the name of a module), or %NULL to not reload
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Apply @changes to @src_filename and save the result as @dst_filename using
+ * the UpdateConfig action. All changes are encoded as numbered headers of a
+ * single action; as the server only parses a limited number of headers per
+ * action, larger lists are split into several UpdateConfig actions which are
+ * sent one after another, each one reading the file written by the
+ * previous one. Reload is only requested with the last action.
+ *
+ * The update is not transactional: if one of the actions fails, the update
+ * stops, but the changes of earlier actions remain applied to @dst_filename
+ * and cannot be rolled back. gami_manager_update_config_finish() reports
+ * the index of the failed action, so that the changes sent with action 0 up
+ * to the one before it are known to be applied; the error message also
+ * gives the number of applied changes. To keep the original file intact,
+ * write to a different @dst_filename and only use it once the update
+ * succeeded.
+ *
+ * Cached responses of GetConfig and GetConfigJSON are invalidated.
+ */
+void
+gami_manager_update_config_async (GamiManager *ami,
+                                  const gchar *src_filename,
+                                  const gchar *dst_filename,
+                                  const GSList *changes,
+                                  const gchar *reload,
+                                  const gchar *action_id,
+                                  GAsyncReadyCallback callback,
+                                  gpointer user_data)
+{
+    GamiConfigUpdate *update;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (src_filename != NULL);
+
+    update = gami_config_update_new (ami,
+                                     src_filename,
+                                     dst_filename,
+                                     changes,
+                                     reload);
+
+    start_config_update (ami,
+                         (GamiAsyncFunc) gami_manager_update_config_async,
+                         update,
+                         action_id,
+                         callback,
+                         user_data);
+}
+
+/**
+ * gami_manager_update_config_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @failed_chunk: location to return the index of the UpdateConfig action
+ *                which failed, or %NULL
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_update_config_async(). On failure, @failed_chunk is set to
+ * the index of the failed UpdateConfig action; the changes sent with the
+ * actions before it have been applied. On success, it is set to -1.
+ *
+ * Returns: %TRUE if all changes were applied, otherwise %FALSE
+ */
+gboolean
+gami_manager_update_config_finish (GamiManager *ami,
+                                   GAsyncResult *result,
+                                   gint *failed_chunk,
+                                   GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), FALSE);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+    g_warn_if_fail (g_simple_async_result_is_valid (result, G_OBJECT (ami),
+                                                    gami_manager_update_config_async));
+
+    if (failed_chunk)
+        *failed_chunk = g_simple_async_result_get_op_res_gssize (simple);
+
+    return ! g_simple_async_result_propagate_error (simple, error);
+}
+
+/* modules to reload after their configuration file changed */
+static const struct {
+    const gchar *filename;
+    const gchar *module;
+} config_modules [] = {
+    { "extensions.conf",  "pbx_config" },
+    { "sip.conf",         "chan_sip" },
+    { "iax.conf",         "chan_iax2" },
+    { "chan_dahdi.conf",  "chan_dahdi" },
+    { "zapata.conf",      "chan_zap" },
+    { "skinny.conf",      "chan_skinny" },
+    { "mgcp.conf",        "chan_mgcp" },
+    { "agents.conf",      "chan_agent" },
+    { "queues.conf",      "app_queue" },
+    { "voicemail.conf",   "app_voicemail" },
+    { "meetme.conf",      "app_meetme" },
+    { "followme.conf",    "app_followme" },
+    { "musiconhold.conf", "res_musiconhold" },
+    { "res_odbc.conf",    "res_odbc" },
+    { "manager.conf",     "manager" },
+    { "extconfig.conf",   "extconfig" },
+    { "logger.conf",      "logger" },
+    { "cdr.conf",         "cdr" },
+    { "enum.conf",        "enum" },
+    { "dnsmgr.conf",      "dnsmgr" },
+    { "rtp.conf",         "rtp" },
+    { "http.conf",        "http" },
+    { NULL, NULL }
+};
+
+static const gchar *
+lookup_config_module (const gchar *filename)
+{
+    guint i;
+
+    for (i = 0; config_modules [i].filename; i++)
+        if (! strcmp (config_modules [i].filename, filename))
+            return config_modules [i].module;
+
+    return NULL;
+}
+
+typedef struct {
+    GSimpleAsyncResult *simple;
+    gchar              *filename;
+    GamiConfig         *desired;
+    gchar              *module;
+    gchar              *action_id;
+} ApplyConfigData;
+
+static void
+apply_config_done (ApplyConfigData *data, GError *error)
+{
+    if (error) {
+        g_simple_async_result_set_from_error (data->simple, error);
+        g_error_free (error);
+    } else
+        g_simple_async_result_set_op_res_gboolean (data->simple, TRUE);
+
+    g_simple_async_result_complete (data->simple);
+
+    g_object_unref (data->simple);
+    g_free (data->filename);
+    gami_config_unref (data->desired);
+    g_free (data->module);
+    g_free (data->action_id);
+    g_free (data);
+}
+
+static void
+apply_config_reload_cb (GamiManager *ami,
+                        GAsyncResult *result,
+                        ApplyConfigData *data)
+{
+    GError *error = NULL;
+
+    gami_manager_reload_finish (ami, result, &error);
+    apply_config_done (data, error);
+}
+
+static void
+apply_config_update_cb (GamiManager *ami,
+                        GAsyncResult *result,
+                        ApplyConfigData *data)
+{
+    GError *error = NULL;
+
+    if (! gami_manager_update_config_finish (ami, result, NULL, &error)
+        || ! data->module || ! *data->module) {
+        apply_config_done (data, error);
+        return;
+    }
+
+    gami_manager_reload_async (ami,
+                               data->module,
+                               NULL,
+                               (GAsyncReadyCallback) apply_config_reload_cb,
+                               data);
+}
+
+static void
+apply_config_get_cb (GamiManager *ami,
+                     GAsyncResult *result,
+                     ApplyConfigData *data)
+{
+    GamiConfig *current;
+    GSList     *changes;
+    GError     *error = NULL;
+
+    current = pointer_action_finish (ami,
+                                     result,
+                                     (GamiAsyncFunc)
+                                     gami_manager_apply_config_async,
+                                     &error);
+    if (! current) {
+        apply_config_done (data, error);
+        return;
+    }
+
+    changes = gami_config_diff (current, data->desired);
+
+    /* nothing to change, nothing to reload */
+    if (! changes) {
+        apply_config_done (data, NULL);
+        return;
+    }
+
+    gami_manager_update_config_async (ami,
+                                      data->filename,
+                                      NULL,
+                                      changes,
+                                      NULL,
+                                      data->action_id,
+                                      (GAsyncReadyCallback)
+                                      apply_config_update_cb,
+                                      data);
+
+    g_slist_foreach (changes, (GFunc) gami_config_change_free, NULL);
+    g_slist_free (changes);
+}
+
+/**
+ * gami_manager_apply_config:
+ * @ami: #GamiManager
+ * @filename: The configuration file to change
+ * @desired: The desired content of @filename
+ * @module: The module to reload afterwards, %NULL to pick the module
+ *          reading @filename, or "" to not reload
+ * @action_id: ActionID to ease response matching
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Make @filename match @desired, see gami_manager_apply_config_async()
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_manager_apply_config (GamiManager *ami,
+                           const gchar *filename,
+                           GamiConfig *desired,
+                           const gchar *module,
+                           const gchar *action_id,
+                           GError **error)
+{
+    gami_manager_apply_config_async (ami,
+                                     filename,
+                                     desired,
+                                     module,
+                                     action_id,
+                                     set_sync_result,
+                                     NULL);
+    return wait_bool_result (ami, gami_manager_apply_config_finish, error);
+}
+
+/**
+ * gami_manager_apply_config_async:
+ * @ami: #GamiManager
+ * @filename: The configuration file to change
+ * @desired: The desired content of @filename
+ * @module: The module to reload afterwards, %NULL to pick the module
+ *          reading @filename, or "" to not reload
+ * @action_id: ActionID to ease response matching
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Make @filename match @desired: its current content is retrieved with
+ * GetConfig, only the changes computed by gami_config_diff() are sent with
+ * gami_manager_update_config() and only @module is reloaded, instead of
+ * rewriting the file and reloading everything. Nothing is sent or reloaded
+ * if the file already matches.
+ *
+ * The current content is always requested from the server, even if a
+ * response to GetConfig is cached or in flight, so that the changes are not
+ * computed against an outdated copy. Cached responses of GetConfig and
+ * GetConfigJSON are invalidated once the file has been updated.
+ *
+ * If @module is %NULL and the module reading @filename is not known, the
+ * file is changed without reloading anything.
+ */
+void
+gami_manager_apply_config_async (GamiManager *ami,
+                                 const gchar *filename,
+                                 GamiConfig *desired,
+                                 const gchar *module,
+                                 const gchar *action_id,
+                                 GAsyncReadyCallback callback,
+                                 gpointer user_data)
+{
+    ApplyConfigData *data;
+
+    g_return_if_fail (GAMI_IS_MANAGER (ami));
+    g_return_if_fail (filename != NULL);
+    g_return_if_fail (desired != NULL);
+
+    data = g_new (ApplyConfigData, 1);
+    data->simple    = g_simple_async_result_new (G_OBJECT (ami),
+                                                 callback,
+                                                 user_data,
+                                                 gami_manager_apply_config_async);
+    data->filename  = g_strdup (filename);
+    data->desired   = gami_config_ref (desired);
+    data->module    = g_strdup (module ? module
+                                       : lookup_config_module (filename));
+    data->action_id = g_strdup (action_id);
+
+    /* sent under our own tag rather than as get_config_tree, so neither the
+     * response cache nor a shared in-flight GetConfig can hand out an
+     * outdated copy to diff against */
+    send_async_action (ami,
+                       (GamiAsyncFunc) gami_manager_apply_config_async,
+                       config_hook,
+                       NULL,
+                       (GAsyncReadyCallback) apply_config_get_cb,
+                       data,
+                       "GetConfig",
+                       "Filename", filename,
+                       "ActionID", action_id,
+                       NULL);
+}
+
+/**
+ * gami_manager_apply_config_finish:
+ * @ami: #GamiManager
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous action started with
+ * gami_manager_apply_config_async()
+ *
+ * Returns: %TRUE if @filename matches the desired content, otherwise %FALSE
+ */
+gboolean
+gami_manager_apply_config_finish (GamiManager *ami,
+                                  GAsyncResult *result,
+                                  GError **error)
+{
+    return bool_action_finish (ami,
+                               result,
+                               (GamiAsyncFunc) gami_manager_apply_config_async,
+                               error);
+}
+
+
+/**
+ * gami_manager_originate:
+ * @ami: #GamiManager
+ * @channel: The name of the channel to call. Once the channel has answered,
+ *           the call will be passed to the specified exten/context/priority or
+ *           application/data
+ * @application_exten: Extension to dial or application to call (depending on
+ *                     @priority)
+ * @data_context: Context to dial or data to pass to application (depending on
+ *                @priority)
+ * @priority: Priority to dial - if %NULL, @application_exten will be
+ *            interpretated as application and @data_context as data
+ * @timeout: Time to wait for @channel to answer in milliseconds
+ * @caller_id: CallerID to set on the outgoing channel
+ * @account: AccountCode to set for the call
+ * @variables: A #GHashTable with name / value pairs to pass as channel
+ *             variables
+ * @async: Whether to originate call asynchronously - this allows to originate
+ *         further calls before a response is received
+ * @action_id: ActionID to ease response matching
+ * @error: A location to return an error of type #GIOChannelError
+ *
+ * Generate an outbound call from Asterisk and connect the channel to
+ * Exten / Context / Priority or execute Application (Data) on the channel
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
 gami_manager_originate (GamiManager *ami,
                         const gchar *channel,
                         const gchar *application_exten,
@@ -7134,9 +9089,46 @@ static void join_user_event_headers (gchar *key, gchar *value, GString *s)
 static void
 gami_manager_init (GamiManager *ami)
 {
+    guint i;
+
     ami->priv = GAMI_MANAGER_GET_PRIVATE (ami);
     ami->priv->connected = FALSE;
-    ami->priv->packet_buffer = g_queue_new ();
+    ami->priv->recv_buffer = g_string_new ("");
+    for (i = 0; i < N_PACKET_LANES; i++)
+        ami->priv->lanes [i] = g_queue_new ();
+    ami->priv->event_priorities = g_hash_table_new_full (g_str_hash,
+                                                         g_str_equal,
+                                                         g_free,
+                                                         NULL);
+    ami->priv->channel_lanes = g_hash_table_new_full (g_str_hash,
+                                                      g_str_equal,
+                                                      g_free,
+                                                      g_free);
+    ami->priv->coalesce_rules = g_hash_table_new_full (g_str_hash,
+                                                       g_str_equal,
+                                                       g_free,
+                                                       (GDestroyNotify) g_strfreev);
+    ami->priv->coalesce_pending = g_hash_table_new (g_str_hash, g_str_equal);
+    ami->priv->coalesce_queue = g_queue_new ();
+    ami->priv->variable_cache =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free,
+                               (GDestroyNotify) gami_variable_cache_free);
+    ami->priv->in_flight = g_hash_table_new (g_str_hash, g_str_equal);
+    ami->priv->response_ttls = g_hash_table_new_full (g_str_hash,
+                                                      g_str_equal,
+                                                      g_free,
+                                                      NULL);
+    ami->priv->response_cache =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free,
+                               (GDestroyNotify) gami_cached_response_free);
+    ami->priv->command_streams = g_hash_table_new_full (g_str_hash,
+                                                        g_str_equal,
+                                                        g_free,
+                                                        NULL);
+    ami->priv->event_batch =
+        g_ptr_array_new_with_free_func ((GDestroyNotify) g_hash_table_unref);
     g_hook_list_init (&ami->priv->packet_hooks, sizeof (GHook));
 }
 
@@ -7162,13 +9154,45 @@ gami_manager_dispose (GObject *object)
     G_OBJECT_CLASS (gami_manager_parent_class)->dispose (object);
 }
 
+static void
+free_in_flight_action (gchar *key, GamiInFlightAction *action, gpointer data)
+{
+    gami_in_flight_action_free (action);
+}
+
 static void
 gami_manager_finalize (GObject *object)
 {
     GamiManager *ami = GAMI_MANAGER (object);
+    guint        i;
 
-    g_queue_foreach (ami->priv->packet_buffer, (GFunc) gami_packet_free, NULL);
-    g_queue_free (ami->priv->packet_buffer);
+    for (i = 0; i < N_PACKET_LANES; i++) {
+        g_queue_foreach (ami->priv->lanes [i], (GFunc) gami_packet_free, NULL);
+        g_queue_free (ami->priv->lanes [i]);
+    }
+    g_hash_table_unref (ami->priv->event_priorities);
+    g_hash_table_unref (ami->priv->channel_lanes);
+
+    if (ami->priv->coalesce_source)
+        g_source_remove (ami->priv->coalesce_source);
+    g_queue_foreach (ami->priv->coalesce_queue, (GFunc) gami_packet_free, NULL);
+    g_queue_free (ami->priv->coalesce_queue);
+    g_hash_table_unref (ami->priv->coalesce_pending);
+    g_hash_table_unref (ami->priv->coalesce_rules);
+    g_hash_table_unref (ami->priv->variable_cache);
+    g_hash_table_foreach (ami->priv->in_flight,
+                          (GHFunc) free_in_flight_action,
+                          NULL);
+    g_hash_table_unref (ami->priv->in_flight);
+    g_hash_table_unref (ami->priv->response_ttls);
+    g_hash_table_unref (ami->priv->response_cache);
+    g_hash_table_unref (ami->priv->command_streams);
+    g_free (ami->priv->command_output_id);
+    g_ptr_array_free (ami->priv->event_batch, TRUE);
+    g_string_free (ami->priv->recv_buffer, TRUE);
+
+    if (ami->priv->droppable_events)
+        g_hash_table_unref (ami->priv->droppable_events);
 
     g_hook_list_clear (&ami->priv->packet_hooks);
 
@@ -7198,6 +9222,70 @@ gami_manager_get_property (GObject *obj, guint prop_id,
         case PROP_LOG_DOMAIN:
             g_value_set_string (value, ami->priv->log_domain);
             break;
+        case PROP_HIGH_WATERMARK_BYTES:
+            g_value_set_uint (value, ami->priv->high_watermark_bytes);
+            break;
+        case PROP_LOW_WATERMARK_BYTES:
+            g_value_set_uint (value, ami->priv->low_watermark_bytes);
+            break;
+        case PROP_HIGH_WATERMARK_PACKETS:
+            g_value_set_uint (value, ami->priv->high_watermark_packets);
+            break;
+        case PROP_LOW_WATERMARK_PACKETS:
+            g_value_set_uint (value, ami->priv->low_watermark_packets);
+            break;
+        case PROP_DROPPED_EVENTS:
+            g_value_set_uint (value, ami->priv->dropped_events);
+            break;
+        case PROP_READ_BUDGET_BYTES:
+            g_value_set_uint (value, ami->priv->read_budget_bytes);
+            break;
+        case PROP_READ_BUDGET_TIME:
+            g_value_set_uint (value, ami->priv->read_budget_time);
+            break;
+        case PROP_READ_BUDGET_HITS:
+            g_value_set_uint (value, ami->priv->read_budget_hits);
+            break;
+        case PROP_MAX_DISPATCH_TIME:
+            g_value_set_uint (value, (guint) MIN (ami->priv->max_dispatch_time,
+                                                  G_MAXUINT));
+            break;
+        case PROP_COALESCE_WINDOW:
+            g_value_set_uint (value, ami->priv->coalesce_window);
+            break;
+        case PROP_RECEIVED_EVENTS:
+            g_value_set_uint (value, ami->priv->received_events);
+            break;
+        case PROP_COALESCED_EVENTS:
+            g_value_set_uint (value, ami->priv->coalesced_events);
+            break;
+        case PROP_VARIABLE_CACHE_SIZE:
+            g_value_set_uint (value, ami->priv->variable_cache_size);
+            break;
+        case PROP_VARIABLE_CACHE_HITS:
+            g_value_set_uint (value, ami->priv->variable_cache_hits);
+            break;
+        case PROP_VARIABLE_CACHE_MISSES:
+            g_value_set_uint (value, ami->priv->variable_cache_misses);
+            break;
+        case PROP_LIST_TIMEOUT:
+            g_value_set_uint (value, ami->priv->list_timeout);
+            break;
+        case PROP_DEDUPLICATE:
+            g_value_set_boolean (value, ami->priv->deduplicate);
+            break;
+        case PROP_DEDUPLICATED_ACTIONS:
+            g_value_set_uint (value, ami->priv->deduplicated_actions);
+            break;
+        case PROP_RESPONSE_CACHE_HITS:
+            g_value_set_uint (value, ami->priv->response_cache_hits);
+            break;
+        case PROP_RESPONSE_CACHE_MISSES:
+            g_value_set_uint (value, ami->priv->response_cache_misses);
+            break;
+        case PROP_RESPONSE_CACHE_EVICTIONS:
+            g_value_set_uint (value, ami->priv->response_cache_evictions);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
             break;
@@ -7222,6 +9310,42 @@ gami_manager_set_property (GObject *obj, guint prop_id,
             g_free (ami->priv->log_domain);
             ami->priv->log_domain = g_value_dup_string (value);
             break;
+        case PROP_HIGH_WATERMARK_BYTES:
+            ami->priv->high_watermark_bytes = g_value_get_uint (value);
+            release_backpressure (ami);
+            break;
+        case PROP_LOW_WATERMARK_BYTES:
+            ami->priv->low_watermark_bytes = g_value_get_uint (value);
+            release_backpressure (ami);
+            break;
+        case PROP_HIGH_WATERMARK_PACKETS:
+            ami->priv->high_watermark_packets = g_value_get_uint (value);
+            release_backpressure (ami);
+            break;
+        case PROP_LOW_WATERMARK_PACKETS:
+            ami->priv->low_watermark_packets = g_value_get_uint (value);
+            release_backpressure (ami);
+            break;
+        case PROP_READ_BUDGET_BYTES:
+            ami->priv->read_budget_bytes = g_value_get_uint (value);
+            break;
+        case PROP_READ_BUDGET_TIME:
+            ami->priv->read_budget_time = g_value_get_uint (value);
+            break;
+        case PROP_COALESCE_WINDOW:
+            ami->priv->coalesce_window = g_value_get_uint (value);
+            flush_coalesced_events (ami, TRUE);
+            break;
+        case PROP_VARIABLE_CACHE_SIZE:
+            ami->priv->variable_cache_size = g_value_get_uint (value);
+            clear_variable_cache (ami);
+            break;
+        case PROP_LIST_TIMEOUT:
+            ami->priv->list_timeout = g_value_get_uint (value);
+            break;
+        case PROP_DEDUPLICATE:
+            ami->priv->deduplicate = g_value_get_boolean (value);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID (obj, prop_id, pspec);
             break;
@@ -7283,6 +9407,381 @@ gami_manager_class_init (GamiManagerClass *klass)
                                                           G_LOG_DOMAIN,
                                                           G_PARAM_READWRITE));
 
+    /**
+     * GamiManager:high-watermark-bytes:
+     *
+     * Number of buffered bytes at which the manager stops reading from the
+     * server until the buffer drained below #GamiManager:low-watermark-bytes.
+     * A value of 0 disables the limit.
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_HIGH_WATERMARK_BYTES,
+                                     g_param_spec_uint ("high_watermark_bytes",
+                                                        "HighWatermarkBytes",
+                                                        "Buffered bytes at "
+                                                        "which reading stops",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:low-watermark-bytes:
+     *
+     * Number of buffered bytes below which the manager resumes reading from
+     * the server after #GamiManager:high-watermark-bytes was exceeded
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_LOW_WATERMARK_BYTES,
+                                     g_param_spec_uint ("low_watermark_bytes",
+                                                        "LowWatermarkBytes",
+                                                        "Buffered bytes at "
+                                                        "which reading resumes",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:high-watermark-packets:
+     *
+     * Number of buffered packets at which the manager stops reading from the
+     * server until the buffer drained below
+     * #GamiManager:low-watermark-packets. A value of 0 disables the limit.
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_HIGH_WATERMARK_PACKETS,
+                                     g_param_spec_uint ("high_watermark_packets",
+                                                        "HighWatermarkPackets",
+                                                        "Buffered packets at "
+                                                        "which reading stops",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:low-watermark-packets:
+     *
+     * Number of buffered packets below which the manager resumes reading from
+     * the server after #GamiManager:high-watermark-packets was exceeded
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_LOW_WATERMARK_PACKETS,
+                                     g_param_spec_uint ("low_watermark_packets",
+                                                        "LowWatermarkPackets",
+                                                        "Buffered packets at "
+                                                        "which reading resumes",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:dropped-events:
+     *
+     * Number of events discarded according to the policy set with
+     * gami_manager_set_droppable_events()
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_DROPPED_EVENTS,
+                                     g_param_spec_uint ("dropped_events",
+                                                        "DroppedEvents",
+                                                        "Number of dropped "
+                                                        "events",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:read-budget-bytes:
+     *
+     * Maximum number of bytes read from the server in a single main loop
+     * dispatch; remaining data is read in the next iteration, so that other
+     * sources are not starved during event storms. A value of 0 disables the
+     * limit.
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_READ_BUDGET_BYTES,
+                                     g_param_spec_uint ("read_budget_bytes",
+                                                        "ReadBudgetBytes",
+                                                        "Bytes read per "
+                                                        "dispatch",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        64 * 1024,
+                                                        G_PARAM_CONSTRUCT
+                                                        | G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:read-budget-time:
+     *
+     * Maximum time in microseconds spent reading from the server in a single
+     * main loop dispatch. A value of 0 disables the limit.
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_READ_BUDGET_TIME,
+                                     g_param_spec_uint ("read_budget_time",
+                                                        "ReadBudgetTime",
+                                                        "Microseconds spent "
+                                                        "reading per dispatch",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:read-budget-hits:
+     *
+     * Number of dispatches which yielded because the read budget was used up
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_READ_BUDGET_HITS,
+                                     g_param_spec_uint ("read_budget_hits",
+                                                        "ReadBudgetHits",
+                                                        "Number of exhausted "
+                                                        "read budgets",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:max-dispatch-time:
+     *
+     * Longest time in microseconds spent reading from the server in a single
+     * dispatch
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_MAX_DISPATCH_TIME,
+                                     g_param_spec_uint ("max_dispatch_time",
+                                                        "MaxDispatchTime",
+                                                        "Worst dispatch "
+                                                        "duration",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:coalesce-window:
+     *
+     * Time in milliseconds events are held back to be coalesced, see
+     * gami_manager_coalesce_event(). A value of 0 disables coalescing.
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_COALESCE_WINDOW,
+                                     g_param_spec_uint ("coalesce_window",
+                                                        "CoalesceWindow",
+                                                        "Coalescing window "
+                                                        "in milliseconds",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        100,
+                                                        G_PARAM_CONSTRUCT
+                                                        | G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:received-events:
+     *
+     * Number of events received from the server
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_RECEIVED_EVENTS,
+                                     g_param_spec_uint ("received_events",
+                                                        "ReceivedEvents",
+                                                        "Number of received "
+                                                        "events",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:coalesced-events:
+     *
+     * Number of events which were superseded by a later event and not
+     * delivered
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_COALESCED_EVENTS,
+                                     g_param_spec_uint ("coalesced_events",
+                                                        "CoalescedEvents",
+                                                        "Number of coalesced "
+                                                        "events",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:variable-cache-size:
+     *
+     * Maximum number of variables cached per channel. Channel variables are
+     * learned from VarSet events and from the responses of
+     * gami_manager_getvar_cached(), and forgotten when the channel hangs up;
+     * the least recently used variables are evicted first. A value of 0
+     * disables the cache.
+     *
+     * The cache is only accurate if the manager receives VarSet events
+     * (dialplan class, see %GAMI_EVENT_MASK_ALL), so it should only be
+     * enabled with a matching event mask. Dialplan functions are never
+     * cached.
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_VARIABLE_CACHE_SIZE,
+                                     g_param_spec_uint ("variable_cache_size",
+                                                        "VariableCacheSize",
+                                                        "Maximum number of "
+                                                        "cached variables "
+                                                        "per channel",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:variable-cache-hits:
+     *
+     * Number of calls to gami_manager_getvar_cached() answered from the
+     * variable cache
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_VARIABLE_CACHE_HITS,
+                                     g_param_spec_uint ("variable_cache_hits",
+                                                        "VariableCacheHits",
+                                                        "Number of variable "
+                                                        "cache hits",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:variable-cache-misses:
+     *
+     * Number of calls to gami_manager_getvar_cached() which required a GetVar
+     * action
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_VARIABLE_CACHE_MISSES,
+                                     g_param_spec_uint ("variable_cache_misses",
+                                                        "VariableCacheMisses",
+                                                        "Number of variable "
+                                                        "cache misses",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:list-timeout:
+     *
+     * Time in milliseconds after which a list action without known end is
+     * considered complete if no more items arrived, see
+     * gami_manager_list_action_stream_async()
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_LIST_TIMEOUT,
+                                     g_param_spec_uint ("list_timeout",
+                                                        "ListTimeout",
+                                                        "Idle time completing "
+                                                        "a list in "
+                                                        "milliseconds",
+                                                        1,
+                                                        G_MAXUINT,
+                                                        500,
+                                                        G_PARAM_CONSTRUCT
+                                                        | G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:deduplicate:
+     *
+     * Whether identical read-only actions are only sent once while a
+     * response is pending. Requests like gami_manager_sip_peers_async() or
+     * gami_manager_core_settings_async() with the same parameters then share
+     * the response of the first request, each receiving its own copy of the
+     * result. Requests with an explicit ActionID and streaming variants are
+     * always sent.
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_DEDUPLICATE,
+                                     g_param_spec_boolean ("deduplicate",
+                                                           "Deduplicate",
+                                                           "Share responses "
+                                                           "of identical "
+                                                           "actions",
+                                                           FALSE,
+                                                           G_PARAM_READWRITE));
+
+    /**
+     * GamiManager:deduplicated-actions:
+     *
+     * Number of actions which were not sent because an identical action was
+     * awaiting response, see #GamiManager:deduplicate
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_DEDUPLICATED_ACTIONS,
+                                     g_param_spec_uint ("deduplicated_actions",
+                                                        "DeduplicatedActions",
+                                                        "Number of "
+                                                        "deduplicated actions",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:response-cache-hits:
+     *
+     * Number of actions answered from the response cache, see
+     * gami_manager_set_response_ttl()
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_RESPONSE_CACHE_HITS,
+                                     g_param_spec_uint ("response_cache_hits",
+                                                        "ResponseCacheHits",
+                                                        "Number of response "
+                                                        "cache hits",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:response-cache-misses:
+     *
+     * Number of cacheable actions which had to be sent to the server
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_RESPONSE_CACHE_MISSES,
+                                     g_param_spec_uint ("response_cache_misses",
+                                                        "ResponseCacheMisses",
+                                                        "Number of response "
+                                                        "cache misses",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
+    /**
+     * GamiManager:response-cache-evictions:
+     *
+     * Number of cached responses dropped because they expired or were
+     * invalidated
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_RESPONSE_CACHE_EVICTIONS,
+                                     g_param_spec_uint ("response_cache_evictions",
+                                                        "ResponseCacheEvictions",
+                                                        "Number of evicted "
+                                                        "responses",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READABLE));
+
     /**
      * GamiManager::connected:
      * @ami: The #GamiManager that received the signal
@@ -7333,4 +9832,81 @@ gami_manager_class_init (GamiManagerClass *klass)
                                     g_cclosure_marshal_VOID__BOXED,
                                     G_TYPE_NONE,
                                     1, G_TYPE_HASH_TABLE);
+
+    /**
+     * GamiManager::events:
+     * @ami: The #GamiManager that received the signal
+     * @events: (element-type GHashTable): Array of the events that occurred
+     *
+     * The ::events signal is emitted once for all events processed in one
+     * main loop iteration, after the corresponding #GamiManager::event
+     * signals. Events are only collected while a handler is connected.
+     */
+    signals [EVENTS] = g_signal_new ("events",
+                                     G_TYPE_FROM_CLASS (object_class),
+                                     G_SIGNAL_RUN_LAST,
+                                     0,
+                                     NULL,
+                                     NULL,
+                                     g_cclosure_marshal_VOID__BOXED,
+                                     G_TYPE_NONE,
+                                     1, G_TYPE_PTR_ARRAY);
+
+    /**
+     * GamiManager::typed-event:
+     * @ami: The #GamiManager that received the signal
+     * @event: The event that occurred
+     *
+     * The ::typed-event signal is emitted each time Asterisk emits an event,
+     * after the #GamiManager::event signal. The signal detail is the name of
+     * the event, so handlers may connect to e.g. "typed-event::Hangup".
+     * Events are only decoded while a matching handler is connected, and only
+     * once for all handlers.
+     */
+    signals [TYPED_EVENT] = g_signal_new ("typed-event",
+                                          G_TYPE_FROM_CLASS (object_class),
+                                          G_SIGNAL_RUN_LAST
+                                          | G_SIGNAL_DETAILED,
+                                          0,
+                                          NULL,
+                                          NULL,
+                                          g_cclosure_marshal_VOID__BOXED,
+                                          G_TYPE_NONE,
+                                          1, GAMI_TYPE_EVENT);
+
+    /**
+     * GamiManager::backpressure-on:
+     * @ami: The #GamiManager that received the signal
+     *
+     * The ::backpressure-on signal is emitted when the inbound packet buffer
+     * exceeded its high watermark and the manager stopped reading from the
+     * server
+     */
+    signals [BACKPRESSURE_ON] = g_signal_new ("backpressure-on",
+                                              G_TYPE_FROM_CLASS (object_class),
+                                              G_SIGNAL_RUN_LAST,
+                                              0,
+                                              NULL,
+                                              NULL,
+                                              g_cclosure_marshal_VOID__VOID,
+                                              G_TYPE_NONE,
+                                              0);
+
+    /**
+     * GamiManager::backpressure-off:
+     * @ami: The #GamiManager that received the signal
+     *
+     * The ::backpressure-off signal is emitted when the inbound packet buffer
+     * drained below its low watermark and the manager resumed reading from the
+     * server
+     */
+    signals [BACKPRESSURE_OFF] = g_signal_new ("backpressure-off",
+                                               G_TYPE_FROM_CLASS (object_class),
+                                               G_SIGNAL_RUN_LAST,
+                                               0,
+                                               NULL,
+                                               NULL,
+                                               g_cclosure_marshal_VOID__VOID,
+                                               G_TYPE_NONE,
+                                               0);
 }
@@ -31,8 +31,12 @@
 
 #ifdef GAMI_COMPILATION
 #  include <gami-enums.h>
+#  include <gami-event.h>
+#  include <gami-config.h>
 #else
 #  include <gami/gami-enums.h>
+#  include <gami/gami-event.h>
+#  include <gami/gami-config.h>
 #endif
 
 G_BEGIN_DECLS
@@ -143,6 +147,71 @@ struct _GamiManagerClass
  */
 typedef void (*GamiManagerNewAsyncFunc) (GamiManager *gami,
 										 gpointer user_data);
+
+/**
+ * GamiChannelStatusFunc:
+ * @ami: #GamiManager
+ * @status: status information of a channel (stored as #GHashTable)
+ * @variables: the requested variables of the channel (stored as #GHashTable)
+ * @user_data: user data passed to the function
+ *
+ * Specifies the type of functions passed to
+ * gami_manager_status_variables_async(), called once per channel.
+ *
+ * Returns: %FALSE to ignore the remaining channels, otherwise %TRUE
+ */
+typedef gboolean (*GamiChannelStatusFunc) (GamiManager *ami,
+										   GHashTable *status,
+										   GHashTable *variables,
+										   gpointer user_data);
+
+/**
+ * GamiListItemFunc:
+ * @ami: #GamiManager
+ * @item: an item of the list (stored as #GHashTable)
+ * @user_data: user data passed to the function
+ *
+ * Specifies the type of functions passed to the streaming variants of list
+ * actions like gami_manager_sip_peers_stream_async(), called once per item.
+ * @item is only valid during the call, use g_hash_table_ref() to keep it.
+ *
+ * Returns: %FALSE to ignore the remaining items, otherwise %TRUE
+ */
+typedef gboolean (*GamiListItemFunc) (GamiManager *ami,
+									  GHashTable *item,
+									  gpointer user_data);
+
+/**
+ * GamiPeerEntryFunc:
+ * @ami: #GamiManager
+ * @peer: a peer of the list
+ * @user_data: user data passed to the function
+ *
+ * Specifies the type of functions passed to gami_manager_iax_peers_async(),
+ * called once per peer. @peer is only valid during the call, use
+ * gami_event_ref() to keep it.
+ *
+ * Returns: %FALSE to ignore the remaining peers, otherwise %TRUE
+ */
+typedef gboolean (*GamiPeerEntryFunc) (GamiManager *ami,
+									   GamiPeerEntryEvent *peer,
+									   gpointer user_data);
+
+/**
+ * GamiCommandOutputFunc:
+ * @ami: #GamiManager
+ * @line: a line of output, without line end
+ * @user_data: user data passed to the function
+ *
+ * Specifies the type of functions passed to
+ * gami_manager_command_stream_async(), called once per line of output.
+ * @line is only valid during the call.
+ *
+ * Returns: %FALSE to ignore the remaining output, otherwise %TRUE
+ */
+typedef gboolean (*GamiCommandOutputFunc) (GamiManager *ami,
+										   const gchar *line,
+										   gpointer user_data);
 /**
  * gami_manager_get_type:
  *
@@ -159,6 +228,35 @@ void         gami_manager_new_async (const gchar *host, guint port,
 gboolean     gami_manager_connect (GamiManager *ami, GError **error);
 
 void gami_manager_set_log_domain (GamiManager *ami, const gchar *log_domain);
+void gami_manager_set_droppable_events (GamiManager *ami, const gchar **events);
+void gami_manager_set_event_priority (GamiManager *ami,
+                                      const gchar *event,
+                                      GamiEventPriority priority);
+void gami_manager_coalesce_event (GamiManager *ami,
+                                  const gchar *event,
+                                  const gchar **key_headers);
+void gami_manager_set_response_ttl (GamiManager *ami,
+                                    const gchar *action,
+                                    guint ttl);
+void gami_manager_invalidate_responses (GamiManager *ami,
+                                        const gchar *action);
+void gami_manager_get_lane_stats (GamiManager *ami,
+                                  GamiEventPriority priority,
+                                  guint *delivered,
+                                  guint *pending,
+                                  guint *average_delay,
+                                  guint *max_delay);
+void gami_manager_list_action_stream_async (GamiManager *ami,
+                                            const gchar *action,
+                                            const GHashTable *params,
+                                            GamiListItemFunc func,
+                                            gpointer func_data,
+                                            const gchar *action_id,
+                                            GAsyncReadyCallback callback,
+                                            gpointer user_data);
+gint gami_manager_list_stream_finish (GamiManager *ami,
+                                      GAsyncResult *result,
+                                      GError **error);
 
 gboolean gami_manager_login  (GamiManager *ami,
 							  const gchar *username,
@@ -204,6 +302,36 @@ void gami_manager_getvar_async (GamiManager *ami,
 gchar *gami_manager_getvar_finish (GamiManager *ami,
                                    GAsyncResult *result,
                                    GError **error);
+gchar *gami_manager_getvar_cached (GamiManager *ami,
+                                   const gchar *channel,
+                                   const gchar *variable,
+                                   const gchar *action_id,
+                                   GError **error);
+void gami_manager_getvar_cached_async (GamiManager *ami,
+                                       const gchar *channel,
+                                       const gchar *variable,
+                                       const gchar *action_id,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data);
+gchar *gami_manager_getvar_cached_finish (GamiManager *ami,
+                                          GAsyncResult *result,
+                                          GError **error);
+GHashTable *gami_manager_getvar_bulk (GamiManager *ami,
+                                      const gchar **channels,
+                                      const gchar **variables,
+                                      const gchar *action_id,
+                                      GHashTable **errors,
+                                      GError **error);
+void gami_manager_getvar_bulk_async (GamiManager *ami,
+                                     const gchar **channels,
+                                     const gchar **variables,
+                                     const gchar *action_id,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+GHashTable *gami_manager_getvar_bulk_finish (GamiManager *ami,
+                                             GAsyncResult *result,
+                                             GHashTable **errors,
+                                             GError **error);
 
 gboolean gami_manager_setvar (GamiManager *ami,
                                const gchar *channel,
@@ -365,6 +493,13 @@ void gami_manager_meetme_list_async (GamiManager *ami,
 GSList *gami_manager_meetme_list_finish (GamiManager *ami,
                                          GAsyncResult *result,
                                          GError **error);
+void gami_manager_meetme_list_stream_async (GamiManager *ami,
+                                            const gchar *conference,
+                                            GamiListItemFunc func,
+                                            gpointer func_data,
+                                            const gchar *action_id,
+                                            GAsyncReadyCallback callback,
+                                            gpointer user_data);
 
 gboolean gami_manager_queue_add (GamiManager *ami,
                                  const gchar *queue,
@@ -446,6 +581,13 @@ void gami_manager_queue_summary_async (GamiManager *ami,
 GSList *gami_manager_queue_summary_finish (GamiManager *ami,
                                            GAsyncResult *result,
                                            GError **error);
+void gami_manager_queue_summary_stream_async (GamiManager *ami,
+                                              const gchar *queue,
+                                              GamiListItemFunc func,
+                                              gpointer func_data,
+                                              const gchar *action_id,
+                                              GAsyncReadyCallback callback,
+                                              gpointer user_data);
 
 gboolean gami_manager_queue_log (GamiManager *ami,
                                  const gchar *queue,
@@ -499,6 +641,17 @@ gchar *gami_manager_queues_finish (GamiManager *ami,
                                    GAsyncResult *result,
                                    GError **error);
 
+GSList *gami_manager_queues_list (GamiManager *ami,
+                                  const gchar *action_id,
+                                  GError **error);
+void gami_manager_queues_list_async (GamiManager *ami,
+                                     const gchar *action_id,
+                                     GAsyncReadyCallback callback,
+                                     gpointer user_data);
+GSList *gami_manager_queues_list_finish (GamiManager *ami,
+                                         GAsyncResult *result,
+                                         GError **error);
+
 gboolean gami_manager_zap_dial_offhook (GamiManager *ami,
                                         const gchar *zap_channel,
                                         const gchar *number,
@@ -563,6 +716,12 @@ void gami_manager_zap_show_channels_async (GamiManager *ami,
 GSList *gami_manager_zap_show_channels_finish (GamiManager *ami,
                                                GAsyncResult *result,
                                                GError **error);
+void gami_manager_zap_show_channels_stream_async (GamiManager *ami,
+                                                  GamiListItemFunc func,
+                                                  gpointer func_data,
+                                                  const gchar *action_id,
+                                                  GAsyncReadyCallback callback,
+                                                  gpointer user_data);
 
 gboolean gami_manager_zap_transfer (GamiManager *ami,
                                     const gchar *zap_channel,
@@ -654,6 +813,13 @@ void gami_manager_dahdi_show_channels_async (GamiManager *ami,
 GSList *gami_manager_dahdi_show_channels_finish (GamiManager *ami,
                                                  GAsyncResult *result,
                                                  GError **error);
+void gami_manager_dahdi_show_channels_stream_async (GamiManager *ami,
+                                                    const gchar *dahdi_channel,
+                                                    GamiListItemFunc func,
+                                                    gpointer func_data,
+                                                    const gchar *action_id,
+                                                    GAsyncReadyCallback callback,
+                                                    gpointer user_data);
 
 gboolean gami_manager_dahdi_transfer (GamiManager *ami,
                                       const gchar *dahdi_channel,
@@ -689,6 +855,12 @@ void gami_manager_agents_async (GamiManager *ami,
 GSList *gami_manager_agents_finish (GamiManager *ami,
                                     GAsyncResult *result,
                                     GError **error);
+void gami_manager_agents_stream_async (GamiManager *ami,
+                                       GamiListItemFunc func,
+                                       gpointer func_data,
+                                       const gchar *action_id,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data);
 
 gboolean gami_manager_agent_callback_login (GamiManager *ami,
 											const gchar *agent,
@@ -811,6 +983,12 @@ void gami_manager_parked_calls_async (GamiManager *ami,
 GSList *gami_manager_parked_calls_finish (GamiManager *ami,
                                           GAsyncResult *result,
                                           GError **error);
+void gami_manager_parked_calls_stream_async (GamiManager *ami,
+                                             GamiListItemFunc func,
+                                             gpointer func_data,
+                                             const gchar *action_id,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data);
 
 GSList *gami_manager_voicemail_users_list (GamiManager *ami,
 										   const gchar *action_id,
@@ -822,6 +1000,12 @@ void gami_manager_voicemail_users_list_async (GamiManager *ami,
 GSList *gami_manager_voicemail_users_list_finish (GamiManager *ami,
                                                   GAsyncResult *result,
                                                   GError **error);
+void gami_manager_voicemail_users_list_stream_async (GamiManager *ami,
+                                                     GamiListItemFunc func,
+                                                     gpointer func_data,
+                                                     const gchar *action_id,
+                                                     GAsyncReadyCallback callback,
+                                                     gpointer user_data);
 
 GHashTable *gami_manager_mailbox_count (GamiManager *ami,
                                         const gchar *mailbox,
@@ -870,6 +1054,12 @@ void gami_manager_core_show_channels_async (GamiManager *ami,
 GSList *gami_manager_core_show_channels_finish (GamiManager *ami,
                                                 GAsyncResult *result,
                                                 GError **error);
+void gami_manager_core_show_channels_stream_async (GamiManager *ami,
+                                                   GamiListItemFunc func,
+                                                   gpointer func_data,
+                                                   const gchar *action_id,
+                                                   GAsyncReadyCallback callback,
+                                                   gpointer user_data);
 
 GHashTable *gami_manager_core_settings (GamiManager *ami,
 										const gchar *action_id,
@@ -892,6 +1082,19 @@ void gami_manager_iax_peerlist_async (GamiManager *ami,
 GSList *gami_manager_iax_peerlist_finish (GamiManager *ami,
                                            GAsyncResult *result,
                                            GError **error);
+void gami_manager_iax_peerlist_stream_async (GamiManager *ami,
+                                             GamiListItemFunc func,
+                                             gpointer func_data,
+                                             const gchar *action_id,
+                                             GAsyncReadyCallback callback,
+                                             gpointer user_data);
+
+void gami_manager_iax_peers_async (GamiManager *ami,
+                                   GamiPeerEntryFunc func,
+                                   gpointer func_data,
+                                   const gchar *action_id,
+                                   GAsyncReadyCallback callback,
+                                   gpointer user_data);
 
 GSList *gami_manager_sip_peers (GamiManager *ami,
                                 const gchar *action_id,
@@ -903,6 +1106,12 @@ void gami_manager_sip_peers_async (GamiManager *ami,
 GSList *gami_manager_sip_peers_finish (GamiManager *ami,
                                        GAsyncResult *result,
                                        GError **error);
+void gami_manager_sip_peers_stream_async (GamiManager *ami,
+                                          GamiListItemFunc func,
+                                          gpointer func_data,
+                                          const gchar *action_id,
+                                          GAsyncReadyCallback callback,
+                                          gpointer user_data);
 
 GHashTable *gami_manager_sip_showpeer (GamiManager *ami,
                                         const gchar *peer,
@@ -927,6 +1136,12 @@ void gami_manager_sip_showregistry_async (GamiManager *ami,
 GSList *gami_manager_sip_showregistry_finish (GamiManager *ami,
                                                GAsyncResult *result,
                                                GError **error);
+void gami_manager_sip_showregistry_stream_async (GamiManager *ami,
+                                                 GamiListItemFunc func,
+                                                 gpointer func_data,
+                                                 const gchar *action_id,
+                                                 GAsyncReadyCallback callback,
+                                                 gpointer user_data);
 
 GSList *gami_manager_status (GamiManager *ami,
 							 const gchar *channel,
@@ -940,6 +1155,31 @@ void gami_manager_status_async (GamiManager *ami,
 GSList *gami_manager_status_finish (GamiManager *ami,
 									GAsyncResult *result,
 									GError **error);
+void gami_manager_status_stream_async (GamiManager *ami,
+                                       const gchar *channel,
+                                       GamiListItemFunc func,
+                                       gpointer func_data,
+                                       const gchar *action_id,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data);
+gint gami_manager_status_variables (GamiManager *ami,
+									const gchar *channel,
+									const gchar **variables,
+									GamiChannelStatusFunc func,
+									gpointer func_data,
+									const gchar *action_id,
+									GError **error);
+void gami_manager_status_variables_async (GamiManager *ami,
+										  const gchar *channel,
+										  const gchar **variables,
+										  GamiChannelStatusFunc func,
+										  gpointer func_data,
+										  const gchar *action_id,
+										  GAsyncReadyCallback callback,
+										  gpointer user_data);
+gint gami_manager_status_variables_finish (GamiManager *ami,
+										   GAsyncResult *result,
+										   GError **error);
 
 GHashTable *gami_manager_extension_state (GamiManager *ami,
                                           const gchar *exten,
@@ -955,6 +1195,14 @@ void gami_manager_extension_state_async (GamiManager *ami,
 GHashTable *gami_manager_extension_state_finish (GamiManager *ami,
                                                  GAsyncResult *result,
                                                  GError **error);
+void gami_manager_show_dialplan_stream_async (GamiManager *ami,
+                                              const gchar *extension,
+                                              const gchar *context,
+                                              GamiListItemFunc func,
+                                              gpointer func_data,
+                                              const gchar *action_id,
+                                              GAsyncReadyCallback callback,
+                                              gpointer user_data);
 
 gboolean gami_manager_ping (GamiManager *ami,
                             const gchar *action_id,
@@ -1088,6 +1336,13 @@ void gami_manager_command_async (GamiManager *ami,
 gchar *gami_manager_command_finish (GamiManager *ami,
                                     GAsyncResult *result,
                                     GError **error);
+void gami_manager_command_stream_async (GamiManager *ami,
+                                        const gchar *command,
+                                        GamiCommandOutputFunc func,
+                                        gpointer func_data,
+                                        const gchar *action_id,
+                                        GAsyncReadyCallback callback,
+                                        gpointer user_data);
 
 gboolean gami_manager_agi (GamiManager *ami,
                            const gchar *channel,
@@ -1203,6 +1458,32 @@ GHashTable *gami_manager_get_config_json_finish (GamiManager *ami,
                                                  GAsyncResult *result,
                                                  GError **error);
 
+GamiConfig *gami_manager_get_config_tree (GamiManager *ami,
+                                          const gchar *filename,
+                                          const gchar *action_id,
+                                          GError **error);
+void gami_manager_get_config_tree_async (GamiManager *ami,
+                                         const gchar *filename,
+                                         const gchar *action_id,
+                                         GAsyncReadyCallback callback,
+                                         gpointer user_data);
+GamiConfig *gami_manager_get_config_tree_finish (GamiManager *ami,
+                                                 GAsyncResult *result,
+                                                 GError **error);
+
+GamiConfig *gami_manager_get_config_json_tree (GamiManager *ami,
+                                               const gchar *filename,
+                                               const gchar *action_id,
+                                               GError **error);
+void gami_manager_get_config_json_tree_async (GamiManager *ami,
+                                              const gchar *filename,
+                                              const gchar *action_id,
+                                              GAsyncReadyCallback callback,
+                                              gpointer user_data);
+GamiConfig *gami_manager_get_config_json_tree_finish (GamiManager *ami,
+                                                      GAsyncResult *result,
+                                                      GError **error);
+
 gboolean gami_manager_create_config (GamiManager *ami,
                                      const gchar *filename,
 									 const gchar *action_id,
@@ -1216,6 +1497,44 @@ gboolean gami_manager_create_config_finish (GamiManager *ami,
                                             GAsyncResult *result,
                                             GError **error);
 
+gboolean gami_manager_update_config (GamiManager *ami,
+                                     const gchar *src_filename,
+                                     const gchar *dst_filename,
+                                     const GSList *changes,
+                                     const gchar *reload,
+                                     const gchar *action_id,
+                                     gint *failed_chunk,
+                                     GError **error);
+void gami_manager_update_config_async (GamiManager *ami,
+                                       const gchar *src_filename,
+                                       const gchar *dst_filename,
+                                       const GSList *changes,
+                                       const gchar *reload,
+                                       const gchar *action_id,
+                                       GAsyncReadyCallback callback,
+                                       gpointer user_data);
+gboolean gami_manager_update_config_finish (GamiManager *ami,
+                                            GAsyncResult *result,
+                                            gint *failed_chunk,
+                                            GError **error);
+
+gboolean gami_manager_apply_config (GamiManager *ami,
+                                    const gchar *filename,
+                                    GamiConfig *desired,
+                                    const gchar *module,
+                                    const gchar *action_id,
+                                    GError **error);
+void gami_manager_apply_config_async (GamiManager *ami,
+                                      const gchar *filename,
+                                      GamiConfig *desired,
+                                      const gchar *module,
+                                      const gchar *action_id,
+                                      GAsyncReadyCallback callback,
+                                      gpointer user_data);
+gboolean gami_manager_apply_config_finish (GamiManager *ami,
+                                           GAsyncResult *result,
+                                           GError **error);
+
 gboolean gami_manager_originate (GamiManager *ami,
                                  const gchar *channel,
 								 const gchar *application_exten,
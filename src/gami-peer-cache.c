@@ -0,0 +1,1034 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <config.h>
+
+#include <string.h>
+
+#include <gami-peer-cache.h>
+#include <gami-event.h>
+#include <gami-error.h>
+
+/**
+ * SECTION: libgami-peer-cache
+ * @short_description: Local copy of peer registrations
+ * @title: GamiPeerCache
+ * @stability: Unstable
+ *
+ * #GamiPeerCache is loaded using the SIPpeers and IAXpeers actions and
+ * then kept current from PeerStatus and Registry events, so that the
+ * reachability of peers can be answered without polling
+ * gami_manager_sip_peers() or gami_manager_iax_peers_async().
+ *
+ * Peers are represented by a #GHashTable with the headers of the PeerEntry
+ * event, and identified by technology and ObjectName as in the Peer header of
+ * PeerStatus events (e.g. "SIP/1000"). The Status header is updated from
+ * PeerStatus events, which are additionally stored in the PeerStatus header.
+ *
+ * To pick up peers which have been added to or removed from the
+ * configuration, the cache may be reconciled with the server periodically,
+ * see #GamiPeerCache:reconcile-interval.
+ *
+ * The manager must be logged in with a mask which includes
+ * %GAMI_EVENT_MASK_SYSTEM for the cache to receive updates.
+ */
+
+enum {
+    PROP_0,
+    PROP_MANAGER,
+    PROP_RECONCILE_INTERVAL
+};
+
+enum {
+    PEER_ADDED,
+    PEER_CHANGED,
+    PEER_REMOVED,
+    LAST_SIGNAL
+};
+
+/* technologies loaded by a refresh */
+enum {
+    TECH_SIP,
+    TECH_IAX,
+    N_TECHNOLOGIES
+};
+
+static const gchar *technologies [N_TECHNOLOGIES] = { "SIP", "IAX2" };
+
+struct _GamiPeerCachePrivate {
+    GamiManager *ami;
+
+    GHashTable  *peers;             /* Tech/ObjectName -> peer */
+    GHashTable  *by_address;        /* IPaddress -> GList of peers (not
+                                       referenced) */
+    GHashTable  *registrations;     /* Tech/Username@Domain -> registry */
+
+    guint        refreshing;
+    GHashTable  *refresh_changes;   /* peers updated during a refresh */
+
+    guint        reconcile_interval;
+    guint        reconcile_source;
+
+    GSList      *handlers;
+};
+
+typedef struct {
+    GSList *lists [N_TECHNOLOGIES];
+    GError *errors [N_TECHNOLOGIES];
+    gint    pending;
+} RefreshData;
+
+static guint signals [LAST_SIGNAL] = { 0 };
+
+#define GAMI_PEER_CACHE_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), \
+                                        GAMI_TYPE_PEER_CACHE, \
+                                        GamiPeerCachePrivate))
+
+G_DEFINE_TYPE (GamiPeerCache, gami_peer_cache, G_TYPE_OBJECT);
+
+
+static void
+set_header (GHashTable *peer, const gchar *header, const gchar *value)
+{
+    if (value)
+        g_hash_table_insert (peer, g_strdup (header), g_strdup (value));
+    else
+        g_hash_table_remove (peer, header);
+}
+
+static void
+index_address (GamiPeerCache *cache, GHashTable *peer, gboolean add)
+{
+    const gchar *address;
+    GList       *peers;
+
+    address = g_hash_table_lookup (peer, "IPaddress");
+    if (! address || ! strcmp (address, "-none-")
+        || ! strcmp (address, "(null)"))
+        return;
+
+    peers = g_hash_table_lookup (cache->priv->by_address, address);
+    if (add)
+        peers = g_list_prepend (peers, peer);
+    else
+        peers = g_list_remove (peers, peer);
+
+    if (peers)
+        g_hash_table_insert (cache->priv->by_address, g_strdup (address),
+                             peers);
+    else
+        g_hash_table_remove (cache->priv->by_address, address);
+}
+
+static void
+remove_peer (GamiPeerCache *cache, const gchar *key)
+{
+    GHashTable *peer;
+
+    peer = g_hash_table_lookup (cache->priv->peers, key);
+    if (! peer)
+        return;
+
+    g_hash_table_ref (peer);
+    index_address (cache, peer, FALSE);
+    g_hash_table_remove (cache->priv->peers, key);
+
+    g_signal_emit (cache, signals [PEER_REMOVED], 0, peer);
+    g_hash_table_unref (peer);
+}
+
+/* split "host:port" or "[host]:port" as sent in PeerStatus events */
+static void
+split_address (const gchar *address, gchar **host, gchar **port)
+{
+    const gchar *separator;
+
+    *host = *port = NULL;
+
+    if (*address == '[') {
+        separator = strchr (address, ']');
+        if (! separator)
+            return;
+        *host = g_strndup (address + 1, separator - address - 1);
+        separator = strchr (separator, ':');
+    } else {
+        separator = strrchr (address, ':');
+        *host = separator ? g_strndup (address, separator - address)
+                          : g_strdup (address);
+    }
+
+    if (separator)
+        *port = g_strdup (separator + 1);
+}
+
+static void
+on_peer_status (GamiManager *ami, GamiEvent *event, GamiPeerCache *cache)
+{
+    GHashTable  *peer;
+    const gchar *key, *status, *address, *time;
+    gboolean     added = FALSE;
+
+    key    = gami_event_get_header (event, "Peer");
+    status = gami_event_get_header (event, "PeerStatus");
+    if (! key || ! status)
+        return;
+
+    if (cache->priv->refreshing)
+        g_hash_table_replace (cache->priv->refresh_changes,
+                              g_strdup (key), GINT_TO_POINTER (TRUE));
+
+    peer = g_hash_table_lookup (cache->priv->peers, key);
+    if (! peer) {
+        const gchar *name;
+
+        name = strchr (key, '/');
+        peer = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+        set_header (peer, "Channeltype",
+                    gami_event_get_header (event, "ChannelType"));
+        set_header (peer, "ObjectName", name ? name + 1 : key);
+        g_hash_table_insert (cache->priv->peers, g_strdup (key), peer);
+        added = TRUE;
+    }
+
+    set_header (peer, "PeerStatus", status);
+
+    time = gami_event_get_header (event, "Time");
+    if (! strcmp (status, "Reachable") || ! strcmp (status, "Lagged")) {
+        gchar *value;
+
+        value = g_strdup_printf ("%s (%s ms)",
+                                 strcmp (status, "Lagged") ? "OK" : "LAGGED",
+                                 time ? time : "0");
+        set_header (peer, "Status", value);
+        g_free (value);
+    } else if (! strcmp (status, "Unreachable"))
+        set_header (peer, "Status", "UNREACHABLE");
+    else if (! strcmp (status, "Unregistered")
+             || ! strcmp (status, "Rejected"))
+        set_header (peer, "Status", "UNKNOWN");
+
+    address = gami_event_get_header (event, "Address");
+    if (address || ! strcmp (status, "Unregistered")) {
+        gchar *host = NULL, *port = NULL;
+
+        if (address)
+            split_address (address, &host, &port);
+        if (! port)
+            port = g_strdup (gami_event_get_header (event, "Port"));
+
+        index_address (cache, peer, FALSE);
+        set_header (peer, "IPaddress", host ? host : "-none-");
+        set_header (peer, "IPport", port ? port : "0");
+        index_address (cache, peer, TRUE);
+
+        g_free (host);
+        g_free (port);
+    }
+
+    g_signal_emit (cache, signals [added ? PEER_ADDED : PEER_CHANGED], 0,
+                   peer);
+}
+
+static void
+on_registry (GamiManager *ami, GamiEvent *event, GamiPeerCache *cache)
+{
+    GHashTable  *registry;
+    const gchar *type, *username, *domain;
+    gchar       *key;
+
+    type     = gami_event_get_header (event, "ChannelType");
+    username = gami_event_get_header (event, "Username");
+    domain   = gami_event_get_header (event, "Domain");
+    if (! domain)
+        return;
+
+    key = g_strdup_printf ("%s/%s@%s", type ? type : "",
+                           username ? username : "", domain);
+
+    registry = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    set_header (registry, "ChannelType", type);
+    set_header (registry, "Username", username);
+    set_header (registry, "Domain", domain);
+    set_header (registry, "Status", gami_event_get_header (event, "Status"));
+    set_header (registry, "Cause", gami_event_get_header (event, "Cause"));
+
+    g_hash_table_insert (cache->priv->registrations, key, registry);
+}
+
+static void
+on_disconnected (GamiManager *ami, GamiPeerCache *cache)
+{
+    GList *keys, *l;
+
+    keys = g_hash_table_get_keys (cache->priv->peers);
+    for (l = keys; l; l = l->next) {
+        gchar *key = g_strdup (l->data);
+
+        remove_peer (cache, key);
+        g_free (key);
+    }
+    g_list_free (keys);
+
+    g_hash_table_remove_all (cache->priv->registrations);
+}
+
+static gchar *
+peer_key (GHashTable *entry, gint tech)
+{
+    const gchar *name;
+
+    name = g_hash_table_lookup (entry, "ObjectName");
+    if (! name)
+        return NULL;
+
+    return g_strdup_printf ("%s/%s", technologies [tech], name);
+}
+
+static gboolean
+peer_has_tech (const gchar *key, gint tech)
+{
+    return g_str_has_prefix (key, technologies [tech])
+           && key [strlen (technologies [tech])] == '/';
+}
+
+static void
+copy_header (gchar *key, gchar *value, GHashTable *peer)
+{
+    /* IAX peers are listed as complete PeerEntry events */
+    if (strcmp (key, "Event"))
+        set_header (peer, key, value);
+}
+
+/* merge the peers listed for one technology into the cache */
+static void
+merge_peers (GamiPeerCache *cache, GSList *list, gint tech)
+{
+    GHashTable *listed;
+    GList      *keys, *l;
+    GSList     *entry;
+
+    listed = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+
+    for (entry = list; entry; entry = entry->next) {
+        GHashTable *peer;
+        gchar      *key;
+        gboolean    added = FALSE;
+
+        if (! (key = peer_key (entry->data, tech)))
+            continue;
+
+        g_hash_table_insert (listed, key, entry->data);
+
+        peer = g_hash_table_lookup (cache->priv->peers, key);
+        if (! peer) {
+            peer = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                          g_free, g_free);
+            g_hash_table_insert (cache->priv->peers, g_strdup (key), peer);
+            added = TRUE;
+        } else if (g_hash_table_lookup (cache->priv->refresh_changes, key))
+            continue;   /* events received during the refresh are newer */
+
+        index_address (cache, peer, FALSE);
+        g_hash_table_foreach (entry->data, (GHFunc) copy_header, peer);
+        index_address (cache, peer, TRUE);
+
+        g_signal_emit (cache, signals [added ? PEER_ADDED : PEER_CHANGED], 0,
+                       peer);
+    }
+
+    /* drop peers which have been removed from the configuration */
+    keys = g_hash_table_get_keys (cache->priv->peers);
+    for (l = keys; l; l = l->next) {
+        gchar *key = l->data;
+
+        if (! peer_has_tech (key, tech) || g_hash_table_lookup (listed, key)
+            || g_hash_table_lookup (cache->priv->refresh_changes, key))
+            continue;
+
+        key = g_strdup (key);
+        remove_peer (cache, key);
+        g_free (key);
+    }
+    g_list_free (keys);
+
+    g_hash_table_unref (listed);
+}
+
+static void
+refresh_data_free (RefreshData *data)
+{
+    gint tech;
+
+    for (tech = 0; tech < N_TECHNOLOGIES; tech++) {
+        g_slist_foreach (data->lists [tech], (GFunc) g_hash_table_unref, NULL);
+        g_slist_free (data->lists [tech]);
+        if (data->errors [tech])
+            g_error_free (data->errors [tech]);
+    }
+    g_free (data);
+}
+
+static void
+refresh_complete (GSimpleAsyncResult *simple)
+{
+    GamiPeerCache *cache;
+    RefreshData   *data;
+    gint           tech;
+    gboolean       success = FALSE;
+
+    cache = GAMI_PEER_CACHE (g_async_result_get_source_object
+                             (G_ASYNC_RESULT (simple)));
+    data = g_object_get_data (G_OBJECT (simple), "refresh-data");
+
+    /* a technology may not be loaded on the server, only fail if no list
+     * could be retrieved at all */
+    for (tech = 0; tech < N_TECHNOLOGIES; tech++) {
+        if (data->errors [tech])
+            continue;
+
+        merge_peers (cache, data->lists [tech], tech);
+        success = TRUE;
+    }
+
+    if (! success)
+        g_simple_async_result_set_from_error (simple, data->errors [TECH_SIP]);
+
+    if (--cache->priv->refreshing == 0)
+        g_hash_table_remove_all (cache->priv->refresh_changes);
+
+    g_simple_async_result_set_op_res_gboolean (simple, success);
+    g_simple_async_result_complete (simple);
+
+    g_object_unref (simple);
+    g_object_unref (cache);
+}
+
+static void
+store_list (GSimpleAsyncResult *simple, GSList *list, gint tech)
+{
+    RefreshData *data;
+
+    data = g_object_get_data (G_OBJECT (simple), "refresh-data");
+
+    data->lists [tech] = g_slist_copy (list);
+    g_slist_foreach (data->lists [tech], (GFunc) g_hash_table_ref, NULL);
+
+    if (--data->pending == 0)
+        refresh_complete (simple);
+}
+
+static void
+sip_peers_cb (GamiManager *ami, GAsyncResult *result, gpointer user_data)
+{
+    GSimpleAsyncResult *simple = user_data;
+    RefreshData        *data;
+    GSList             *list;
+
+    data = g_object_get_data (G_OBJECT (simple), "refresh-data");
+    list = gami_manager_sip_peers_finish (ami, result,
+                                          &data->errors [TECH_SIP]);
+    store_list (simple, list, TECH_SIP);
+}
+
+static gboolean
+iax_peer_cb (GamiManager *ami, GamiPeerEntryEvent *peer, gpointer user_data)
+{
+    RefreshData *data;
+
+    data = g_object_get_data (G_OBJECT (user_data), "refresh-data");
+    data->lists [TECH_IAX] =
+        g_slist_prepend (data->lists [TECH_IAX],
+                         g_hash_table_ref (gami_event_get_headers
+                                           ((GamiEvent *) peer)));
+    return TRUE;
+}
+
+static void
+iax_peers_cb (GamiManager *ami, GAsyncResult *result, gpointer user_data)
+{
+    GSimpleAsyncResult *simple = user_data;
+    RefreshData        *data;
+
+    data = g_object_get_data (G_OBJECT (simple), "refresh-data");
+    gami_manager_list_stream_finish (ami, result, &data->errors [TECH_IAX]);
+
+    if (--data->pending == 0)
+        refresh_complete (simple);
+}
+
+static void
+reconcile_done (GamiPeerCache *cache, GAsyncResult *result, gpointer data)
+{
+    GError *error = NULL;
+
+    if (! gami_peer_cache_refresh_finish (cache, result, &error)) {
+        g_warning ("Failed to reconcile peer cache: %s", error->message);
+        g_error_free (error);
+    }
+}
+
+static gboolean
+reconcile_timeout (GamiPeerCache *cache)
+{
+    if (! cache->priv->refreshing)
+        gami_peer_cache_refresh_async (cache,
+                                       (GAsyncReadyCallback) reconcile_done,
+                                       NULL);
+
+    return TRUE;
+}
+
+static void
+set_reconcile_interval (GamiPeerCache *cache, guint interval)
+{
+    if (cache->priv->reconcile_source) {
+        g_source_remove (cache->priv->reconcile_source);
+        cache->priv->reconcile_source = 0;
+    }
+
+    cache->priv->reconcile_interval = interval;
+
+    if (interval)
+        cache->priv->reconcile_source =
+            g_timeout_add_seconds (interval,
+                                   (GSourceFunc) reconcile_timeout,
+                                   cache);
+}
+
+static void
+store_result (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    *(GAsyncResult **) user_data = g_object_ref (result);
+}
+
+static void
+connect_event (GamiPeerCache *cache, const gchar *signal, GCallback func)
+{
+    gulong id;
+
+    id = g_signal_connect (cache->priv->ami, signal, func, cache);
+    cache->priv->handlers = g_slist_prepend (cache->priv->handlers,
+                                             GSIZE_TO_POINTER (id));
+}
+
+/**
+ * gami_peer_cache_new:
+ * @ami: a #GamiManager
+ *
+ * Create a new peer cache for the server @ami is connected to. The cache is
+ * updated from events immediately, but will only include peers which did not
+ * change their status since its creation after gami_peer_cache_refresh() has
+ * been called.
+ *
+ * Returns: a new #GamiPeerCache
+ */
+GamiPeerCache *
+gami_peer_cache_new (GamiManager *ami)
+{
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), NULL);
+
+    return g_object_new (GAMI_TYPE_PEER_CACHE, "manager", ami, NULL);
+}
+
+/**
+ * gami_peer_cache_refresh:
+ * @cache: #GamiPeerCache
+ * @error: a #GError, or %NULL
+ *
+ * Load the SIP and IAX peers configured on the server into @cache, and remove
+ * peers which are no longer configured. Technologies which are not available
+ * on the server are skipped.
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_peer_cache_refresh (GamiPeerCache *cache, GError **error)
+{
+    GAsyncResult *result = NULL;
+    gboolean      success;
+
+    gami_peer_cache_refresh_async (cache, store_result, &result);
+
+    while (! result)
+        g_main_context_iteration (NULL, TRUE);
+
+    success = gami_peer_cache_refresh_finish (cache, result, error);
+    g_object_unref (result);
+
+    return success;
+}
+
+/**
+ * gami_peer_cache_refresh_async:
+ * @cache: #GamiPeerCache
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Asynchronously load the peers configured on the server into @cache, see
+ * gami_peer_cache_refresh().
+ */
+void
+gami_peer_cache_refresh_async (GamiPeerCache *cache,
+                               GAsyncReadyCallback callback,
+                               gpointer user_data)
+{
+    GSimpleAsyncResult *simple;
+    RefreshData        *data;
+
+    g_return_if_fail (GAMI_IS_PEER_CACHE (cache));
+
+    simple = g_simple_async_result_new (G_OBJECT (cache),
+                                        callback,
+                                        user_data,
+                                        gami_peer_cache_refresh_async);
+    data = g_new0 (RefreshData, 1);
+    data->pending = N_TECHNOLOGIES;
+    g_object_set_data_full (G_OBJECT (simple), "refresh-data",
+                            data,
+                            (GDestroyNotify) refresh_data_free);
+
+    cache->priv->refreshing++;
+
+    /* both lists are requested at once, responses are told apart by their
+     * ActionID */
+    gami_manager_sip_peers_async (cache->priv->ami,
+                                  NULL,
+                                  (GAsyncReadyCallback) sip_peers_cb,
+                                  simple);
+    gami_manager_iax_peers_async (cache->priv->ami,
+                                  iax_peer_cb,
+                                  simple,
+                                  NULL,
+                                  (GAsyncReadyCallback) iax_peers_cb,
+                                  simple);
+}
+
+/**
+ * gami_peer_cache_refresh_finish:
+ * @cache: #GamiPeerCache
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous operation started with
+ * gami_peer_cache_refresh_async()
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_peer_cache_refresh_finish (GamiPeerCache *cache,
+                                GAsyncResult *result,
+                                GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), FALSE);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+
+    g_warn_if_fail (g_simple_async_result_get_source_tag (simple)
+                    == gami_peer_cache_refresh_async);
+
+    if (g_simple_async_result_propagate_error (simple, error))
+        return FALSE;
+
+    return g_simple_async_result_get_op_res_gboolean (simple);
+}
+
+/**
+ * gami_peer_cache_lookup:
+ * @cache: #GamiPeerCache
+ * @peer: technology and name of a peer, e.g. "SIP/1000"
+ *
+ * Look up a peer. The returned table is owned by @cache and must not be
+ * modified.
+ *
+ * Returns: the peer (stored as #GHashTable), or %NULL
+ */
+GHashTable *
+gami_peer_cache_lookup (GamiPeerCache *cache, const gchar *peer)
+{
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), NULL);
+    g_return_val_if_fail (peer != NULL, NULL);
+
+    return g_hash_table_lookup (cache->priv->peers, peer);
+}
+
+/**
+ * gami_peer_cache_lookup_by_address:
+ * @cache: #GamiPeerCache
+ * @address: an IP address
+ *
+ * Look up the peers registered from @address. The list must be freed with
+ * g_list_free(), the peers are owned by @cache.
+ *
+ * Returns: #GList of peers (stored as #GHashTable)
+ */
+GList *
+gami_peer_cache_lookup_by_address (GamiPeerCache *cache,
+                                   const gchar *address)
+{
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), NULL);
+    g_return_val_if_fail (address != NULL, NULL);
+
+    return g_list_copy (g_hash_table_lookup (cache->priv->by_address,
+                                             address));
+}
+
+static gboolean
+peer_is_reachable (GHashTable *peer)
+{
+    const gchar *status, *address;
+
+    status = g_hash_table_lookup (peer, "Status");
+    if (! status)
+        return FALSE;
+
+    if (g_str_has_prefix (status, "OK") || g_str_has_prefix (status, "LAGGED"))
+        return TRUE;
+
+    /* peers which are not qualified are considered reachable as long as
+     * their address is known */
+    if (g_str_has_prefix (status, "Unmonitored")) {
+        address = g_hash_table_lookup (peer, "IPaddress");
+        return address && strcmp (address, "-none-")
+               && strcmp (address, "(null)");
+    }
+
+    return FALSE;
+}
+
+/**
+ * gami_peer_cache_is_reachable:
+ * @cache: #GamiPeerCache
+ * @peer: technology and name of a peer, e.g. "SIP/1000"
+ *
+ * Check whether @peer is reachable. Qualified peers are reachable if the
+ * server received a response to its last qualify request, peers which are
+ * not qualified if they have a known address.
+ *
+ * Returns: %TRUE if @peer is known and reachable
+ */
+gboolean
+gami_peer_cache_is_reachable (GamiPeerCache *cache, const gchar *peer)
+{
+    GHashTable *entry;
+
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), FALSE);
+    g_return_val_if_fail (peer != NULL, FALSE);
+
+    entry = g_hash_table_lookup (cache->priv->peers, peer);
+    return entry && peer_is_reachable (entry);
+}
+
+/**
+ * gami_peer_cache_get_peers:
+ * @cache: #GamiPeerCache
+ *
+ * Get all peers in @cache. The list must be freed with g_list_free(), the
+ * peers are owned by @cache.
+ *
+ * Returns: #GList of peers (stored as #GHashTable)
+ */
+GList *
+gami_peer_cache_get_peers (GamiPeerCache *cache)
+{
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), NULL);
+
+    return g_hash_table_get_values (cache->priv->peers);
+}
+
+/**
+ * gami_peer_cache_get_unreachable:
+ * @cache: #GamiPeerCache
+ *
+ * Get all peers in @cache which are not reachable, see
+ * gami_peer_cache_is_reachable(). The list must be freed with g_list_free(),
+ * the peers are owned by @cache.
+ *
+ * Returns: #GList of peers (stored as #GHashTable)
+ */
+GList *
+gami_peer_cache_get_unreachable (GamiPeerCache *cache)
+{
+    GHashTableIter  iter;
+    GHashTable     *peer;
+    GList          *unreachable = NULL;
+
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), NULL);
+
+    g_hash_table_iter_init (&iter, cache->priv->peers);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &peer))
+        if (! peer_is_reachable (peer))
+            unreachable = g_list_prepend (unreachable, peer);
+
+    return unreachable;
+}
+
+/**
+ * gami_peer_cache_get_registrations:
+ * @cache: #GamiPeerCache
+ *
+ * Get the state of outbound registrations as reported by Registry events
+ * since the creation of @cache. The list must be freed with g_list_free(),
+ * the registrations are owned by @cache.
+ *
+ * Returns: #GList of registrations (stored as #GHashTable)
+ */
+GList *
+gami_peer_cache_get_registrations (GamiPeerCache *cache)
+{
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), NULL);
+
+    return g_hash_table_get_values (cache->priv->registrations);
+}
+
+/**
+ * gami_peer_cache_get_size:
+ * @cache: #GamiPeerCache
+ *
+ * Get the number of peers in @cache.
+ *
+ * Returns: the number of peers
+ */
+guint
+gami_peer_cache_get_size (GamiPeerCache *cache)
+{
+    g_return_val_if_fail (GAMI_IS_PEER_CACHE (cache), 0);
+
+    return g_hash_table_size (cache->priv->peers);
+}
+
+static void
+gami_peer_cache_init (GamiPeerCache *cache)
+{
+    cache->priv = GAMI_PEER_CACHE_GET_PRIVATE (cache);
+
+    cache->priv->peers =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free, (GDestroyNotify) g_hash_table_unref);
+    cache->priv->by_address = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                     g_free, NULL);
+    cache->priv->registrations =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free, (GDestroyNotify) g_hash_table_unref);
+    cache->priv->refresh_changes = g_hash_table_new_full (g_str_hash,
+                                                          g_str_equal,
+                                                          g_free, NULL);
+}
+
+static void
+gami_peer_cache_constructed (GObject *object)
+{
+    GamiPeerCache *cache = GAMI_PEER_CACHE (object);
+
+    connect_event (cache, "typed-event::PeerStatus",
+                   G_CALLBACK (on_peer_status));
+    connect_event (cache, "typed-event::Registry", G_CALLBACK (on_registry));
+    connect_event (cache, "disconnected", G_CALLBACK (on_disconnected));
+
+    if (G_OBJECT_CLASS (gami_peer_cache_parent_class)->constructed)
+        G_OBJECT_CLASS (gami_peer_cache_parent_class)->constructed (object);
+}
+
+static void
+gami_peer_cache_dispose (GObject *object)
+{
+    GamiPeerCache *cache = GAMI_PEER_CACHE (object);
+    GSList        *handler;
+
+    set_reconcile_interval (cache, 0);
+
+    if (cache->priv->ami) {
+        for (handler = cache->priv->handlers; handler; handler = handler->next)
+            g_signal_handler_disconnect (cache->priv->ami,
+                                         GPOINTER_TO_SIZE (handler->data));
+        g_slist_free (cache->priv->handlers);
+        cache->priv->handlers = NULL;
+
+        g_object_unref (cache->priv->ami);
+        cache->priv->ami = NULL;
+    }
+
+    G_OBJECT_CLASS (gami_peer_cache_parent_class)->dispose (object);
+}
+
+static void
+free_peer_list (gchar *address, GList *peers, gpointer data)
+{
+    g_list_free (peers);
+}
+
+static void
+gami_peer_cache_finalize (GObject *object)
+{
+    GamiPeerCache *cache = GAMI_PEER_CACHE (object);
+
+    g_hash_table_foreach (cache->priv->by_address, (GHFunc) free_peer_list,
+                          NULL);
+    g_hash_table_unref (cache->priv->by_address);
+    g_hash_table_unref (cache->priv->peers);
+    g_hash_table_unref (cache->priv->registrations);
+    g_hash_table_unref (cache->priv->refresh_changes);
+
+    G_OBJECT_CLASS (gami_peer_cache_parent_class)->finalize (object);
+}
+
+static void
+gami_peer_cache_set_property (GObject *object,
+                              guint prop_id,
+                              const GValue *value,
+                              GParamSpec *pspec)
+{
+    GamiPeerCache *cache = GAMI_PEER_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            cache->priv->ami = g_value_dup_object (value);
+            break;
+        case PROP_RECONCILE_INTERVAL:
+            set_reconcile_interval (cache, g_value_get_uint (value));
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_peer_cache_get_property (GObject *object,
+                              guint prop_id,
+                              GValue *value,
+                              GParamSpec *pspec)
+{
+    GamiPeerCache *cache = GAMI_PEER_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            g_value_set_object (value, cache->priv->ami);
+            break;
+        case PROP_RECONCILE_INTERVAL:
+            g_value_set_uint (value, cache->priv->reconcile_interval);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_peer_cache_class_init (GamiPeerCacheClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (klass, sizeof (GamiPeerCachePrivate));
+
+    object_class->set_property = gami_peer_cache_set_property;
+    object_class->get_property = gami_peer_cache_get_property;
+    object_class->constructed  = gami_peer_cache_constructed;
+    object_class->dispose      = gami_peer_cache_dispose;
+    object_class->finalize     = gami_peer_cache_finalize;
+
+    /**
+     * GamiPeerCache:manager:
+     *
+     * The #GamiManager the cache receives events from
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_MANAGER,
+                                     g_param_spec_object ("manager",
+                                                          "Manager",
+                                                          "The manager the "
+                                                          "cache is attached "
+                                                          "to",
+                                                          GAMI_TYPE_MANAGER,
+                                                          G_PARAM_CONSTRUCT_ONLY
+                                                          | G_PARAM_READWRITE));
+
+    /**
+     * GamiPeerCache:reconcile-interval:
+     *
+     * Interval in seconds in which the cache is reconciled with the server
+     * in the background, or 0 to disable reconciliation
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_RECONCILE_INTERVAL,
+                                     g_param_spec_uint ("reconcile_interval",
+                                                        "ReconcileInterval",
+                                                        "Reconciliation "
+                                                        "interval in seconds",
+                                                        0,
+                                                        G_MAXUINT,
+                                                        0,
+                                                        G_PARAM_READWRITE));
+
+    /**
+     * GamiPeerCache::peer-added:
+     * @cache: The #GamiPeerCache that received the signal
+     * @peer: The peer (stored as #GHashTable)
+     *
+     * The ::peer-added signal is emitted when a peer is added to the cache
+     */
+    signals [PEER_ADDED] = g_signal_new ("peer-added",
+                                         G_TYPE_FROM_CLASS (object_class),
+                                         G_SIGNAL_RUN_LAST,
+                                         0,
+                                         NULL,
+                                         NULL,
+                                         g_cclosure_marshal_VOID__BOXED,
+                                         G_TYPE_NONE,
+                                         1, G_TYPE_HASH_TABLE);
+
+    /**
+     * GamiPeerCache::peer-changed:
+     * @cache: The #GamiPeerCache that received the signal
+     * @peer: The peer (stored as #GHashTable)
+     *
+     * The ::peer-changed signal is emitted when the status or address of a
+     * peer changed
+     */
+    signals [PEER_CHANGED] = g_signal_new ("peer-changed",
+                                           G_TYPE_FROM_CLASS (object_class),
+                                           G_SIGNAL_RUN_LAST,
+                                           0,
+                                           NULL,
+                                           NULL,
+                                           g_cclosure_marshal_VOID__BOXED,
+                                           G_TYPE_NONE,
+                                           1, G_TYPE_HASH_TABLE);
+
+    /**
+     * GamiPeerCache::peer-removed:
+     * @cache: The #GamiPeerCache that received the signal
+     * @peer: The peer (stored as #GHashTable)
+     *
+     * The ::peer-removed signal is emitted when a peer has been removed from
+     * the configuration of the server
+     */
+    signals [PEER_REMOVED] = g_signal_new ("peer-removed",
+                                           G_TYPE_FROM_CLASS (object_class),
+                                           G_SIGNAL_RUN_LAST,
+                                           0,
+                                           NULL,
+                                           NULL,
+                                           g_cclosure_marshal_VOID__BOXED,
+                                           G_TYPE_NONE,
+                                           1, G_TYPE_HASH_TABLE);
+}
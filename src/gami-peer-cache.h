@@ -0,0 +1,158 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)
+#  error "Only <gami.h> can be included directly."
+#endif
+
+#ifndef __GAMI_PEER_CACHE_H__
+#define __GAMI_PEER_CACHE_H__
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#ifdef GAMI_COMPILATION
+#  include <gami-manager.h>
+#else
+#  include <gami/gami-manager.h>
+#endif
+
+G_BEGIN_DECLS
+
+/**
+ * GAMI_TYPE_PEER_CACHE:
+ *
+ * Get the #GType of #GamiPeerCache
+ *
+ * Returns: The #GType of #GamiPeerCache
+ */
+#define GAMI_TYPE_PEER_CACHE  (gami_peer_cache_get_type ())
+/**
+ * GAMI_PEER_CACHE:
+ * @object: Object which is subject to casting
+ *
+ * Cast a #GamiPeerCache derived pointer into a (GamiPeerCache *) pointer
+ */
+#define GAMI_PEER_CACHE(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), \
+									GAMI_TYPE_PEER_CACHE, \
+									GamiPeerCache))
+/**
+ * GAMI_PEER_CACHE_CLASS:
+ * @klass: a valid #GamiPeerCacheClass
+ *
+ * Cast a derived #GamiPeerCacheClass structure into a
+ * #GamiPeerCacheClass structure
+ */
+#define GAMI_PEER_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), \
+									GAMI_TYPE_PEER_CACHE, \
+									GamiPeerCacheClass))
+/**
+ * GAMI_IS_PEER_CACHE:
+ * @object: Instance to check for being a %GAMI_TYPE_PEER_CACHE
+ *
+ * Check whether a valid #GTypeInstance pointer is of type
+ * %GAMI_TYPE_PEER_CACHE
+ *
+ * Returns: %FALSE or %TRUE, indicating whether @object is a
+ *          %GAMI_TYPE_PEER_CACHE
+ */
+#define GAMI_IS_PEER_CACHE(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), \
+									GAMI_TYPE_PEER_CACHE))
+/**
+ * GAMI_IS_PEER_CACHE_CLASS:
+ * @klass: a #GamiPeerCacheClass
+ *
+ * Check whether @klass is a #GamiPeerCacheClass
+ *
+ * Returns: %FALSE or %TRUE
+ */
+#define GAMI_IS_PEER_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), \
+									GAMI_TYPE_PEER_CACHE))
+/**
+ * GAMI_PEER_CACHE_GET_CLASS:
+ * @object: a #GamiPeerCache instance
+ *
+ * Get the class structure associated to a #GamiPeerCache instance.
+ *
+ * Returns: pointer to object class structure
+ */
+#define GAMI_PEER_CACHE_GET_CLASS(object) (G_TYPE_INSTANCE_GET_CLASS ((object), \
+									GAMI_TYPE_PEER_CACHE, \
+									GamiPeerCacheClass))
+
+/**
+ * GamiPeerCache:
+ * @parent_instance: #GObject parent instance
+ *
+ * #GamiPeerCache keeps a local copy of the SIP and IAX peers and their
+ * reachability on the server of a #GamiManager.
+ */
+typedef struct _GamiPeerCache GamiPeerCache;
+
+typedef struct _GamiPeerCachePrivate GamiPeerCachePrivate;
+
+/**
+ * GamiPeerCacheClass:
+ * @parent_class: #GamiPeerCache's parent class (of type #GObjectClass)
+ *
+ * The class structure for the #GamiPeerCache type
+ */
+typedef struct _GamiPeerCacheClass GamiPeerCacheClass;
+
+struct _GamiPeerCache
+{
+	GObject parent_instance;
+	GamiPeerCachePrivate *priv;
+};
+
+struct _GamiPeerCacheClass
+{
+	GObjectClass parent_class;
+};
+
+GType gami_peer_cache_get_type (void) G_GNUC_CONST;
+
+GamiPeerCache *gami_peer_cache_new (GamiManager *ami);
+
+gboolean gami_peer_cache_refresh (GamiPeerCache *cache,
+								  GError **error);
+void gami_peer_cache_refresh_async (GamiPeerCache *cache,
+									GAsyncReadyCallback callback,
+									gpointer user_data);
+gboolean gami_peer_cache_refresh_finish (GamiPeerCache *cache,
+										 GAsyncResult *result,
+										 GError **error);
+
+GHashTable *gami_peer_cache_lookup (GamiPeerCache *cache,
+									const gchar *peer);
+GList *gami_peer_cache_lookup_by_address (GamiPeerCache *cache,
+										  const gchar *address);
+gboolean gami_peer_cache_is_reachable (GamiPeerCache *cache,
+									   const gchar *peer);
+GList *gami_peer_cache_get_peers (GamiPeerCache *cache);
+GList *gami_peer_cache_get_unreachable (GamiPeerCache *cache);
+GList *gami_peer_cache_get_registrations (GamiPeerCache *cache);
+guint gami_peer_cache_get_size (GamiPeerCache *cache);
+
+G_END_DECLS
+
+#endif /* __GAMI_PEER_CACHE_H__ */
@@ -0,0 +1,944 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <gami-queue-cache.h>
+#include <gami-manager-types.h>
+#include <gami-event.h>
+
+/**
+ * SECTION: libgami-queue-cache
+ * @short_description: Local copy of queue state
+ * @title: GamiQueueCache
+ * @stability: Unstable
+ *
+ * #GamiQueueCache is seeded using the QueueStatus action and then kept
+ * current from QueueMemberAdded, QueueMemberRemoved, QueueMemberPaused,
+ * QueueMemberStatus, Join, Leave and QueueCallerAbandon events, so that
+ * applications do not need to poll gami_manager_queue_status().
+ *
+ * Queue parameters, members and waiting callers are represented by
+ * #GHashTable<!-- -->s with the headers of the corresponding QueueParams,
+ * QueueMember and QueueEntry events. gami_queue_cache_get_summary() computes
+ * the values returned by the QueueSummary action locally.
+ *
+ * The manager must be logged in with a mask which includes
+ * %GAMI_EVENT_MASK_AGENT and %GAMI_EVENT_MASK_CALL for the cache to receive
+ * updates.
+ */
+
+enum {
+    PROP_0,
+    PROP_MANAGER
+};
+
+enum {
+    QUEUE_CHANGED,
+    LAST_SIGNAL
+};
+
+/* device states as reported in the Status header of queue members */
+enum {
+    DEVICE_UNKNOWN     = 0,
+    DEVICE_NOT_INUSE   = 1,
+    DEVICE_INVALID     = 4,
+    DEVICE_UNAVAILABLE = 5
+};
+
+typedef struct {
+    GHashTable *params;
+    GHashTable *members;            /* Location -> member */
+    GQueue     *callers;            /* QueueCaller, ordered by position */
+    GHashTable *callers_by_id;      /* Uniqueid -> link in callers */
+} CachedQueue;
+
+typedef struct {
+    GHashTable *headers;
+    gint64      joined;
+} QueueCaller;
+
+struct _GamiQueueCachePrivate {
+    GamiManager *ami;
+
+    GHashTable  *queues;            /* name -> CachedQueue */
+
+    GSList      *handlers;
+};
+
+static guint signals [LAST_SIGNAL] = { 0 };
+
+#define GAMI_QUEUE_CACHE_GET_PRIVATE(o) (G_TYPE_INSTANCE_GET_PRIVATE ((o), \
+                                         GAMI_TYPE_QUEUE_CACHE, \
+                                         GamiQueueCachePrivate))
+
+G_DEFINE_TYPE (GamiQueueCache, gami_queue_cache, G_TYPE_OBJECT);
+
+static gint64
+current_time (void)
+{
+    GTimeVal now;
+
+    g_get_current_time (&now);
+    return (gint64) now.tv_sec * G_USEC_PER_SEC + now.tv_usec;
+}
+
+static void
+copy_header (gchar *key, gchar *value, GHashTable *copy)
+{
+    if (! strcmp (key, "Event") || ! strcmp (key, "Privilege")
+        || ! strcmp (key, "ActionID") || ! strcmp (key, "Timestamp"))
+        return;
+
+    g_hash_table_insert (copy, g_strdup (key), g_strdup (value));
+}
+
+/* copy the headers of an event, leaving out those which are not state */
+static GHashTable *
+copy_headers (GHashTable *headers)
+{
+    GHashTable *copy;
+
+    copy = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    g_hash_table_foreach (headers, (GHFunc) copy_header, copy);
+
+    return copy;
+}
+
+static void
+queue_caller_free (QueueCaller *caller)
+{
+    g_hash_table_unref (caller->headers);
+    g_free (caller);
+}
+
+static CachedQueue *
+cached_queue_new (GHashTable *params)
+{
+    CachedQueue *queue;
+
+    queue = g_new0 (CachedQueue, 1);
+    queue->params  = params;
+    queue->members = g_hash_table_new_full (g_str_hash, g_str_equal, g_free,
+                                            (GDestroyNotify) g_hash_table_unref);
+    queue->callers = g_queue_new ();
+    queue->callers_by_id = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                                  g_free, NULL);
+
+    return queue;
+}
+
+static void
+cached_queue_free (CachedQueue *queue)
+{
+    g_hash_table_unref (queue->params);
+    g_hash_table_unref (queue->members);
+    g_queue_foreach (queue->callers, (GFunc) queue_caller_free, NULL);
+    g_queue_free (queue->callers);
+    g_hash_table_unref (queue->callers_by_id);
+    g_free (queue);
+}
+
+static CachedQueue *
+lookup_queue (GamiQueueCache *cache, const gchar *name, gboolean create)
+{
+    CachedQueue *queue;
+
+    if (! name)
+        return NULL;
+
+    queue = g_hash_table_lookup (cache->priv->queues, name);
+    if (! queue && create) {
+        GHashTable *params;
+
+        params = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                        g_free, g_free);
+        g_hash_table_insert (params, g_strdup ("Queue"), g_strdup (name));
+
+        queue = cached_queue_new (params);
+        g_hash_table_insert (cache->priv->queues, g_strdup (name), queue);
+    }
+
+    return queue;
+}
+
+/* members are identified by Location, newer servers call it Interface */
+static const gchar *
+member_location (GHashTable *headers)
+{
+    const gchar *location;
+
+    location = g_hash_table_lookup (headers, "Location");
+    if (! location)
+        location = g_hash_table_lookup (headers, "Interface");
+
+    return location;
+}
+
+static void
+update_caller_count (CachedQueue *queue)
+{
+    GList *link;
+    gint   position = 1;
+
+    for (link = queue->callers->head; link; link = link->next) {
+        QueueCaller *caller = link->data;
+
+        g_hash_table_insert (caller->headers, g_strdup ("Position"),
+                             g_strdup_printf ("%d", position++));
+    }
+
+    g_hash_table_insert (queue->params, g_strdup ("Calls"),
+                         g_strdup_printf ("%u", queue->callers->length));
+}
+
+static void
+add_caller (CachedQueue *queue, GHashTable *headers, gint64 joined)
+{
+    QueueCaller *caller;
+    const gchar *uniqueid;
+    const gchar *position;
+    GList       *link;
+    gint         index = -1;
+
+    uniqueid = g_hash_table_lookup (headers, "Uniqueid");
+    if (! uniqueid)
+        return;
+
+    /* a caller only waits once per queue */
+    if ((link = g_hash_table_lookup (queue->callers_by_id, uniqueid))) {
+        queue_caller_free (link->data);
+        g_queue_delete_link (queue->callers, link);
+    }
+
+    caller = g_new0 (QueueCaller, 1);
+    caller->headers = headers;
+    caller->joined  = joined;
+
+    position = g_hash_table_lookup (headers, "Position");
+    if (position)
+        index = atoi (position) - 1;
+
+    if (index < 0 || index >= (gint) queue->callers->length)
+        g_queue_push_tail (queue->callers, caller);
+    else
+        g_queue_push_nth (queue->callers, caller, index);
+
+    g_hash_table_insert (queue->callers_by_id, g_strdup (uniqueid),
+                         g_queue_find (queue->callers, caller));
+
+    update_caller_count (queue);
+}
+
+static gboolean
+remove_caller (CachedQueue *queue, const gchar *uniqueid)
+{
+    GList *link;
+
+    if (! uniqueid)
+        return FALSE;
+
+    link = g_hash_table_lookup (queue->callers_by_id, uniqueid);
+    if (! link)
+        return FALSE;
+
+    g_hash_table_remove (queue->callers_by_id, uniqueid);
+    queue_caller_free (link->data);
+    g_queue_delete_link (queue->callers, link);
+
+    update_caller_count (queue);
+
+    return TRUE;
+}
+
+static void
+queue_changed (GamiQueueCache *cache, const gchar *queue)
+{
+    g_signal_emit (cache, signals [QUEUE_CHANGED],
+                   g_quark_from_string (queue), queue);
+}
+
+static void
+on_member_added (GamiManager *ami, GamiEvent *event, GamiQueueCache *cache)
+{
+    CachedQueue *queue;
+    const gchar *name, *location;
+
+    name = gami_event_get_header (event, "Queue");
+    location = member_location (event->headers);
+    if (! (queue = lookup_queue (cache, name, TRUE)) || ! location)
+        return;
+
+    g_hash_table_insert (queue->members, g_strdup (location),
+                         copy_headers (event->headers));
+    queue_changed (cache, name);
+}
+
+static void
+on_member_removed (GamiManager *ami, GamiEvent *event, GamiQueueCache *cache)
+{
+    CachedQueue *queue;
+    const gchar *name, *location;
+
+    name = gami_event_get_header (event, "Queue");
+    location = member_location (event->headers);
+    if (! (queue = lookup_queue (cache, name, FALSE)) || ! location)
+        return;
+
+    if (g_hash_table_remove (queue->members, location))
+        queue_changed (cache, name);
+}
+
+static void
+on_member_update (GamiManager *ami, GamiEvent *event, GamiQueueCache *cache)
+{
+    CachedQueue *queue;
+    GHashTable  *member;
+    const gchar *name, *location;
+
+    name = gami_event_get_header (event, "Queue");
+    location = member_location (event->headers);
+    if (! (queue = lookup_queue (cache, name, TRUE)) || ! location)
+        return;
+
+    member = g_hash_table_lookup (queue->members, location);
+    if (! member) {
+        member = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                        g_free, g_free);
+        g_hash_table_insert (queue->members, g_strdup (location), member);
+    }
+
+    /* QueueMemberPaused only carries a subset of the member headers */
+    g_hash_table_foreach (event->headers, (GHFunc) copy_header, member);
+    queue_changed (cache, name);
+}
+
+static void
+on_join (GamiManager *ami, GamiEvent *event, GamiQueueCache *cache)
+{
+    CachedQueue *queue;
+    const gchar *name;
+
+    name = gami_event_get_header (event, "Queue");
+    if (! (queue = lookup_queue (cache, name, TRUE)))
+        return;
+
+    add_caller (queue, copy_headers (event->headers), current_time ());
+    queue_changed (cache, name);
+}
+
+static void
+on_leave (GamiManager *ami, GamiEvent *event, GamiQueueCache *cache)
+{
+    CachedQueue *queue;
+    const gchar *name;
+
+    name = gami_event_get_header (event, "Queue");
+    if (! (queue = lookup_queue (cache, name, FALSE)))
+        return;
+
+    if (remove_caller (queue, gami_event_get_header (event, "Uniqueid")))
+        queue_changed (cache, name);
+}
+
+static void
+on_caller_abandon (GamiManager *ami, GamiEvent *event, GamiQueueCache *cache)
+{
+    CachedQueue *queue;
+    const gchar *name, *abandoned;
+
+    name = gami_event_get_header (event, "Queue");
+    if (! (queue = lookup_queue (cache, name, FALSE)))
+        return;
+
+    abandoned = g_hash_table_lookup (queue->params, "Abandoned");
+    g_hash_table_insert (queue->params, g_strdup ("Abandoned"),
+                         g_strdup_printf ("%d",
+                                          abandoned ? atoi (abandoned) + 1
+                                                    : 1));
+
+    remove_caller (queue, gami_event_get_header (event, "Uniqueid"));
+    queue_changed (cache, name);
+}
+
+static void
+on_disconnected (GamiManager *ami, GamiQueueCache *cache)
+{
+    g_hash_table_remove_all (cache->priv->queues);
+}
+
+/* replace the cached state with the result of QueueStatus */
+static void
+merge_queues (GamiQueueCache *cache, GSList *list)
+{
+    GSList *entry;
+    GList  *names, *name;
+    gint64  now;
+
+    now = current_time ();
+
+    names = g_hash_table_get_keys (cache->priv->queues);
+    for (name = names; name; name = name->next)
+        name->data = g_strdup (name->data);
+    g_hash_table_remove_all (cache->priv->queues);
+
+    for (entry = list; entry; entry = entry->next) {
+        CachedQueue *queue;
+        GHashTable  *params;
+        guint        n_members, i;
+
+        params = gami_queue_status_entry_get_params (entry->data);
+        if (! g_hash_table_lookup (params, "Queue"))
+            continue;
+
+        queue = cached_queue_new (copy_headers (params));
+        g_hash_table_insert (cache->priv->queues,
+                             g_strdup (g_hash_table_lookup (params, "Queue")),
+                             queue);
+
+        n_members = gami_queue_status_entry_get_n_members (entry->data);
+        for (i = 0; i < n_members; i++) {
+            GHashTable  *headers;
+            const gchar *location;
+
+            headers = gami_queue_status_entry_get_member (entry->data, i);
+
+            /* QueueStatus lists waiting callers along with the members */
+            if (g_hash_table_lookup (headers, "Position")) {
+                const gchar *wait;
+
+                wait = g_hash_table_lookup (headers, "Wait");
+                add_caller (queue, copy_headers (headers),
+                            now - (wait ? atoi (wait) : 0) * G_USEC_PER_SEC);
+            } else if ((location = member_location (headers)))
+                g_hash_table_insert (queue->members, g_strdup (location),
+                                     copy_headers (headers));
+        }
+    }
+
+    for (entry = list; entry; entry = entry->next) {
+        GHashTable *params;
+
+        params = gami_queue_status_entry_get_params (entry->data);
+        if (g_hash_table_lookup (params, "Queue"))
+            queue_changed (cache, g_hash_table_lookup (params, "Queue"));
+    }
+
+    /* queues which have been removed from the configuration */
+    for (name = names; name; name = name->next) {
+        if (! g_hash_table_lookup (cache->priv->queues, name->data))
+            queue_changed (cache, name->data);
+        g_free (name->data);
+    }
+    g_list_free (names);
+}
+
+static void
+refresh_cb (GamiManager *ami, GAsyncResult *result, gpointer user_data)
+{
+    GSimpleAsyncResult *simple = user_data;
+    GamiQueueCache     *cache;
+    GSList             *list;
+    GError             *error = NULL;
+
+    cache = GAMI_QUEUE_CACHE (g_async_result_get_source_object
+                              (G_ASYNC_RESULT (simple)));
+
+    list = gami_manager_queue_status_finish (ami, result, &error);
+    if (error) {
+        g_simple_async_result_set_from_error (simple, error);
+        g_error_free (error);
+    } else
+        merge_queues (cache, list);
+
+    g_simple_async_result_set_op_res_gboolean (simple, error == NULL);
+    g_simple_async_result_complete (simple);
+
+    g_object_unref (simple);
+    g_object_unref (cache);
+}
+
+static void
+store_result (GObject *source, GAsyncResult *result, gpointer user_data)
+{
+    *(GAsyncResult **) user_data = g_object_ref (result);
+}
+
+static void
+connect_event (GamiQueueCache *cache, const gchar *signal, GCallback func)
+{
+    gulong id;
+
+    id = g_signal_connect (cache->priv->ami, signal, func, cache);
+    cache->priv->handlers = g_slist_prepend (cache->priv->handlers,
+                                             GSIZE_TO_POINTER (id));
+}
+
+/**
+ * gami_queue_cache_new:
+ * @ami: a #GamiManager
+ *
+ * Create a new queue cache for the server @ami is connected to. The cache is
+ * updated from events immediately, but only holds the complete queue state
+ * after gami_queue_cache_refresh() has been called.
+ *
+ * Returns: a new #GamiQueueCache
+ */
+GamiQueueCache *
+gami_queue_cache_new (GamiManager *ami)
+{
+    g_return_val_if_fail (GAMI_IS_MANAGER (ami), NULL);
+
+    return g_object_new (GAMI_TYPE_QUEUE_CACHE, "manager", ami, NULL);
+}
+
+/**
+ * gami_queue_cache_refresh:
+ * @cache: #GamiQueueCache
+ * @error: a #GError, or %NULL
+ *
+ * Replace the state held by @cache with the current state of all queues on
+ * the server.
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_queue_cache_refresh (GamiQueueCache *cache, GError **error)
+{
+    GAsyncResult *result = NULL;
+    gboolean      success;
+
+    gami_queue_cache_refresh_async (cache, store_result, &result);
+
+    while (! result)
+        g_main_context_iteration (NULL, TRUE);
+
+    success = gami_queue_cache_refresh_finish (cache, result, error);
+    g_object_unref (result);
+
+    return success;
+}
+
+/**
+ * gami_queue_cache_refresh_async:
+ * @cache: #GamiQueueCache
+ * @callback: Callback for asynchronious operation.
+ * @user_data: User data to pass to the callback.
+ *
+ * Asynchronously replace the state held by @cache with the current state of
+ * all queues on the server, see gami_queue_cache_refresh().
+ */
+void
+gami_queue_cache_refresh_async (GamiQueueCache *cache,
+                                GAsyncReadyCallback callback,
+                                gpointer user_data)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_if_fail (GAMI_IS_QUEUE_CACHE (cache));
+
+    simple = g_simple_async_result_new (G_OBJECT (cache),
+                                        callback,
+                                        user_data,
+                                        gami_queue_cache_refresh_async);
+
+    gami_manager_queue_status_async (cache->priv->ami,
+                                     NULL,
+                                     NULL,
+                                     (GAsyncReadyCallback) refresh_cb,
+                                     simple);
+}
+
+/**
+ * gami_queue_cache_refresh_finish:
+ * @cache: #GamiQueueCache
+ * @result: #GAsyncResult
+ * @error: a #GError, or %NULL
+ *
+ * Finishes an asynchronous operation started with
+ * gami_queue_cache_refresh_async()
+ *
+ * Returns: %TRUE on success, %FALSE on failure
+ */
+gboolean
+gami_queue_cache_refresh_finish (GamiQueueCache *cache,
+                                 GAsyncResult *result,
+                                 GError **error)
+{
+    GSimpleAsyncResult *simple;
+
+    g_return_val_if_fail (GAMI_IS_QUEUE_CACHE (cache), FALSE);
+    g_return_val_if_fail (G_IS_ASYNC_RESULT (result), FALSE);
+
+    simple = G_SIMPLE_ASYNC_RESULT (result);
+
+    g_warn_if_fail (g_simple_async_result_get_source_tag (simple)
+                    == gami_queue_cache_refresh_async);
+
+    if (g_simple_async_result_propagate_error (simple, error))
+        return FALSE;
+
+    return g_simple_async_result_get_op_res_gboolean (simple);
+}
+
+/**
+ * gami_queue_cache_get_queues:
+ * @cache: #GamiQueueCache
+ *
+ * Get the names of all queues in @cache. The list must be freed with
+ * g_list_free(), the names are owned by @cache.
+ *
+ * Returns: #GList of queue names
+ */
+GList *
+gami_queue_cache_get_queues (GamiQueueCache *cache)
+{
+    g_return_val_if_fail (GAMI_IS_QUEUE_CACHE (cache), NULL);
+
+    return g_hash_table_get_keys (cache->priv->queues);
+}
+
+/**
+ * gami_queue_cache_get_params:
+ * @cache: #GamiQueueCache
+ * @queue: the name of a queue
+ *
+ * Get the parameters of @queue, as sent in the QueueParams event. The
+ * returned table is owned by @cache and must not be modified.
+ *
+ * Returns: #GHashTable of queue parameters, or %NULL if @queue is unknown
+ */
+GHashTable *
+gami_queue_cache_get_params (GamiQueueCache *cache, const gchar *queue)
+{
+    CachedQueue *cached;
+
+    g_return_val_if_fail (GAMI_IS_QUEUE_CACHE (cache), NULL);
+    g_return_val_if_fail (queue != NULL, NULL);
+
+    cached = lookup_queue (cache, queue, FALSE);
+    return cached ? cached->params : NULL;
+}
+
+/**
+ * gami_queue_cache_get_member:
+ * @cache: #GamiQueueCache
+ * @queue: the name of a queue
+ * @location: the location (interface) of a member
+ *
+ * Get the state of the member of @queue at @location. The returned table is
+ * owned by @cache and must not be modified.
+ *
+ * Returns: the member (stored as #GHashTable), or %NULL
+ */
+GHashTable *
+gami_queue_cache_get_member (GamiQueueCache *cache,
+                             const gchar *queue,
+                             const gchar *location)
+{
+    CachedQueue *cached;
+
+    g_return_val_if_fail (GAMI_IS_QUEUE_CACHE (cache), NULL);
+    g_return_val_if_fail (queue != NULL, NULL);
+    g_return_val_if_fail (location != NULL, NULL);
+
+    cached = lookup_queue (cache, queue, FALSE);
+    return cached ? g_hash_table_lookup (cached->members, location) : NULL;
+}
+
+/**
+ * gami_queue_cache_get_members:
+ * @cache: #GamiQueueCache
+ * @queue: the name of a queue
+ *
+ * Get all members of @queue. The list must be freed with g_list_free(), the
+ * members are owned by @cache.
+ *
+ * Returns: #GList of queue members (stored as #GHashTable)
+ */
+GList *
+gami_queue_cache_get_members (GamiQueueCache *cache, const gchar *queue)
+{
+    CachedQueue *cached;
+
+    g_return_val_if_fail (GAMI_IS_QUEUE_CACHE (cache), NULL);
+    g_return_val_if_fail (queue != NULL, NULL);
+
+    cached = lookup_queue (cache, queue, FALSE);
+    return cached ? g_hash_table_get_values (cached->members) : NULL;
+}
+
+/**
+ * gami_queue_cache_get_callers:
+ * @cache: #GamiQueueCache
+ * @queue: the name of a queue
+ *
+ * Get the callers waiting in @queue, ordered by their position. The list must
+ * be freed with g_list_free(), the callers are owned by @cache.
+ *
+ * Returns: #GList of waiting callers (stored as #GHashTable)
+ */
+GList *
+gami_queue_cache_get_callers (GamiQueueCache *cache, const gchar *queue)
+{
+    CachedQueue *cached;
+    GList       *callers = NULL,
+                *link;
+
+    g_return_val_if_fail (GAMI_IS_QUEUE_CACHE (cache), NULL);
+    g_return_val_if_fail (queue != NULL, NULL);
+
+    cached = lookup_queue (cache, queue, FALSE);
+    if (! cached)
+        return NULL;
+
+    for (link = cached->callers->tail; link; link = link->prev)
+        callers = g_list_prepend (callers,
+                                  ((QueueCaller *) link->data)->headers);
+
+    return callers;
+}
+
+/**
+ * gami_queue_cache_get_summary:
+ * @cache: #GamiQueueCache
+ * @queue: the name of a queue
+ *
+ * Compute a summary of @queue with the headers of the QueueSummary event
+ * (Queue, LoggedIn, Available, Callers, HoldTime, TalkTime and
+ * LongestHoldTime) from the cached state, without contacting the server.
+ *
+ * Returns: a new #GHashTable, or %NULL if @queue is unknown
+ */
+GHashTable *
+gami_queue_cache_get_summary (GamiQueueCache *cache, const gchar *queue)
+{
+    CachedQueue    *cached;
+    GHashTable     *summary;
+    GHashTableIter  iter;
+    GHashTable     *member;
+    QueueCaller    *longest;
+    guint           logged_in = 0,
+                    available = 0;
+    gint64          longest_hold = 0;
+    const gchar    *value;
+
+    g_return_val_if_fail (GAMI_IS_QUEUE_CACHE (cache), NULL);
+    g_return_val_if_fail (queue != NULL, NULL);
+
+    cached = lookup_queue (cache, queue, FALSE);
+    if (! cached)
+        return NULL;
+
+    g_hash_table_iter_init (&iter, cached->members);
+    while (g_hash_table_iter_next (&iter, NULL, (gpointer *) &member)) {
+        const gchar *paused;
+        gint         status;
+
+        value  = g_hash_table_lookup (member, "Status");
+        status = value ? atoi (value) : DEVICE_UNKNOWN;
+        paused = g_hash_table_lookup (member, "Paused");
+
+        if (status == DEVICE_INVALID || status == DEVICE_UNAVAILABLE)
+            continue;
+        logged_in++;
+
+        if ((status == DEVICE_NOT_INUSE || status == DEVICE_UNKNOWN)
+            && ! (paused && atoi (paused)))
+            available++;
+    }
+
+    /* callers are ordered by position, the first one waits longest */
+    longest = g_queue_peek_head (cached->callers);
+    if (longest)
+        longest_hold = (current_time () - longest->joined) / G_USEC_PER_SEC;
+
+    summary = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+    g_hash_table_insert (summary, g_strdup ("Queue"), g_strdup (queue));
+    g_hash_table_insert (summary, g_strdup ("LoggedIn"),
+                         g_strdup_printf ("%u", logged_in));
+    g_hash_table_insert (summary, g_strdup ("Available"),
+                         g_strdup_printf ("%u", available));
+    g_hash_table_insert (summary, g_strdup ("Callers"),
+                         g_strdup_printf ("%u", cached->callers->length));
+    value = g_hash_table_lookup (cached->params, "Holdtime");
+    g_hash_table_insert (summary, g_strdup ("HoldTime"),
+                         g_strdup (value ? value : "0"));
+    value = g_hash_table_lookup (cached->params, "TalkTime");
+    g_hash_table_insert (summary, g_strdup ("TalkTime"),
+                         g_strdup (value ? value : "0"));
+    g_hash_table_insert (summary, g_strdup ("LongestHoldTime"),
+                         g_strdup_printf ("%" G_GINT64_FORMAT,
+                                          MAX (longest_hold, 0)));
+
+    return summary;
+}
+
+static void
+gami_queue_cache_init (GamiQueueCache *cache)
+{
+    cache->priv = GAMI_QUEUE_CACHE_GET_PRIVATE (cache);
+
+    cache->priv->queues =
+        g_hash_table_new_full (g_str_hash, g_str_equal,
+                               g_free, (GDestroyNotify) cached_queue_free);
+}
+
+static void
+gami_queue_cache_constructed (GObject *object)
+{
+    GamiQueueCache *cache = GAMI_QUEUE_CACHE (object);
+
+    connect_event (cache, "typed-event::QueueMemberAdded",
+                   G_CALLBACK (on_member_added));
+    connect_event (cache, "typed-event::QueueMemberRemoved",
+                   G_CALLBACK (on_member_removed));
+    connect_event (cache, "typed-event::QueueMemberPaused",
+                   G_CALLBACK (on_member_update));
+    connect_event (cache, "typed-event::QueueMemberStatus",
+                   G_CALLBACK (on_member_update));
+    connect_event (cache, "typed-event::Join", G_CALLBACK (on_join));
+    connect_event (cache, "typed-event::Leave", G_CALLBACK (on_leave));
+    connect_event (cache, "typed-event::QueueCallerAbandon",
+                   G_CALLBACK (on_caller_abandon));
+    connect_event (cache, "disconnected", G_CALLBACK (on_disconnected));
+
+    if (G_OBJECT_CLASS (gami_queue_cache_parent_class)->constructed)
+        G_OBJECT_CLASS (gami_queue_cache_parent_class)->constructed (object);
+}
+
+static void
+gami_queue_cache_dispose (GObject *object)
+{
+    GamiQueueCache *cache = GAMI_QUEUE_CACHE (object);
+    GSList         *handler;
+
+    if (cache->priv->ami) {
+        for (handler = cache->priv->handlers; handler; handler = handler->next)
+            g_signal_handler_disconnect (cache->priv->ami,
+                                         GPOINTER_TO_SIZE (handler->data));
+        g_slist_free (cache->priv->handlers);
+        cache->priv->handlers = NULL;
+
+        g_object_unref (cache->priv->ami);
+        cache->priv->ami = NULL;
+    }
+
+    G_OBJECT_CLASS (gami_queue_cache_parent_class)->dispose (object);
+}
+
+static void
+gami_queue_cache_finalize (GObject *object)
+{
+    GamiQueueCache *cache = GAMI_QUEUE_CACHE (object);
+
+    g_hash_table_unref (cache->priv->queues);
+
+    G_OBJECT_CLASS (gami_queue_cache_parent_class)->finalize (object);
+}
+
+static void
+gami_queue_cache_set_property (GObject *object,
+                               guint prop_id,
+                               const GValue *value,
+                               GParamSpec *pspec)
+{
+    GamiQueueCache *cache = GAMI_QUEUE_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            cache->priv->ami = g_value_dup_object (value);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_queue_cache_get_property (GObject *object,
+                               guint prop_id,
+                               GValue *value,
+                               GParamSpec *pspec)
+{
+    GamiQueueCache *cache = GAMI_QUEUE_CACHE (object);
+
+    switch (prop_id) {
+        case PROP_MANAGER:
+            g_value_set_object (value, cache->priv->ami);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+            break;
+    }
+}
+
+static void
+gami_queue_cache_class_init (GamiQueueCacheClass *klass)
+{
+    GObjectClass *object_class = G_OBJECT_CLASS (klass);
+
+    g_type_class_add_private (klass, sizeof (GamiQueueCachePrivate));
+
+    object_class->set_property = gami_queue_cache_set_property;
+    object_class->get_property = gami_queue_cache_get_property;
+    object_class->constructed  = gami_queue_cache_constructed;
+    object_class->dispose      = gami_queue_cache_dispose;
+    object_class->finalize     = gami_queue_cache_finalize;
+
+    /**
+     * GamiQueueCache:manager:
+     *
+     * The #GamiManager the cache receives events from
+     **/
+    g_object_class_install_property (object_class,
+                                     PROP_MANAGER,
+                                     g_param_spec_object ("manager",
+                                                          "Manager",
+                                                          "The manager the "
+                                                          "cache is attached "
+                                                          "to",
+                                                          GAMI_TYPE_MANAGER,
+                                                          G_PARAM_CONSTRUCT_ONLY
+                                                          | G_PARAM_READWRITE));
+
+    /**
+     * GamiQueueCache::queue-changed:
+     * @cache: The #GamiQueueCache that received the signal
+     * @queue: The name of the queue
+     *
+     * The ::queue-changed signal is emitted when the parameters, members or
+     * waiting callers of a queue changed. The signal detail is the name of
+     * the queue.
+     */
+    signals [QUEUE_CHANGED] = g_signal_new ("queue-changed",
+                                            G_TYPE_FROM_CLASS (object_class),
+                                            G_SIGNAL_RUN_LAST
+                                            | G_SIGNAL_DETAILED,
+                                            0,
+                                            NULL,
+                                            NULL,
+                                            g_cclosure_marshal_VOID__STRING,
+                                            G_TYPE_NONE,
+                                            1, G_TYPE_STRING);
+}
@@ -0,0 +1,160 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+
+#if !defined(__GAMI_H_INSIDE__) && !defined (GAMI_COMPILATION)
+#  error "Only <gami.h> can be included directly."
+#endif
+
+#ifndef __GAMI_QUEUE_CACHE_H__
+#define __GAMI_QUEUE_CACHE_H__
+
+#include <glib.h>
+#include <glib-object.h>
+#include <gio/gio.h>
+
+#ifdef GAMI_COMPILATION
+#  include <gami-manager.h>
+#else
+#  include <gami/gami-manager.h>
+#endif
+
+G_BEGIN_DECLS
+
+/**
+ * GAMI_TYPE_QUEUE_CACHE:
+ *
+ * Get the #GType of #GamiQueueCache
+ *
+ * Returns: The #GType of #GamiQueueCache
+ */
+#define GAMI_TYPE_QUEUE_CACHE  (gami_queue_cache_get_type ())
+/**
+ * GAMI_QUEUE_CACHE:
+ * @object: Object which is subject to casting
+ *
+ * Cast a #GamiQueueCache derived pointer into a (GamiQueueCache *) pointer
+ */
+#define GAMI_QUEUE_CACHE(object) (G_TYPE_CHECK_INSTANCE_CAST ((object), \
+									GAMI_TYPE_QUEUE_CACHE, \
+									GamiQueueCache))
+/**
+ * GAMI_QUEUE_CACHE_CLASS:
+ * @klass: a valid #GamiQueueCacheClass
+ *
+ * Cast a derived #GamiQueueCacheClass structure into a
+ * #GamiQueueCacheClass structure
+ */
+#define GAMI_QUEUE_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_CAST ((klass), \
+									GAMI_TYPE_QUEUE_CACHE, \
+									GamiQueueCacheClass))
+/**
+ * GAMI_IS_QUEUE_CACHE:
+ * @object: Instance to check for being a %GAMI_TYPE_QUEUE_CACHE
+ *
+ * Check whether a valid #GTypeInstance pointer is of type
+ * %GAMI_TYPE_QUEUE_CACHE
+ *
+ * Returns: %FALSE or %TRUE, indicating whether @object is a
+ *          %GAMI_TYPE_QUEUE_CACHE
+ */
+#define GAMI_IS_QUEUE_CACHE(object) (G_TYPE_CHECK_INSTANCE_TYPE ((object), \
+									GAMI_TYPE_QUEUE_CACHE))
+/**
+ * GAMI_IS_QUEUE_CACHE_CLASS:
+ * @klass: a #GamiQueueCacheClass
+ *
+ * Check whether @klass is a #GamiQueueCacheClass
+ *
+ * Returns: %FALSE or %TRUE
+ */
+#define GAMI_IS_QUEUE_CACHE_CLASS(klass) (G_TYPE_CHECK_CLASS_TYPE ((klass), \
+									GAMI_TYPE_QUEUE_CACHE))
+/**
+ * GAMI_QUEUE_CACHE_GET_CLASS:
+ * @object: a #GamiQueueCache instance
+ *
+ * Get the class structure associated to a #GamiQueueCache instance.
+ *
+ * Returns: pointer to object class structure
+ */
+#define GAMI_QUEUE_CACHE_GET_CLASS(object) (G_TYPE_INSTANCE_GET_CLASS ((object), \
+									GAMI_TYPE_QUEUE_CACHE, \
+									GamiQueueCacheClass))
+
+/**
+ * GamiQueueCache:
+ * @parent_instance: #GObject parent instance
+ *
+ * #GamiQueueCache keeps a local copy of the queues, their members and waiting
+ * callers on the server of a #GamiManager.
+ */
+typedef struct _GamiQueueCache GamiQueueCache;
+
+typedef struct _GamiQueueCachePrivate GamiQueueCachePrivate;
+
+/**
+ * GamiQueueCacheClass:
+ * @parent_class: #GamiQueueCache's parent class (of type #GObjectClass)
+ *
+ * The class structure for the #GamiQueueCache type
+ */
+typedef struct _GamiQueueCacheClass GamiQueueCacheClass;
+
+struct _GamiQueueCache
+{
+	GObject parent_instance;
+	GamiQueueCachePrivate *priv;
+};
+
+struct _GamiQueueCacheClass
+{
+	GObjectClass parent_class;
+};
+
+GType gami_queue_cache_get_type (void) G_GNUC_CONST;
+
+GamiQueueCache *gami_queue_cache_new (GamiManager *ami);
+
+gboolean gami_queue_cache_refresh (GamiQueueCache *cache,
+								   GError **error);
+void gami_queue_cache_refresh_async (GamiQueueCache *cache,
+									 GAsyncReadyCallback callback,
+									 gpointer user_data);
+gboolean gami_queue_cache_refresh_finish (GamiQueueCache *cache,
+										  GAsyncResult *result,
+										  GError **error);
+
+GList *gami_queue_cache_get_queues (GamiQueueCache *cache);
+GHashTable *gami_queue_cache_get_params (GamiQueueCache *cache,
+										 const gchar *queue);
+GHashTable *gami_queue_cache_get_member (GamiQueueCache *cache,
+										 const gchar *queue,
+										 const gchar *location);
+GList *gami_queue_cache_get_members (GamiQueueCache *cache,
+									 const gchar *queue);
+GList *gami_queue_cache_get_callers (GamiQueueCache *cache,
+									 const gchar *queue);
+GHashTable *gami_queue_cache_get_summary (GamiQueueCache *cache,
+										  const gchar *queue);
+
+G_END_DECLS
+
+#endif /* __GAMI_QUEUE_CACHE_H__ */
@@ -24,6 +24,29 @@
  * for gobject-introspection.
  */
 
+/**
+ * gami_manager_set_droppable_events:
+ * @events: (allow-none) (array zero-terminated=1):
+ */
+
+/**
+ * gami_manager_coalesce_event:
+ * @key_headers: (allow-none) (array zero-terminated=1):
+ */
+
+/**
+ * gami_manager_invalidate_responses:
+ * @action: (allow-none):
+ */
+
+/**
+ * gami_manager_get_lane_stats:
+ * @delivered: (out) (allow-none):
+ * @pending: (out) (allow-none):
+ * @average_delay: (out) (allow-none):
+ * @max_delay: (out) (allow-none):
+ */
+
 /**
  * gami_manager_login:
  * @auth_type: (allow-none):
@@ -46,6 +69,13 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_list_action_stream_async:
+ * @params: (allow-none) (element-type utf8 utf8):
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_getvar:
  * @channel: (allow-none):
@@ -58,6 +88,42 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_getvar_cached:
+ * @channel: (allow-none):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_getvar_cached_async:
+ * @channel: (allow-none):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_getvar_bulk:
+ * @channels: (array zero-terminated=1):
+ * @variables: (array zero-terminated=1):
+ * @action_id: (allow-none):
+ * @errors: (out) (allow-none) (element-type utf8 GHashTable):
+ *
+ * Returns: (element-type utf8 GHashTable):
+ */
+
+/**
+ * gami_manager_getvar_bulk_async:
+ * @channels: (array zero-terminated=1):
+ * @variables: (array zero-terminated=1):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_getvar_bulk_finish:
+ * @errors: (out) (allow-none) (transfer none) (element-type utf8 GHashTable):
+ *
+ * Returns: (transfer none) (element-type utf8 GHashTable):
+ */
+
 /**
  * gami_manager_setvar:
  * @channel: (allow-none):
@@ -174,6 +240,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_meetme_list_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_queue_add:
  * @action_id: (allow-none):
@@ -230,6 +302,13 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_queue_summary_stream_async:
+ * @queue: (allow-none):
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_queue_log:
  * @action_id: (allow-none):
@@ -274,6 +353,16 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_queues_list:
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_queues_list_async:
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_zap_dial_offhook:
  * @action_id: (allow-none):
@@ -319,6 +408,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_zap_show_channels_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_zap_dnd_off_async:
  * @action_id: (allow-none):
@@ -391,8 +486,15 @@
  */
 
 /**
- * gami_manager_dahdi_show_channels:
+ * gami_manager_dahdi_show_channels_async:
+ * @dahdi_channel: (allow-none):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_dahdi_show_channels_stream_async:
  * @dahdi_channel: (allow-none):
+ * @func: (scope async) (closure func_data):
  * @action_id: (allow-none):
  */
 
@@ -426,6 +528,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_agents_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_agent_callback_login:
  * @context: (allow-none):
@@ -512,6 +620,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_parked_calls_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_voicemail_users_list:
  * @action_id: (allow-none):
@@ -522,6 +636,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_voicemail_users_list_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_mailbox_count:
  * @action_id: (allow-none):
@@ -562,6 +682,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_core_show_channels_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_core_settings:
  * @action_id: (allow-none):
@@ -582,6 +708,18 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_iax_peerlist_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_iax_peers_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_sip_peers:
  * @action_id: (allow-none):
@@ -592,6 +730,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_sip_peers_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_sip_showpeer:
  * @action_id: (allow-none):
@@ -612,6 +756,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_sip_showregistry_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_status:
  * @channel: (allow-none):
@@ -624,6 +774,29 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_status_stream_async:
+ * @channel: (allow-none):
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_status_variables:
+ * @channel: (allow-none):
+ * @variables: (allow-none) (array zero-terminated=1):
+ * @func: (scope call) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_status_variables_async:
+ * @channel: (allow-none):
+ * @variables: (allow-none) (array zero-terminated=1):
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_extension_state:
  * @action_id: (allow-none):
@@ -634,6 +807,14 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_show_dialplan_stream_async:
+ * @extension: (allow-none):
+ * @context: (allow-none):
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_ping:
  * @action_id: (allow-none):
@@ -728,6 +909,12 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_command_stream_async:
+ * @func: (scope async) (closure func_data):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_agi:
  * @command_id: (allow-none):
@@ -810,6 +997,42 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_get_config_tree:
+ * @action_id: (allow-none):
+ *
+ * Returns: (transfer full):
+ */
+
+/**
+ * gami_manager_get_config_tree_async:
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_get_config_tree_finish:
+ *
+ * Returns: (transfer full):
+ */
+
+/**
+ * gami_manager_get_config_json_tree:
+ * @action_id: (allow-none):
+ *
+ * Returns: (transfer full):
+ */
+
+/**
+ * gami_manager_get_config_json_tree_async:
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_get_config_json_tree_finish:
+ *
+ * Returns: (transfer full):
+ */
+
 /**
  * gami_manager_create_config:
  * @action_id: (allow-none):
@@ -820,6 +1043,40 @@
  * @action_id: (allow-none):
  */
 
+/**
+ * gami_manager_update_config:
+ * @dst_filename: (allow-none):
+ * @changes: (element-type GamiConfigChange):
+ * @reload: (allow-none):
+ * @action_id: (allow-none):
+ * @failed_chunk: (out) (allow-none):
+ */
+
+/**
+ * gami_manager_update_config_async:
+ * @dst_filename: (allow-none):
+ * @changes: (element-type GamiConfigChange):
+ * @reload: (allow-none):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_update_config_finish:
+ * @failed_chunk: (out) (allow-none):
+ */
+
+/**
+ * gami_manager_apply_config:
+ * @module: (allow-none):
+ * @action_id: (allow-none):
+ */
+
+/**
+ * gami_manager_apply_config_async:
+ * @module: (allow-none):
+ * @action_id: (allow-none):
+ */
+
 /**
  * gami_manager_originate:
  * @priority: (allow-none):
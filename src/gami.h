@@ -24,9 +24,16 @@
 
 #include <gami/gami-enums.h>
 #include <gami/gami-enumtypes.h>
+#include <gami/gami-event.h>
 #include <gami/gami-main.h>
 #include <gami/gami-manager.h>
 #include <gami/gami-manager-types.h>
+#include <gami/gami-channel-cache.h>
+#include <gami/gami-queue-cache.h>
+#include <gami/gami-peer-cache.h>
+#include <gami/gami-extension-cache.h>
+#include <gami/gami-dialplan.h>
+#include <gami/gami-config.h>
 
 #undef __GAMI_H_INSIDE__
 #endif
@@ -0,0 +1,156 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "fake-server.h"
+
+static pid_t server_pid = 0;
+
+/*
+ * Listen on a free local port and serve a single connection from a child
+ * process: the banner is sent right away, then func is run with the socket.
+ * Returns the port to pass to gami_manager_new()
+ */
+guint
+fake_server_start (FakeServerFunc func, gpointer user_data)
+{
+    struct sockaddr_in addr;
+    socklen_t          len = sizeof (addr);
+    gint               listener, fd, on = 1;
+
+    g_assert (server_pid == 0);
+
+    listener = socket (AF_INET, SOCK_STREAM, 0);
+    g_assert (listener >= 0);
+    setsockopt (listener, SOL_SOCKET, SO_REUSEADDR, &on, sizeof (on));
+
+    memset (&addr, 0, sizeof (addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    addr.sin_port        = 0;
+
+    g_assert (bind (listener, (struct sockaddr *) &addr, sizeof (addr)) == 0);
+    g_assert (listen (listener, 1) == 0);
+    g_assert (getsockname (listener, (struct sockaddr *) &addr, &len) == 0);
+
+    server_pid = fork ();
+    g_assert (server_pid >= 0);
+
+    if (server_pid == 0) {
+        fd = accept (listener, NULL, NULL);
+        if (fd < 0)
+            _exit (1);
+        close (listener);
+
+        fake_server_write (fd, "Asterisk Call Manager/1.1\r\n");
+        func (fd, user_data);
+
+        close (fd);
+        _exit (0);
+    }
+
+    close (listener);
+
+    return ntohs (addr.sin_port);
+}
+
+/* terminate the server if it is still running */
+void
+fake_server_stop (void)
+{
+    if (! server_pid)
+        return;
+
+    kill (server_pid, SIGTERM);
+    waitpid (server_pid, NULL, 0);
+    server_pid = 0;
+}
+
+/* read a packet up to its terminating empty line; returns NULL once the
+ * client closed the connection */
+gchar *
+fake_server_read_packet (gint fd)
+{
+    GString *packet;
+    gchar    c;
+
+    packet = g_string_new (NULL);
+
+    while (! g_str_has_suffix (packet->str, "\r\n\r\n")) {
+        if (read (fd, &c, 1) != 1) {
+            g_string_free (packet, TRUE);
+            return NULL;
+        }
+        g_string_append_c (packet, c);
+    }
+
+    return g_string_free (packet, FALSE);
+}
+
+/* return the value of the header name in packet, or NULL */
+gchar *
+fake_server_header (const gchar *packet, const gchar *name)
+{
+    gchar **lines, **line;
+    gchar  *prefix, *value = NULL;
+
+    prefix = g_strdup_printf ("%s: ", name);
+    lines = g_strsplit (packet, "\r\n", -1);
+
+    for (line = lines; *line && ! value; line++)
+        if (g_str_has_prefix (*line, prefix))
+            value = g_strdup (*line + strlen (prefix));
+
+    g_strfreev (lines);
+    g_free (prefix);
+
+    return value;
+}
+
+void
+fake_server_write (gint fd, const gchar *format, ...)
+{
+    va_list  args;
+    gchar   *text;
+    gsize    len, written = 0;
+
+    va_start (args, format);
+    text = g_strdup_vprintf (format, args);
+    va_end (args);
+
+    len = strlen (text);
+    while (written < len) {
+        gssize n;
+
+        n = write (fd, text + written, len - written);
+        if (n <= 0)
+            break;
+        written += n;
+    }
+
+    g_free (text);
+}
@@ -0,0 +1,40 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef __FAKE_SERVER_H__
+#define __FAKE_SERVER_H__
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+/* a scripted Asterisk manager, run in a child process on a local port */
+typedef void (*FakeServerFunc) (gint fd, gpointer user_data);
+
+guint  fake_server_start       (FakeServerFunc func, gpointer user_data);
+void   fake_server_stop        (void);
+
+gchar *fake_server_read_packet (gint fd);
+gchar *fake_server_header      (const gchar *packet, const gchar *name);
+void   fake_server_write       (gint fd, const gchar *format, ...)
+                                G_GNUC_PRINTF (2, 3);
+
+G_END_DECLS
+
+#endif /* __FAKE_SERVER_H__ */
@@ -0,0 +1,119 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gami-main.h>
+#include <gami-manager.h>
+
+#include "fake-server.h"
+
+#define N_BURST 2000
+
+typedef struct {
+    GMainLoop *loop;
+    guint      received;
+} BurstData;
+
+/* a burst of droppable events, followed by one which must not be dropped */
+static void
+serve_burst (gint fd, gpointer user_data)
+{
+    gchar *packet;
+    guint  i;
+
+    for (i = 0; i < N_BURST; i++)
+        fake_server_write (fd,
+                           "Event: Newexten\r\n"
+                           "Privilege: dialplan,all\r\n"
+                           "Channel: SIP/%u-00000001\r\n"
+                           "Uniqueid: %u.1\r\n"
+                           "Application: NoOp\r\n"
+                           "\r\n",
+                           i, i);
+    fake_server_write (fd, "Event: UserEvent\r\nUserEvent: done\r\n\r\n");
+
+    while ((packet = fake_server_read_packet (fd)))
+        g_free (packet);
+}
+
+static void
+event_cb (GamiManager *ami, GHashTable *event, BurstData *data)
+{
+    const gchar *name;
+
+    name = g_hash_table_lookup (event, "Event");
+    if (! g_strcmp0 (name, "Newexten"))
+        data->received++;
+    else if (! g_strcmp0 (name, "UserEvent"))
+        g_main_loop_quit (data->loop);
+}
+
+static gboolean
+timeout_cb (gpointer user_data)
+{
+    g_error ("Timed out waiting for the events");
+    return FALSE;
+}
+
+static void
+test_drop_events (void)
+{
+    const gchar *droppable [] = { "Newexten", NULL };
+    GamiManager *ami;
+    BurstData    data = { NULL, 0 };
+    guint        port, dropped, timeout;
+
+    port = fake_server_start (serve_burst, NULL);
+    ami = gami_manager_new ("127.0.0.1", port);
+    g_assert (ami != NULL);
+
+    g_object_set (ami,
+                  "high_watermark_packets", 16,
+                  "low_watermark_packets", 4,
+                  NULL);
+    gami_manager_set_droppable_events (ami, droppable);
+    g_signal_connect (ami, "event", G_CALLBACK (event_cb), &data);
+
+    /* let the burst pile up before the manager starts reading */
+    g_usleep (G_USEC_PER_SEC / 5);
+
+    data.loop = g_main_loop_new (NULL, FALSE);
+    timeout = g_timeout_add_seconds (10, timeout_cb, NULL);
+    g_main_loop_run (data.loop);
+    g_source_remove (timeout);
+
+    g_object_get (ami, "dropped_events", &dropped, NULL);
+    g_assert_cmpuint (dropped, >, 0);
+    g_assert_cmpuint (data.received + dropped, ==, N_BURST);
+
+    g_main_loop_unref (data.loop);
+    g_object_unref (ami);
+    fake_server_stop ();
+}
+
+int
+main (int argc, char **argv)
+{
+    gami_init (&argc, &argv);
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/manager/backpressure/drop-events", test_drop_events);
+
+    return g_test_run ();
+}
@@ -0,0 +1,261 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gami-main.h>
+#include <gami-manager.h>
+
+#include "fake-server.h"
+
+#define N_LISTS 50
+#define N_ITEMS 5
+
+typedef struct {
+    GMainLoop *loop;
+    guint      pending;
+    guint      unrelated;
+} ListData;
+
+typedef struct {
+    ListData *data;
+    gchar    *queue;
+} ListRequest;
+
+/* answer N_LISTS QueueSummary actions at once, interleaving their items */
+static void
+serve_concurrent (gint fd, gpointer user_data)
+{
+    gchar *action_ids [N_LISTS], *queues [N_LISTS];
+    gchar *packet;
+    guint  i, item;
+
+    for (i = 0; i < N_LISTS; i++) {
+        packet = fake_server_read_packet (fd);
+        g_assert (packet != NULL);
+
+        action_ids [i] = fake_server_header (packet, "ActionID");
+        queues [i] = fake_server_header (packet, "Queue");
+        g_free (packet);
+
+        fake_server_write (fd,
+                           "Response: Success\r\n"
+                           "ActionID: %s\r\n"
+                           "Message: Queue summary will follow\r\n"
+                           "\r\n",
+                           action_ids [i]);
+    }
+
+    for (item = 0; item < N_ITEMS; item++)
+        for (i = 0; i < N_LISTS; i++)
+            fake_server_write (fd,
+                               "Event: QueueSummary\r\n"
+                               "Queue: %s\r\n"
+                               "Available: %u\r\n"
+                               "ActionID: %s\r\n"
+                               "\r\n",
+                               queues [i], item, action_ids [i]);
+
+    /* complete the lists in reverse order */
+    for (i = N_LISTS; i > 0; i--)
+        fake_server_write (fd,
+                           "Event: QueueSummaryComplete\r\n"
+                           "ActionID: %s\r\n"
+                           "\r\n",
+                           action_ids [i - 1]);
+
+    for (i = 0; i < N_LISTS; i++) {
+        g_free (action_ids [i]);
+        g_free (queues [i]);
+    }
+
+    while ((packet = fake_server_read_packet (fd)))
+        g_free (packet);
+}
+
+/* answer a single QueueSummary like servers which do not send the ActionID
+ * with list events, interleaved with unrelated events of a busy server */
+static void
+serve_anonymous (gint fd, gpointer user_data)
+{
+    gchar *packet, *action_id, *queue;
+    guint  item;
+
+    packet = fake_server_read_packet (fd);
+    g_assert (packet != NULL);
+    action_id = fake_server_header (packet, "ActionID");
+    queue = fake_server_header (packet, "Queue");
+    g_free (packet);
+
+    fake_server_write (fd,
+                       "Response: Success\r\n"
+                       "ActionID: %s\r\n"
+                       "Message: Queue summary will follow\r\n"
+                       "\r\n",
+                       action_id);
+
+    for (item = 0; item < N_ITEMS; item++) {
+        fake_server_write (fd,
+                           "Event: QueueSummary\r\n"
+                           "Queue: %s\r\n"
+                           "Available: %u\r\n"
+                           "\r\n",
+                           queue, item);
+        fake_server_write (fd,
+                           "Event: Newchannel\r\n"
+                           "Channel: SIP/test-%u\r\n"
+                           "Uniqueid: 1234.%u\r\n"
+                           "\r\n",
+                           item, item);
+        fake_server_write (fd,
+                           "Event: VarSet\r\n"
+                           "Channel: SIP/test-%u\r\n"
+                           "Variable: TEST\r\n"
+                           "Value: %u\r\n"
+                           "Uniqueid: 1234.%u\r\n"
+                           "\r\n",
+                           item, item, item);
+    }
+    fake_server_write (fd, "Event: QueueSummaryComplete\r\n\r\n");
+
+    g_free (action_id);
+    g_free (queue);
+
+    while ((packet = fake_server_read_packet (fd)))
+        g_free (packet);
+}
+
+static void
+summary_cb (GamiManager *ami, GAsyncResult *result, ListRequest *request)
+{
+    GSList *items, *item;
+    GError *error = NULL;
+    guint   n = 0;
+
+    items = gami_manager_queue_summary_finish (ami, result, &error);
+    g_assert_no_error (error);
+
+    /* exactly our own items, in order */
+    for (item = items; item; item = item->next, n++) {
+        gchar *available;
+
+        g_assert_cmpstr (g_hash_table_lookup (item->data, "Queue"),
+                         ==,
+                         request->queue);
+
+        available = g_strdup_printf ("%u", n);
+        g_assert_cmpstr (g_hash_table_lookup (item->data, "Available"),
+                         ==,
+                         available);
+        g_free (available);
+    }
+    g_assert_cmpuint (n, ==, N_ITEMS);
+
+    if (! --request->data->pending)
+        g_main_loop_quit (request->data->loop);
+
+    g_free (request->queue);
+    g_free (request);
+}
+
+static void
+event_cb (GamiManager *ami, GHashTable *event, ListData *data)
+{
+    const gchar *name;
+
+    name = g_hash_table_lookup (event, "Event");
+    if (! g_strcmp0 (name, "Newchannel") || ! g_strcmp0 (name, "VarSet"))
+        data->unrelated++;
+}
+
+static gboolean
+timeout_cb (gpointer user_data)
+{
+    g_error ("Timed out waiting for the lists");
+    return FALSE;
+}
+
+/* returns the number of unrelated events emitted while the lists ran */
+static guint
+run_lists (FakeServerFunc serve, guint n_lists)
+{
+    GamiManager *ami;
+    ListData     data;
+    guint        port, timeout, i;
+
+    port = fake_server_start (serve, NULL);
+    ami = gami_manager_new ("127.0.0.1", port);
+    g_assert (ami != NULL);
+
+    data.loop = g_main_loop_new (NULL, FALSE);
+    data.pending = n_lists;
+    data.unrelated = 0;
+    g_signal_connect (ami, "event", G_CALLBACK (event_cb), &data);
+
+    for (i = 0; i < n_lists; i++) {
+        ListRequest *request;
+        gchar       *action_id;
+
+        request = g_new (ListRequest, 1);
+        request->data = &data;
+        request->queue = g_strdup_printf ("queue-%u", i);
+
+        action_id = g_strdup_printf ("list-%u", i);
+        gami_manager_queue_summary_async (ami,
+                                          request->queue,
+                                          action_id,
+                                          (GAsyncReadyCallback) summary_cb,
+                                          request);
+        g_free (action_id);
+    }
+
+    timeout = g_timeout_add_seconds (10, timeout_cb, NULL);
+    g_main_loop_run (data.loop);
+    g_source_remove (timeout);
+
+    g_main_loop_unref (data.loop);
+    g_object_unref (ami);
+    fake_server_stop ();
+
+    return data.unrelated;
+}
+
+static void
+test_concurrent_lists (void)
+{
+    run_lists (serve_concurrent, N_LISTS);
+}
+
+static void
+test_anonymous_items (void)
+{
+    /* unrelated events are neither taken as items nor swallowed */
+    g_assert_cmpuint (run_lists (serve_anonymous, 1), ==, 2 * N_ITEMS);
+}
+
+int
+main (int argc, char **argv)
+{
+    gami_init (&argc, &argv);
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/manager/list/concurrent", test_concurrent_lists);
+    g_test_add_func ("/manager/list/anonymous-items", test_anonymous_items);
+
+    return g_test_run ();
+}
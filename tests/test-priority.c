@@ -0,0 +1,152 @@
+/* vi: se sw=4 ts=4 tw=80 fo+=t cin cino=(0t0 : */
+/*
+ * LIBGAMI - Library for using the Asterisk Manager Interface with GObject
+ * Copyright (C) 2008-2009 Florian Müllner
+ * 
+ * This library is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License
+ * as published by the Free Software Foundation; either version 3 of the
+ * License, or (at your option) any later version.
+ * 
+ * This library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * Lesser General Public License for more details.
+ * 
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this library;  if not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <gami-main.h>
+#include <gami-manager.h>
+
+#include "fake-server.h"
+
+#define N_BACKLOG 500
+
+typedef struct {
+    GMainLoop *loop;
+    guint      backlog;
+    guint      backlog_before_hangup;
+    GString   *channel_events;
+} PriorityData;
+
+/* a backlog of events of other channels, with some events of the channel
+ * which is hung up mixed in */
+static void
+serve_backlog (gint fd, gpointer user_data)
+{
+    gchar *packet;
+    guint  i;
+
+    for (i = 0; i < N_BACKLOG; i++) {
+        fake_server_write (fd,
+                           "Event: Newexten\r\n"
+                           "Privilege: dialplan,all\r\n"
+                           "Channel: SIP/%u-00000002\r\n"
+                           "Uniqueid: 2.%u\r\n"
+                           "Application: NoOp\r\n"
+                           "\r\n",
+                           i, i);
+
+        if (i == N_BACKLOG / 4)
+            fake_server_write (fd,
+                               "Event: VarSet\r\n"
+                               "Channel: SIP/hangup-00000001\r\n"
+                               "Variable: TEST\r\n"
+                               "Value: 1\r\n"
+                               "Uniqueid: 1.1\r\n"
+                               "\r\n");
+        else if (i == N_BACKLOG / 2)
+            fake_server_write (fd,
+                               "Event: Newstate\r\n"
+                               "Channel: SIP/hangup-00000001\r\n"
+                               "ChannelState: 6\r\n"
+                               "Uniqueid: 1.1\r\n"
+                               "\r\n");
+    }
+    fake_server_write (fd,
+                       "Event: Hangup\r\n"
+                       "Channel: SIP/hangup-00000001\r\n"
+                       "Uniqueid: 1.1\r\n"
+                       "Cause: 16\r\n"
+                       "\r\n");
+    fake_server_write (fd, "Event: UserEvent\r\nUserEvent: done\r\n\r\n");
+
+    while ((packet = fake_server_read_packet (fd)))
+        g_free (packet);
+}
+
+static void
+event_cb (GamiManager *ami, GHashTable *event, PriorityData *data)
+{
+    const gchar *name;
+
+    name = g_hash_table_lookup (event, "Event");
+    if (! g_strcmp0 (name, "Newexten"))
+        data->backlog++;
+    else if (! g_strcmp0 (name, "UserEvent"))
+        g_main_loop_quit (data->loop);
+
+    if (g_strcmp0 (g_hash_table_lookup (event, "Uniqueid"), "1.1"))
+        return;
+
+    g_string_append_printf (data->channel_events, "%s;", name);
+    if (! g_strcmp0 (name, "Hangup"))
+        data->backlog_before_hangup = data->backlog;
+}
+
+static gboolean
+timeout_cb (gpointer user_data)
+{
+    g_error ("Timed out waiting for the events");
+    return FALSE;
+}
+
+static void
+test_hangup_overtakes_backlog (void)
+{
+    GamiManager  *ami;
+    PriorityData  data = { NULL, 0, 0, NULL };
+    guint         port, timeout;
+
+    port = fake_server_start (serve_backlog, NULL);
+    ami = gami_manager_new ("127.0.0.1", port);
+    g_assert (ami != NULL);
+
+    gami_manager_set_event_priority (ami, "Hangup", GAMI_EVENT_PRIORITY_HIGH);
+    g_signal_connect (ami, "event", G_CALLBACK (event_cb), &data);
+
+    /* let the backlog pile up before the manager starts reading */
+    g_usleep (G_USEC_PER_SEC / 5);
+
+    data.loop = g_main_loop_new (NULL, FALSE);
+    data.channel_events = g_string_new (NULL);
+    timeout = g_timeout_add_seconds (10, timeout_cb, NULL);
+    g_main_loop_run (data.loop);
+    g_source_remove (timeout);
+
+    /* the earlier events of the channel came along with the hangup, which
+     * did not wait for the whole backlog */
+    g_assert_cmpstr (data.channel_events->str, ==, "VarSet;Newstate;Hangup;");
+    g_assert_cmpuint (data.backlog, ==, N_BACKLOG);
+    g_assert_cmpuint (data.backlog_before_hangup, <, N_BACKLOG);
+
+    g_string_free (data.channel_events, TRUE);
+    g_main_loop_unref (data.loop);
+    g_object_unref (ami);
+    fake_server_stop ();
+}
+
+int
+main (int argc, char **argv)
+{
+    gami_init (&argc, &argv);
+    g_test_init (&argc, &argv, NULL);
+
+    g_test_add_func ("/manager/priority/hangup-overtakes-backlog",
+                     test_hangup_overtakes_backlog);
+
+    return g_test_run ();
+}